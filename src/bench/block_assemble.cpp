@@ -10,6 +10,7 @@
 #include <test/util/wallet.h>
 #include <txmempool.h>
 #include <validation.h>
+#include <mw/node/BlockBuilder.h>
 
 
 #include <vector>
@@ -60,3 +61,64 @@ static void AssembleBlock(benchmark::Bench& bench)
 }
 
 BENCHMARK(AssembleBlock);
+
+// Creates a peg-in MWEB transaction with a single output.
+// The block builder trusts the mempool's validation, so the output's rangeproof and signature are left empty.
+static mw::Transaction::CPtr CreatePegInTx(const CAmount amount)
+{
+    Kernel kernel = Kernel::Create(BlindingFactor::Random(), boost::none, boost::none, amount, {}, boost::none);
+    Output output(
+        Commitment::Random(),
+        PublicKey::Random(),
+        PublicKey::Random(),
+        OutputMessage(OutputMessage::STANDARD_FIELDS_FEATURE_BIT, PublicKey::Random(), 0, 0, BigInt<16>()),
+        std::make_shared<const RangeProof>(),
+        Signature()
+    );
+
+    return mw::Transaction::Create(BlindingFactor::Random(), BlindingFactor::Random(), {}, {output}, {kernel});
+}
+
+// Builds an MWEB block out of num_txs peg-in transactions.
+// A full block holds a little over 1000 of them before reaching mw::MAX_BLOCK_WEIGHT.
+static void AssembleMWEBBlock(benchmark::Bench& bench, const size_t num_txs)
+{
+    TestingSetup test_setup{
+        CBaseChainParams::REGTEST,
+        /* extra_args */ {
+            "-nodebuglogfile",
+            "-nodebug",
+        },
+    };
+
+    std::vector<mw::Transaction::CPtr> txs;
+    for (size_t i = 0; i < num_txs; i++) {
+        txs.push_back(CreatePegInTx(1000 + i));
+    }
+
+    mw::ICoinsView::Ptr view = WITH_LOCK(::cs_main, return ::ChainstateActive().CoinsTip().GetMWEBView());
+
+    bench.batch(num_txs).unit("tx").run([&] {
+        mw::BlockBuilder builder(1, view);
+        for (const mw::Transaction::CPtr& pTx : txs) {
+            bool added = builder.AddTransaction(pTx, pTx->GetPegIns());
+            assert(added);
+        }
+
+        mw::Block::Ptr pBlock = builder.BuildBlock();
+        assert(pBlock->GetKernels().size() == num_txs);
+    });
+}
+
+static void AssembleMWEBBlock100(benchmark::Bench& bench)
+{
+    AssembleMWEBBlock(bench, 100);
+}
+
+static void AssembleMWEBBlock1000(benchmark::Bench& bench)
+{
+    AssembleMWEBBlock(bench, 1000);
+}
+
+BENCHMARK(AssembleMWEBBlock100);
+BENCHMARK(AssembleMWEBBlock1000);
@@ -6,8 +6,10 @@
 #include <coins.h>
 #include <policy/policy.h>
 #include <script/signingprovider.h>
+#include <random.h>
 #include <test/util/transaction_utils.h>
 
+#include <unordered_map>
 #include <vector>
 
 // Microbenchmark for simple accesses to a CCoinsViewCache database. Note from
@@ -51,4 +53,63 @@ static void CCoinsCaching(benchmark::Bench& bench)
     ECC_Stop();
 }
 
+// Fills a coins map the way the cache does during IBD, then frees it again.
+template <typename Map>
+static void FillAndClearCoinsMap(benchmark::Bench& bench, Map& map)
+{
+    FastRandomContext rng(true);
+    std::vector<COutPoint> outpoints;
+    for (uint32_t i = 0; i < 10000; ++i) {
+        outpoints.emplace_back(rng.rand256(), i);
+    }
+
+    bench.run([&] {
+        for (const COutPoint& outpoint : outpoints) {
+            CCoinsCacheEntry& entry = map[outpoint];
+            entry.coin.nHeight = 1;
+            entry.coin.out.nValue = 1;
+        }
+        map.clear();
+    });
+}
+
+static void CCoinsMapStdAllocator(benchmark::Bench& bench)
+{
+    std::unordered_map<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher> map;
+    FillAndClearCoinsMap(bench, map);
+}
+
+static void CCoinsMapPoolAllocator(benchmark::Bench& bench)
+{
+    CCoinsMapMemoryResource resource;
+    CCoinsMap map{0, CCoinsMap::hasher{}, CCoinsMap::key_equal{}, &resource};
+    FillAndClearCoinsMap(bench, map);
+}
+
+// Adds coins to a fresh cache and flushes it, which also releases the cache's memory.
+static void CCoinsCachingFlush(benchmark::Bench& bench)
+{
+    FastRandomContext rng(true);
+    std::vector<COutPoint> outpoints;
+    for (uint32_t i = 0; i < 10000; ++i) {
+        outpoints.emplace_back(rng.rand256(), i);
+    }
+
+    CCoinsView coinsDummy;
+    CCoinsViewCache coins(&coinsDummy);
+    bench.run([&] {
+        for (const COutPoint& outpoint : outpoints) {
+            Coin coin;
+            coin.nHeight = 1;
+            coin.out.nValue = 1;
+            coin.out.scriptPubKey << OP_TRUE;
+            coins.AddCoin(outpoint, std::move(coin), false);
+        }
+        coins.Flush();
+    });
+}
+
 BENCHMARK(CCoinsCaching);
+BENCHMARK(CCoinsMapStdAllocator);
+BENCHMARK(CCoinsMapPoolAllocator);
+BENCHMARK(CCoinsCachingFlush);
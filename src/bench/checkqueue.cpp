@@ -22,11 +22,10 @@ static const unsigned int QUEUE_BATCH_SIZE = 128;
 // This Benchmark tests the CheckQueue with a slightly realistic workload,
 // where checks all contain a prevector that is indirect 50% of the time
 // and there is a little bit of work done between calls to Add.
-static void CCheckQueueSpeedPrevectorJob(benchmark::Bench& bench)
+// The main thread should be counted in num_threads to prevent thread
+// oversubscription, and to decrease the variance of benchmark results.
+static void RunPrevectorJobs(benchmark::Bench& bench, int num_threads)
 {
-    // We shouldn't ever be running with the checkqueue on a single core machine.
-    if (GetNumCores() <= 1) return;
-
     const ECCVerifyHandle verify_handle;
     ECC_Start();
 
@@ -43,11 +42,9 @@ static void CCheckQueueSpeedPrevectorJob(benchmark::Bench& bench)
         }
         void swap(PrevectorJob& x){p.swap(x.p);};
     };
-    CCheckQueue<PrevectorJob> queue {QUEUE_BATCH_SIZE};
+    CCheckQueue<PrevectorJob> queue {QUEUE_BATCH_SIZE, (unsigned int)num_threads};
     boost::thread_group tg;
-    // The main thread should be counted to prevent thread oversubscription, and
-    // to decrease the variance of benchmark results.
-    for (auto x = 0; x < GetNumCores() - 1; ++x) {
+    for (auto x = 0; x < num_threads - 1; ++x) {
        tg.create_thread([&]{queue.Thread();});
     }
 
@@ -74,4 +71,34 @@ static void CCheckQueueSpeedPrevectorJob(benchmark::Bench& bench)
     tg.join_all();
     ECC_Stop();
 }
+
+static void CCheckQueueSpeedPrevectorJob(benchmark::Bench& bench)
+{
+    // We shouldn't ever be running with the checkqueue on a single core machine.
+    if (GetNumCores() <= 1) return;
+
+    RunPrevectorJobs(bench, GetNumCores());
+}
+
+// Scaling of the queue itself with many workers. The jobs are cheap, so these
+// mostly measure how well the workers share out the checks, even on machines
+// with fewer cores than threads.
+static void CCheckQueueSpeedPrevectorJob8Threads(benchmark::Bench& bench)
+{
+    RunPrevectorJobs(bench, 8);
+}
+
+static void CCheckQueueSpeedPrevectorJob32Threads(benchmark::Bench& bench)
+{
+    RunPrevectorJobs(bench, 32);
+}
+
+static void CCheckQueueSpeedPrevectorJob64Threads(benchmark::Bench& bench)
+{
+    RunPrevectorJobs(bench, 64);
+}
+
 BENCHMARK(CCheckQueueSpeedPrevectorJob);
+BENCHMARK(CCheckQueueSpeedPrevectorJob8Threads);
+BENCHMARK(CCheckQueueSpeedPrevectorJob32Threads);
+BENCHMARK(CCheckQueueSpeedPrevectorJob64Threads);
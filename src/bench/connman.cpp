@@ -0,0 +1,97 @@
+// Copyright (c) 2022 The Litecoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <net.h>
+#include <netbase.h>
+#include <netmessagemaker.h>
+#include <test/util/net.h>
+#include <test/util/setup_common.h>
+
+#include <vector>
+
+// Many connected peers, of which only a few send anything at a time, which is
+// what a public node with hundreds of inbound connections mostly sees.
+static const size_t NUM_PEERS = 250;
+static const size_t NUM_ACTIVE_PEERS = 10;
+
+static void ConnmanSocketHandler(benchmark::Bench& bench, SocketEventsMode mode)
+{
+    const BasicTestingSetup test_setup{
+        CBaseChainParams::REGTEST,
+        /* extra_args */ {
+            "-nodebuglogfile",
+            "-nodebug",
+        },
+    };
+
+    ConnmanTestMsg connman{0x1337, 0x1337};
+    connman.InitSocketEvents(mode);
+
+    std::vector<SOCKET> clients;
+    std::vector<CNode*> nodes;
+    for (size_t i = 0; i < NUM_PEERS; i++) {
+        SOCKET client, server;
+        if (!CreateLoopbackSocketPair(client, server)) break;
+        CNode* node = new CNode(i, NODE_NETWORK, 0, server, CAddress(), 0, 0, CAddress(), "", ConnectionType::INBOUND);
+        connman.AddTestNode(*node);
+        clients.push_back(client);
+        nodes.push_back(node);
+    }
+    assert(nodes.size() == NUM_PEERS);
+
+    CSerializedNetMsg msg = CNetMsgMaker(INIT_PROTO_VERSION).Make(NetMsgType::PING, uint64_t{0});
+    std::vector<unsigned char> wire;
+    V1TransportSerializer().prepareForTransport(msg, wire);
+    wire.insert(wire.end(), msg.data.begin(), msg.data.end());
+
+    size_t next_peer = 0;
+    bench.batch(NUM_ACTIVE_PEERS).unit("message").run([&] {
+        const uint64_t target = connman.GetTotalBytesRecv() + NUM_ACTIVE_PEERS * wire.size();
+        std::vector<CNode*> active;
+        for (size_t i = 0; i < NUM_ACTIVE_PEERS; i++) {
+            const size_t peer = next_peer++ % NUM_PEERS;
+            send(clients[peer], (const char*)wire.data(), wire.size(), 0);
+            active.push_back(nodes[peer]);
+        }
+
+        while (connman.GetTotalBytesRecv() < target) {
+            connman.SocketHandlerOnce();
+        }
+
+        // Stand in for the message handler.
+        for (CNode* node : active) {
+            LOCK(node->cs_vProcessMsg);
+            node->vProcessMsg.clear();
+            node->nProcessQueueSize = 0;
+            node->fPauseRecv = false;
+        }
+    });
+
+    for (SOCKET& client : clients) {
+        CloseSocket(client);
+    }
+    connman.ClearTestNodes();
+}
+
+static void ConnmanSocketHandlerPoll(benchmark::Bench& bench)
+{
+#ifdef USE_POLL
+    ConnmanSocketHandler(bench, SocketEventsMode::POLL);
+#else
+    ConnmanSocketHandler(bench, SocketEventsMode::SELECT);
+#endif
+}
+
+#ifdef USE_EPOLL
+static void ConnmanSocketHandlerEpoll(benchmark::Bench& bench)
+{
+    ConnmanSocketHandler(bench, SocketEventsMode::EPOLL);
+}
+#endif
+
+BENCHMARK(ConnmanSocketHandlerPoll);
+#ifdef USE_EPOLL
+BENCHMARK(ConnmanSocketHandlerEpoll);
+#endif
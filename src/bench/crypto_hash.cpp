@@ -5,12 +5,14 @@
 
 #include <bench/bench.h>
 #include <crypto/ripemd160.h>
+#include <crypto/scrypt.h>
 #include <crypto/sha1.h>
 #include <crypto/sha256.h>
 #include <crypto/sha3.h>
 #include <crypto/sha512.h>
 #include <crypto/siphash.h>
 #include <hash.h>
+#include <mw/crypto/Hasher.h>
 #include <random.h>
 #include <uint256.h>
 
@@ -63,6 +65,24 @@ static void SHA256_32b(benchmark::Bench& bench)
     });
 }
 
+static void BLAKE3(benchmark::Bench& bench)
+{
+    std::vector<uint8_t> in(BUFFER_SIZE,0);
+    bench.batch(in.size()).unit("byte").run([&] {
+        Hasher().write((const char*)in.data(), in.size());
+    });
+}
+
+static void BLAKE3_32b(benchmark::Bench& bench)
+{
+    std::vector<uint8_t> in(32,0);
+    bench.batch(in.size()).unit("byte").run([&] {
+        Hasher hasher;
+        hasher.write((const char*)in.data(), in.size());
+        memcpy(in.data(), hasher.hash().data(), in.size());
+    });
+}
+
 static void SHA256D64_1024(benchmark::Bench& bench)
 {
     std::vector<uint8_t> in(64 * 1024, 0);
@@ -71,6 +91,26 @@ static void SHA256D64_1024(benchmark::Bench& bench)
     });
 }
 
+static void Scrypt_80b(benchmark::Bench& bench)
+{
+    std::vector<char> in(80, 0);
+    uint256 hash;
+    bench.batch(1).unit("hash").run([&] {
+        scrypt_1024_1_1_256(in.data(), (char*)hash.begin());
+        in[0]++;
+    });
+}
+
+static void Scrypt_80b_batch(benchmark::Bench& bench)
+{
+    std::vector<char> in(80 * 64, 0);
+    std::vector<char> out(32 * 64);
+    bench.batch(64).unit("hash").run([&] {
+        scrypt_1024_1_1_256_batch(in.data(), out.data(), 64);
+        in[0]++;
+    });
+}
+
 static void SHA512(benchmark::Bench& bench)
 {
     uint8_t hash[CSHA512::OUTPUT_SIZE];
@@ -110,9 +150,13 @@ BENCHMARK(SHA1);
 BENCHMARK(SHA256);
 BENCHMARK(SHA512);
 BENCHMARK(SHA3_256_1M);
+BENCHMARK(BLAKE3);
 
 BENCHMARK(SHA256_32b);
+BENCHMARK(BLAKE3_32b);
 BENCHMARK(SipHash_32b);
 BENCHMARK(SHA256D64_1024);
+BENCHMARK(Scrypt_80b);
+BENCHMARK(Scrypt_80b_batch);
 BENCHMARK(FastRandom_32bit);
 BENCHMARK(FastRandom_1bit);
@@ -4,6 +4,8 @@
 
 #include <bench/bench.h>
 #include <blockfilter.h>
+#include <random.h>
+#include <script/standard.h>
 
 static void ConstructGCSFilter(benchmark::Bench& bench)
 {
@@ -39,5 +41,37 @@ static void MatchGCSFilter(benchmark::Bench& bench)
     });
 }
 
+// Builds the MWEB filter of a block with 1000 MWEB inputs, outputs and peg-out kernels.
+// The filter only reads IDs and scripts, so none of the signatures or proofs need to be valid.
+static void ConstructMWEBBlockFilter(benchmark::Bench& bench)
+{
+    std::vector<Input> inputs;
+    std::vector<Output> outputs;
+    std::vector<Kernel> kernels;
+    for (int i = 0; i < 1000; ++i) {
+        inputs.emplace_back(mw::Hash(GetRandHash().begin()), Commitment::Random(), PublicKey::Random(), PublicKey::Random(), Signature());
+        outputs.emplace_back(
+            Commitment::Random(),
+            PublicKey::Random(),
+            PublicKey::Random(),
+            OutputMessage(OutputMessage::STANDARD_FIELDS_FEATURE_BIT, PublicKey::Random(), 0, 0, BigInt<16>()),
+            std::make_shared<const RangeProof>(),
+            Signature()
+        );
+
+        std::vector<PegOutCoin> pegouts{PegOutCoin(1000 + i, GetScriptForDestination(WitnessV0ScriptHash(GetRandHash())))};
+        kernels.emplace_back(Kernel::PEGOUT_FEATURE_BIT, boost::none, boost::none, std::move(pegouts), boost::none, boost::none, std::vector<uint8_t>{}, Commitment::Random(), Signature());
+    }
+
+    CBlock block;
+    block.mweb_block = MWEB::Block(std::make_shared<mw::Block>(std::make_shared<mw::Header>(), TxBody(inputs, outputs, kernels)));
+    CBlockUndo block_undo;
+
+    bench.unit("block").run([&] {
+        BlockFilter filter(BlockFilterType::MWEB, block, block_undo);
+    });
+}
+
 BENCHMARK(ConstructGCSFilter);
 BENCHMARK(MatchGCSFilter);
+BENCHMARK(ConstructMWEBBlockFilter);
@@ -0,0 +1,73 @@
+// Copyright (c) 2022 The Litecoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <mw/crypto/Bulletproofs.h>
+#include <mw/crypto/CryptoCheckQueue.h>
+#include <mw/crypto/Pedersen.h>
+#include <util/system.h>
+
+#include <boost/thread/thread.hpp>
+
+// Generating a rangeproof is much slower than verifying one, so only this many
+// distinct proofs are generated. Larger batches repeat them.
+static constexpr size_t NUM_DISTINCT_PROOFS = 100;
+
+// Verifies num_proofs rangeproofs, split across one CryptoCheckQueue worker per additional core.
+static void BulletproofsBatchVerify(benchmark::Bench& bench, const size_t num_proofs)
+{
+    std::vector<ProofData> distinct_proofs;
+    for (size_t i = 0; i < std::min(num_proofs, NUM_DISTINCT_PROOFS); i++) {
+        const uint64_t value = 1000 + i;
+        BlindingFactor blind = BlindingFactor::Random();
+        std::vector<uint8_t> extra_data = SecretKey::Random().vec();
+
+        RangeProof::CPtr pRangeProof = Bulletproofs::Generate(
+            value,
+            SecretKey(blind.vec()),
+            SecretKey::Random(),
+            SecretKey::Random(),
+            ProofMessage{},
+            extra_data
+        );
+        distinct_proofs.push_back(ProofData{ Pedersen::Commit(value, blind), pRangeProof, extra_data });
+    }
+
+    std::vector<ProofData> proofs;
+    for (size_t i = 0; i < num_proofs; i++) {
+        proofs.push_back(distinct_proofs[i % distinct_proofs.size()]);
+    }
+
+    boost::thread_group workers;
+    for (int i = 0; i < GetNumCores() - 1; i++) {
+        workers.create_thread([i]() { return CryptoCheckQueue::Thread(i); });
+    }
+
+    bench.batch(num_proofs).unit("proof").run([&] {
+        bool valid = Bulletproofs::BatchVerifyUncached(proofs);
+        assert(valid);
+    });
+
+    workers.interrupt_all();
+    workers.join_all();
+}
+
+static void MWEBBulletproofsVerify1(benchmark::Bench& bench)
+{
+    BulletproofsBatchVerify(bench, 1);
+}
+
+static void MWEBBulletproofsVerify100(benchmark::Bench& bench)
+{
+    BulletproofsBatchVerify(bench, 100);
+}
+
+static void MWEBBulletproofsVerify1000(benchmark::Bench& bench)
+{
+    BulletproofsBatchVerify(bench, 1000);
+}
+
+BENCHMARK(MWEBBulletproofsVerify1);
+BENCHMARK(MWEBBulletproofsVerify100);
+BENCHMARK(MWEBBulletproofsVerify1000);
@@ -0,0 +1,53 @@
+// Copyright (c) 2022 The Litecoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <mw/mmr/LeafSet.h>
+#include <random.h>
+#include <test/util/setup_common.h>
+#include <util/system.h>
+
+// Simulates connecting a block with 500 new outputs and 500 spent inputs
+// on top of a leafset holding num_leaves leaves, and calculates the new root.
+static void LeafSetRoot(benchmark::Bench& bench, const uint64_t num_leaves)
+{
+    BasicTestingSetup test_setup{
+        CBaseChainParams::REGTEST,
+        /* extra_args */ {
+            "-nodebuglogfile",
+            "-nodebug",
+        },
+    };
+
+    LeafSet::Ptr pLeafSet = LeafSet::Open(GetDataDir(), 0);
+    for (uint64_t i = 0; i < num_leaves; i++) {
+        pLeafSet->Add(mmr::LeafIndex::At(i));
+    }
+    pLeafSet->Flush(1);
+    pLeafSet->Root();
+
+    FastRandomContext rng(true);
+    bench.run([&] {
+        LeafSetCache cache(pLeafSet);
+        for (uint64_t i = 0; i < 500; i++) {
+            cache.Add(mmr::LeafIndex::At(num_leaves + i));
+            cache.Remove(mmr::LeafIndex::At(rng.randrange(num_leaves)));
+        }
+
+        (void)cache.Root();
+    });
+}
+
+static void MWEBLeafSetRoot1M(benchmark::Bench& bench)
+{
+    LeafSetRoot(bench, 1000000);
+}
+
+static void MWEBLeafSetRoot16M(benchmark::Bench& bench)
+{
+    LeafSetRoot(bench, 16000000);
+}
+
+BENCHMARK(MWEBLeafSetRoot1M);
+BENCHMARK(MWEBLeafSetRoot16M);
@@ -0,0 +1,69 @@
+// Copyright (c) 2022 The Litecoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <mw/file/File.h>
+#include <mw/mmr/MMR.h>
+#include <mw/mmr/PruneList.h>
+#include <random.h>
+#include <test/util/setup_common.h>
+#include <util/system.h>
+
+// Builds a PMMR whose first 2^log2_compacted_leaves leaves have been compacted
+// down to the root of their subtree, then simulates connecting a block with
+// 1000 new outputs and calculates the new root. Every parent and peak hash
+// read through the PMMR looks up its shift in the prune list.
+static void PMMRCompactedRoot(benchmark::Bench& bench, const uint64_t log2_compacted_leaves)
+{
+    BasicTestingSetup test_setup{
+        CBaseChainParams::REGTEST,
+        /* extra_args */ {
+            "-nodebuglogfile",
+            "-nodebug",
+        },
+    };
+
+    // The subtree holding the compacted leaves has 2^(n+1) - 1 nodes, all of them compacted except its root.
+    const uint64_t num_compacted_leaves = uint64_t(1) << log2_compacted_leaves;
+    const uint64_t subtree_root_pos = mmr::LeafIndex::At(num_compacted_leaves).GetPosition() - 1;
+
+    BitSet compacted(subtree_root_pos);
+    compacted.set(0, subtree_root_pos, true);
+
+    PruneList::Ptr pPruneList = PruneList::Open(GetDataDir(), 0);
+    pPruneList->Commit(1, compacted);
+    pPruneList = PruneList::Open(GetDataDir(), 1);
+
+    File(PMMR::GetPath(GetDataDir(), 'O', 1)).Write(std::vector<uint8_t>(mw::Hash::size(), 0));
+    PMMR::Ptr pPMMR = PMMR::Open('O', GetDataDir(), 1, nullptr, pPruneList);
+    assert(pPMMR->GetNumLeaves() == num_compacted_leaves);
+
+    FastRandomContext rng(true);
+    std::vector<mmr::Leaf> leaves;
+    for (uint64_t i = 0; i < 1000; i++) {
+        leaves.push_back(mmr::Leaf::Create(mmr::LeafIndex::At(num_compacted_leaves + i), rng.randbytes(32)));
+    }
+
+    bench.run([&] {
+        pPMMR->Rewind(num_compacted_leaves);
+        for (const mmr::Leaf& leaf : leaves) {
+            pPMMR->AddLeaf(leaf);
+        }
+
+        (void)pPMMR->Root();
+    });
+}
+
+static void MWEBPMMRCompactedRoot1M(benchmark::Bench& bench)
+{
+    PMMRCompactedRoot(bench, 20);
+}
+
+static void MWEBPMMRCompactedRoot16M(benchmark::Bench& bench)
+{
+    PMMRCompactedRoot(bench, 24);
+}
+
+BENCHMARK(MWEBPMMRCompactedRoot1M);
+BENCHMARK(MWEBPMMRCompactedRoot16M);
@@ -13,6 +13,9 @@
 #include <txmempool.h>
 #include <validation.h>
 #include <util/system.h>
+#include <mw/consensus/Aggregation.h>
+#include <mw/consensus/Weight.h>
+#include <mw/crypto/Hasher.h>
 
 #include <unordered_map>
 
@@ -34,6 +37,19 @@ CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(const CBlock& block, bool f
             shorttxids.push_back(GetShortID(fUseWTXID ? tx.GetWitnessHash() : tx.GetHash()));
         }
     }
+
+    // MWEB: Short kernel IDs, for peers that negotiated compact block version 4.
+    // Peers using version 3 still get the full extension block.
+    if (!mweb_block.IsNull()) {
+        mweb_header = mweb_block.GetMWEBHeader();
+        mweb_body_hash = Hashed(mweb_block.m_block->GetTxBody());
+
+        const std::vector<Kernel>& kernels = mweb_block.m_block->GetKernels();
+        shortkernelids.reserve(kernels.size());
+        for (const Kernel& kernel : kernels) {
+            shortkernelids.push_back(GetShortKernelID(kernel.GetKernelID()));
+        }
+    }
 }
 
 void CBlockHeaderAndShortTxIDs::FillShortTxIDSelector() const {
@@ -52,6 +68,10 @@ uint64_t CBlockHeaderAndShortTxIDs::GetShortID(const uint256& txhash) const {
     return SipHashUint256(shorttxidk0, shorttxidk1, txhash) & 0xffffffffffffL;
 }
 
+uint64_t CBlockHeaderAndShortTxIDs::GetShortKernelID(const mw::Hash& kernel_id) const {
+    return GetShortID(uint256(kernel_id.vec()));
+}
+
 
 
 ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& cmpctblock, const std::vector<std::pair<uint256, CTransactionRef>>& extra_txn) {
@@ -60,6 +80,9 @@ ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& c
     if (cmpctblock.shorttxids.size() + cmpctblock.prefilledtxn.size() > MAX_BLOCK_WEIGHT / MIN_SERIALIZABLE_TRANSACTION_WEIGHT)
         return READ_STATUS_INVALID;
 
+    if (cmpctblock.shortkernelids.size() > mw::MAX_BLOCK_WEIGHT / Weight::BASE_KERNEL_WEIGHT)
+        return READ_STATUS_INVALID;
+
     assert(header.IsNull() && txn_available.empty());
     header = cmpctblock.header;
     mweb_block = cmpctblock.mweb_block;
@@ -171,6 +194,69 @@ ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& c
             break;
     }
 
+    // MWEB: When the extension block was sent as short kernel IDs, look for the transactions
+    // containing its kernels in the mempool, the extra txn, and the txs recently removed from the mempool.
+    if (cmpctblock.mweb_block.IsNull() && cmpctblock.mweb_header != nullptr) {
+        mweb_header = cmpctblock.mweb_header;
+        mweb_body_hash = cmpctblock.mweb_body_hash;
+        kernel_txn_available.resize(cmpctblock.shortkernelids.size());
+
+        std::unordered_map<uint64_t, uint16_t> shortkernelids(cmpctblock.shortkernelids.size());
+        for (size_t i = 0; i < cmpctblock.shortkernelids.size(); i++) {
+            shortkernelids[cmpctblock.shortkernelids[i]] = i;
+        }
+        if (shortkernelids.size() != cmpctblock.shortkernelids.size())
+            return READ_STATUS_FAILED; // Short ID collision
+
+        std::vector<bool> have_kernel(kernel_txn_available.size());
+        const auto add_tx = [&](const CTransactionRef& tx) {
+            if (!tx->HasMWEBTx()) {
+                return;
+            }
+
+            // Only use the tx if every one of its kernels is in the block, since its
+            // inputs and outputs would otherwise be missing from (or extra to) the TxBody.
+            std::vector<uint16_t> indexes;
+            for (const Kernel& kernel : tx->mweb_tx.m_transaction->GetKernels()) {
+                auto idit = shortkernelids.find(cmpctblock.GetShortKernelID(kernel.GetKernelID()));
+                if (idit == shortkernelids.end()) {
+                    return;
+                }
+                indexes.push_back(idit->second);
+            }
+
+            for (const uint16_t index : indexes) {
+                if (!have_kernel[index]) {
+                    kernel_txn_available[index] = tx;
+                    have_kernel[index] = true;
+                    kernel_mempool_count++;
+                } else if (kernel_txn_available[index] &&
+                        kernel_txn_available[index]->mweb_tx.m_transaction->GetHash() != tx->mweb_tx.m_transaction->GetHash()) {
+                    // Two different txs match the short ID, so just request it.
+                    kernel_txn_available[index].reset();
+                    kernel_mempool_count--;
+                }
+            }
+        };
+
+        {
+        LOCK(pool->cs);
+        for (size_t i = 0; i < pool->vTxHashes.size() && kernel_mempool_count < shortkernelids.size(); i++) {
+            add_tx(pool->vTxHashes[i].second->GetSharedTx());
+        }
+        }
+
+        pool->recentTxsByKernel.ForEach([&](const CTransactionRef& tx) {
+            if (kernel_mempool_count >= shortkernelids.size()) return false;
+            add_tx(tx);
+            return true;
+        });
+
+        for (size_t i = 0; i < extra_txn.size() && kernel_mempool_count < shortkernelids.size(); i++) {
+            add_tx(extra_txn[i].second);
+        }
+    }
+
     LogPrint(BCLog::CMPCTBLOCK, "Initialized PartiallyDownloadedBlock for block %s using a cmpctblock of size %lu\n", cmpctblock.header.GetHash().ToString(), GetSerializeSize(cmpctblock, PROTOCOL_VERSION));
 
     return READ_STATUS_OK;
@@ -182,13 +268,78 @@ bool PartiallyDownloadedBlock::IsTxAvailable(size_t index) const {
     return txn_available[index] != nullptr;
 }
 
-ReadStatus PartiallyDownloadedBlock::FillBlock(CBlock& block, const std::vector<CTransactionRef>& vtx_missing) {
+bool PartiallyDownloadedBlock::IsKernelAvailable(size_t index) const {
+    assert(!header.IsNull());
+    assert(index < kernel_txn_available.size());
+    return kernel_txn_available[index] != nullptr;
+}
+
+ReadStatus PartiallyDownloadedBlock::FillMWEBBlock(MWEB::Block& block, const std::vector<MWEB::Tx>& mweb_txn_missing, const MWEB::Block& mweb_block_missing) {
+    if (mweb_header == nullptr) {
+        block = mweb_block;
+        return READ_STATUS_OK;
+    }
+
+    // The peer couldn't find the txs we asked for, and sent the whole extension block instead.
+    if (!mweb_block_missing.IsNull()) {
+        if (mweb_block_missing.GetMWEBHeader()->GetHash() != mweb_header->GetHash() ||
+                Hashed(mweb_block_missing.m_block->GetTxBody()) != mweb_body_hash)
+            return READ_STATUS_INVALID;
+
+        block = mweb_block_missing;
+        return READ_STATUS_OK;
+    }
+
+    // Blocks don't apply cut-through, so the TxBody is the (sorted) union of the
+    // txs' bodies. A tx with several kernels appears once per kernel, so dedupe by hash.
+    std::map<mw::Hash, mw::Transaction::CPtr> txs;
+    size_t kernels_missing = 0;
+    for (const CTransactionRef& tx : kernel_txn_available) {
+        if (tx) {
+            txs.emplace(tx->mweb_tx.m_transaction->GetHash(), tx->mweb_tx.m_transaction);
+        } else {
+            kernels_missing++;
+        }
+    }
+
+    if (mweb_txn_missing.size() > kernels_missing)
+        return READ_STATUS_INVALID;
+    for (const MWEB::Tx& tx : mweb_txn_missing) {
+        if (tx.IsNull())
+            return READ_STATUS_INVALID;
+        txs.emplace(tx.m_transaction->GetHash(), tx.m_transaction);
+    }
+
+    std::vector<mw::Transaction::CPtr> tx_vec;
+    tx_vec.reserve(txs.size());
+    for (const auto& tx : txs) {
+        tx_vec.push_back(tx.second);
+    }
+
+    // The header commits to the kernel and output roots but not to the rest of the TxBody,
+    // so check the reconstructed body against the body hash the peer sent.
+    mw::Transaction::CPtr pAggregated = Aggregation::Aggregate(tx_vec);
+    if (Hashed(pAggregated->GetBody()) != mweb_body_hash)
+        return READ_STATUS_FAILED; // Possible short ID collision
+
+    block = MWEB::Block(std::make_shared<mw::Block>(mweb_header, pAggregated->GetBody()));
+    return READ_STATUS_OK;
+}
+
+ReadStatus PartiallyDownloadedBlock::FillBlock(CBlock& block, const std::vector<CTransactionRef>& vtx_missing, const std::vector<MWEB::Tx>& mweb_txn_missing, const MWEB::Block& mweb_block_missing) {
     assert(!header.IsNull());
     uint256 hash = header.GetHash();
     block = header;
-    block.mweb_block = mweb_block;
     block.vtx.resize(txn_available.size());
 
+    const ReadStatus mweb_status = FillMWEBBlock(block.mweb_block, mweb_txn_missing, mweb_block_missing);
+    if (mweb_status != READ_STATUS_OK) {
+        header.SetNull();
+        txn_available.clear();
+        kernel_txn_available.clear();
+        return mweb_status;
+    }
+
     size_t tx_missing_offset = 0;
     for (size_t i = 0; i < txn_available.size(); i++) {
         if (!txn_available[i]) {
@@ -202,6 +353,7 @@ ReadStatus PartiallyDownloadedBlock::FillBlock(CBlock& block, const std::vector<
     // Make sure we can't call FillBlock again.
     header.SetNull();
     txn_available.clear();
+    kernel_txn_available.clear();
 
     if (vtx_missing.size() != tx_missing_offset)
         return READ_STATUS_INVALID;
@@ -218,6 +370,9 @@ ReadStatus PartiallyDownloadedBlock::FillBlock(CBlock& block, const std::vector<
     }
 
     LogPrint(BCLog::CMPCTBLOCK, "Successfully reconstructed block %s with %lu txn prefilled, %lu txn from mempool (incl at least %lu from extra pool) and %lu txn requested\n", hash.ToString(), prefilled_count, mempool_count, extra_count, vtx_missing.size());
+    if (mweb_header != nullptr) {
+        LogPrint(BCLog::CMPCTBLOCK, "Reconstructed MWEB block for %s with %lu kernels from mempool and %lu MWEB txn requested%s\n", hash.ToString(), kernel_mempool_count, mweb_txn_missing.size(), mweb_block_missing.IsNull() ? "" : " (full MWEB block received)");
+    }
     if (vtx_missing.size() < 5) {
         for (const auto& tx : vtx_missing) {
             LogPrint(BCLog::CMPCTBLOCK, "Reconstructed block %s required tx %s\n", hash.ToString(), tx->GetHash().ToString());
@@ -7,9 +7,18 @@
 
 #include <primitives/block.h>
 
+#include <unordered_map>
+
 
 class CTxMemPool;
 
+/**
+ * MWEB: Stream version flag for compact block version 4, under which the extension block in
+ * cmpctblock is replaced by its header and short kernel IDs, and getblocktxn/blocktxn carry
+ * the MWEB transactions needed to rebuild it. Set on streams to and from peers that negotiated it.
+ */
+static const int SERIALIZE_MWEB_SHORT_IDS = 0x10000000;
+
 // Transaction compression schemes for compact block relay can be introduced by writing
 // an actual formatter here.
 using TransactionCompression = DefaultFormatter;
@@ -41,10 +50,15 @@ public:
     // A BlockTransactionsRequest message
     uint256 blockhash;
     std::vector<uint16_t> indexes;
+    // MWEB: Indexes of the requested kernels, only serialized with SERIALIZE_MWEB_SHORT_IDS
+    std::vector<uint16_t> mweb_kernel_indexes;
 
     SERIALIZE_METHODS(BlockTransactionsRequest, obj)
     {
         READWRITE(obj.blockhash, Using<VectorFormatter<DifferenceFormatter>>(obj.indexes));
+        if (s.GetVersion() & SERIALIZE_MWEB_SHORT_IDS) {
+            READWRITE(Using<VectorFormatter<DifferenceFormatter>>(obj.mweb_kernel_indexes));
+        }
     }
 };
 
@@ -53,6 +67,10 @@ public:
     // A BlockTransactions message
     uint256 blockhash;
     std::vector<CTransactionRef> txn;
+    // MWEB: The transactions containing the requested kernels, only serialized with SERIALIZE_MWEB_SHORT_IDS.
+    std::vector<MWEB::Tx> mweb_txn;
+    // MWEB: The whole extension block, sent instead of mweb_txn when those transactions aren't known.
+    MWEB::Block mweb_block;
 
     BlockTransactions() {}
     explicit BlockTransactions(const BlockTransactionsRequest& req) :
@@ -61,6 +79,9 @@ public:
     SERIALIZE_METHODS(BlockTransactions, obj)
     {
         READWRITE(obj.blockhash, Using<VectorFormatter<TransactionCompression>>(obj.txn));
+        if (s.GetVersion() & SERIALIZE_MWEB_SHORT_IDS) {
+            READWRITE(obj.mweb_txn, obj.mweb_block);
+        }
     }
 };
 
@@ -102,12 +123,20 @@ public:
     CBlockHeader header;
     MWEB::Block mweb_block;
 
+    // MWEB: With SERIALIZE_MWEB_SHORT_IDS, these are sent in place of mweb_block.
+    // The header and a hash of the block's TxBody let the receiver rebuild and check the extension block
+    // from the mempool transactions that contain its kernels, each identified by a short ID.
+    mw::Header::CPtr mweb_header;
+    mw::Hash mweb_body_hash;
+    std::vector<uint64_t> shortkernelids;
+
     // Dummy for deserialization
     CBlockHeaderAndShortTxIDs() {}
 
     CBlockHeaderAndShortTxIDs(const CBlock& block, bool fUseWTXID);
 
     uint64_t GetShortID(const uint256& txhash) const;
+    uint64_t GetShortKernelID(const mw::Hash& kernel_id) const;
 
     size_t BlockTxCount() const { return shorttxids.size() + prefilledtxn.size(); }
 
@@ -116,7 +145,12 @@ public:
         const bool fAllowMWEB = !(s.GetVersion() & SERIALIZE_NO_MWEB);
 		
         READWRITE(obj.header, obj.nonce, Using<VectorFormatter<CustomUintFormatter<SHORTTXIDS_LENGTH>>>(obj.shorttxids), obj.prefilledtxn);
-        if (fAllowMWEB) {
+        if (fAllowMWEB && (s.GetVersion() & SERIALIZE_MWEB_SHORT_IDS)) {
+            READWRITE(WrapOptionalPtr(obj.mweb_header));
+            if (obj.mweb_header != nullptr) {
+                READWRITE(obj.mweb_body_hash, Using<VectorFormatter<CustomUintFormatter<SHORTTXIDS_LENGTH>>>(obj.shortkernelids));
+            }
+        } else if (fAllowMWEB) {
             READWRITE(obj.mweb_block);
         }
 
@@ -134,6 +168,16 @@ protected:
     std::vector<CTransactionRef> txn_available;
     size_t prefilled_count = 0, mempool_count = 0, extra_count = 0;
     const CTxMemPool* pool;
+
+    // MWEB: When the extension block was sent as short kernel IDs, the header and body hash it must match,
+    // and for each kernel, the transaction that contains it (if known).
+    mw::Header::CPtr mweb_header;
+    mw::Hash mweb_body_hash;
+    std::vector<CTransactionRef> kernel_txn_available;
+    size_t kernel_mempool_count = 0;
+
+    bool AddMWEBTx(const CTransactionRef& tx, const std::unordered_map<uint64_t, uint16_t>& shortkernelids, const CBlockHeaderAndShortTxIDs& cmpctblock);
+    ReadStatus FillMWEBBlock(MWEB::Block& block, const std::vector<MWEB::Tx>& mweb_txn_missing, const MWEB::Block& mweb_block_missing);
 public:
     CBlockHeader header;
     MWEB::Block mweb_block;
@@ -142,7 +186,11 @@ public:
     // extra_txn is a list of extra transactions to look at, in <witness hash, reference> form
     ReadStatus InitData(const CBlockHeaderAndShortTxIDs& cmpctblock, const std::vector<std::pair<uint256, CTransactionRef>>& extra_txn);
     bool IsTxAvailable(size_t index) const;
-    ReadStatus FillBlock(CBlock& block, const std::vector<CTransactionRef>& vtx_missing);
+    // MWEB: Whether the transaction containing the kernel at the given index is known.
+    // Always true when the extension block was sent in full.
+    bool IsKernelAvailable(size_t index) const;
+    size_t BlockKernelCount() const { return kernel_txn_available.size(); }
+    ReadStatus FillBlock(CBlock& block, const std::vector<CTransactionRef>& vtx_missing, const std::vector<MWEB::Tx>& mweb_txn_missing = {}, const MWEB::Block& mweb_block_missing = {});
 };
 
 #endif // BITCOIN_BLOCKENCODINGS_H
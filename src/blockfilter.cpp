@@ -22,6 +22,7 @@ static constexpr int GCS_SER_VERSION = 0;
 
 static const std::map<BlockFilterType, std::string> g_filter_types = {
     {BlockFilterType::BASIC, "basic"},
+    {BlockFilterType::MWEB, "mweb"},
 };
 
 // Map a value x that is uniformly distributed in the range [0, 2^64) to a
@@ -249,6 +250,44 @@ static GCSFilter::ElementSet BasicFilterElements(const CBlock& block,
     return elements;
 }
 
+/**
+ * MWEB filters let light clients find the extension blocks that created or spent
+ * their outputs, confirmed their kernels, or pegged out to their scripts.
+ * Output view tags are not included: they depend on each output's sender key,
+ * so a client can't know which tags to look for without the outputs themselves.
+ */
+static GCSFilter::ElementSet MWEBFilterElements(const CBlock& block)
+{
+    GCSFilter::ElementSet elements;
+    if (block.mweb_block.IsNull()) {
+        return elements;
+    }
+
+    const mw::Block::CPtr& mweb_block = block.mweb_block.m_block;
+    for (const Output& output : mweb_block->GetOutputs()) {
+        const mw::Hash& output_id = output.GetOutputID();
+        elements.emplace(output_id.vec().begin(), output_id.vec().end());
+    }
+
+    for (const Input& input : mweb_block->GetInputs()) {
+        const mw::Hash& output_id = input.GetOutputID();
+        elements.emplace(output_id.vec().begin(), output_id.vec().end());
+    }
+
+    for (const Kernel& kernel : mweb_block->GetKernels()) {
+        const mw::Hash& kernel_id = kernel.GetKernelID();
+        elements.emplace(kernel_id.vec().begin(), kernel_id.vec().end());
+
+        for (const PegOutCoin& pegout : kernel.GetPegOuts()) {
+            const CScript& script = pegout.GetScriptPubKey();
+            if (script.empty()) continue;
+            elements.emplace(script.begin(), script.end());
+        }
+    }
+
+    return elements;
+}
+
 BlockFilter::BlockFilter(BlockFilterType filter_type, const uint256& block_hash,
                          std::vector<unsigned char> filter)
     : m_filter_type(filter_type), m_block_hash(block_hash)
@@ -267,13 +306,18 @@ BlockFilter::BlockFilter(BlockFilterType filter_type, const CBlock& block, const
     if (!BuildParams(params)) {
         throw std::invalid_argument("unknown filter_type");
     }
-    m_filter = GCSFilter(params, BasicFilterElements(block, block_undo));
+    if (m_filter_type == BlockFilterType::MWEB) {
+        m_filter = GCSFilter(params, MWEBFilterElements(block));
+    } else {
+        m_filter = GCSFilter(params, BasicFilterElements(block, block_undo));
+    }
 }
 
 bool BlockFilter::BuildParams(GCSFilter::Params& params) const
 {
     switch (m_filter_type) {
     case BlockFilterType::BASIC:
+    case BlockFilterType::MWEB:
         params.m_siphash_k0 = m_block_hash.GetUint64(0);
         params.m_siphash_k1 = m_block_hash.GetUint64(1);
         params.m_P = BASIC_FILTER_P;
@@ -6,8 +6,11 @@
 #define BITCOIN_CHECKQUEUE_H
 
 #include <sync.h>
+#include <util/time.h>
 
 #include <algorithm>
+#include <memory>
+#include <thread>
 #include <vector>
 
 #include <boost/thread/condition_variable.hpp>
@@ -16,6 +19,22 @@
 template <typename T>
 class CCheckQueueControl;
 
+/** Timing of the checks run for one CCheckQueueControl, e.g. for one block. */
+struct CCheckQueueStats {
+    //! Number of checks that were run.
+    unsigned int checks{0};
+    //! Number of batches a worker took from another worker's queue.
+    unsigned int steals{0};
+    //! Number of workers (including the master) that took part.
+    int workers{0};
+    //! Time from taking control of the queue until all checks were done.
+    int64_t elapsed_us{0};
+    //! Time the master spent in Wait(), after adding its last check.
+    int64_t wait_us{0};
+    //! Time the workers (including the master) were not running checks, summed over all workers.
+    int64_t idle_us{0};
+};
+
 /**
  * Queue for verifications that have to be performed.
   * The verifications are represented by a type T, which must provide an
@@ -25,11 +44,24 @@ class CCheckQueueControl;
   * onto the queue, where they are processed by N-1 worker threads. When
   * the master is done adding work, it temporarily joins the worker pool
   * as an N'th worker, until all jobs are done.
+  *
+  * Every worker owns a queue of its own, and new checks are spread over
+  * them. A worker takes from the back of its own queue, and once that is
+  * empty it steals from the front of the others' queues, so the workers
+  * only contend for the shared mutex to update the counts.
   */
 template <typename T>
 class CCheckQueue
 {
 private:
+    /** The checks queued for one worker. Other workers steal from its front. */
+    struct WorkerQueue {
+        boost::mutex mutex;
+        //! Elements before head have already been stolen, and are cleared once the queue runs dry.
+        std::vector<T> checks;
+        size_t head{0};
+    };
+
     //! Mutex to protect the inner state
     boost::mutex mutex;
 
@@ -39,9 +71,21 @@ private:
     //! Master thread blocks on this when out of work
     boost::condition_variable condMaster;
 
-    //! The queue of elements to be processed.
-    //! As the order of booleans doesn't matter, it is used as a LIFO (stack)
-    std::vector<T> queue;
+    //! One queue per worker slot. As the order of booleans doesn't matter, each is mostly used as a LIFO (stack).
+    const unsigned int nWorkerQueues;
+    const std::unique_ptr<WorkerQueue[]> worker_queues;
+
+    //! Which worker slots are taken by a thread that is in Loop().
+    std::vector<bool> vSlotTaken;
+
+    //! One more than the highest slot ever taken, i.e. the queues that new checks are spread over.
+    unsigned int nSlotsUsed;
+
+    //! The queue that the next added checks start at.
+    unsigned int nNextQueue;
+
+    //! The number of elements in the worker queues that no worker has reserved yet.
+    unsigned int nQueued;
 
     //! The number of workers (including the master) that are idle.
     int nIdle;
@@ -62,6 +106,65 @@ private:
     //! The maximum number of elements to be processed in one batch
     unsigned int nBatchSize;
 
+    //! When the current control took the queue, and the time spent running checks since.
+    int64_t nControlStart;
+    int64_t nBusyTime;
+    CCheckQueueStats stats;
+    CCheckQueueStats last_stats;
+
+    /** Take the lowest free worker slot, or -1 if there is none. Requires mutex. */
+    int TakeSlot()
+    {
+        for (unsigned int i = 0; i < nWorkerQueues; i++) {
+            if (!vSlotTaken[i]) {
+                vSlotTaken[i] = true;
+                nSlotsUsed = std::max(nSlotsUsed, i + 1);
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * Move up to nNow checks into vChecks, first from the back of our own queue,
+     * then from the front of the others'. Returns how many were stolen.
+     * The caller must have reserved nNow elements from nQueued, so they exist.
+     */
+    unsigned int Collect(int slot, unsigned int nNow, std::vector<T>& vChecks)
+    {
+        unsigned int nStolen = 0;
+        if (slot >= 0) {
+            WorkerQueue& own = worker_queues[slot];
+            boost::unique_lock<boost::mutex> lock(own.mutex);
+            while (vChecks.size() < nNow && own.checks.size() > own.head) {
+                vChecks.emplace_back();
+                vChecks.back().swap(own.checks.back());
+                own.checks.pop_back();
+            }
+            if (own.checks.size() == own.head) {
+                own.checks.clear();
+                own.head = 0;
+            }
+        }
+
+        const unsigned int first = slot >= 0 ? slot + 1 : 0;
+        for (unsigned int n = 0; vChecks.size() < nNow; n++) {
+            WorkerQueue& victim = worker_queues[(first + n) % nWorkerQueues];
+            boost::unique_lock<boost::mutex> lock(victim.mutex);
+            if (victim.checks.size() == victim.head) continue;
+            while (vChecks.size() < nNow && victim.checks.size() > victim.head) {
+                vChecks.emplace_back();
+                vChecks.back().swap(victim.checks[victim.head++]);
+            }
+            if (victim.checks.size() == victim.head) {
+                victim.checks.clear();
+                victim.head = 0;
+            }
+            nStolen++;
+        }
+        return nStolen;
+    }
+
     /** Internal function that does bulk of the verification work. */
     bool Loop(bool fMaster = false)
     {
@@ -69,7 +172,11 @@ private:
         std::vector<T> vChecks;
         vChecks.reserve(nBatchSize);
         unsigned int nNow = 0;
+        unsigned int nStolen = 0;
+        int64_t nBatchTime = 0;
+        int slot = -1;
         bool fOk = true;
+        const int64_t nWaitStart = fMaster ? GetTimeMicros() : 0;
         do {
             {
                 boost::unique_lock<boost::mutex> lock(mutex);
@@ -77,20 +184,32 @@ private:
                 if (nNow) {
                     fAllOk &= fOk;
                     nTodo -= nNow;
+                    nBusyTime += nBatchTime;
+                    stats.checks += nNow;
+                    stats.steals += nStolen;
                     if (nTodo == 0 && !fMaster)
                         // We processed the last element; inform the master it can exit and return the result
                         condMaster.notify_one();
                 } else {
                     // first iteration
                     nTotal++;
+                    slot = TakeSlot();
                 }
                 // logically, the do loop starts here
-                while (queue.empty()) {
+                while (nQueued == 0) {
                     if (fMaster && nTodo == 0) {
                         nTotal--;
+                        if (slot >= 0) vSlotTaken[slot] = false;
                         bool fRet = fAllOk;
                         // reset the status for new work later
                         fAllOk = true;
+                        // record the stats of this round of work
+                        const int64_t nNowTime = GetTimeMicros();
+                        stats.workers = nTotal + 1;
+                        stats.elapsed_us = nNowTime - nControlStart;
+                        stats.wait_us = nNowTime - nWaitStart;
+                        stats.idle_us = std::max<int64_t>(0, stats.workers * stats.elapsed_us - nBusyTime);
+                        last_stats = stats;
                         // return the current status
                         return fRet;
                     }
@@ -103,22 +222,21 @@ private:
                 //   all workers finish approximately simultaneously.
                 // * Try to account for idle jobs which will instantly start helping.
                 // * Don't do batches smaller than 1 (duh), or larger than nBatchSize.
-                nNow = std::max(1U, std::min(nBatchSize, (unsigned int)queue.size() / (nTotal + nIdle + 1)));
-                vChecks.resize(nNow);
-                for (unsigned int i = 0; i < nNow; i++) {
-                    // We want the lock on the mutex to be as short as possible, so swap jobs from the global
-                    // queue to the local batch vector instead of copying.
-                    vChecks[i].swap(queue.back());
-                    queue.pop_back();
-                }
+                nNow = std::max(1U, std::min(nBatchSize, nQueued / (nTotal + nIdle + 1)));
+                nQueued -= nNow;
                 // Check whether we need to do work at all
                 fOk = fAllOk;
             }
+            // We want the shared lock to be held as briefly as possible, so the
+            // reserved checks are swapped out of the worker queues without it.
+            nStolen = Collect(slot, nNow, vChecks);
             // execute work
+            const int64_t nBatchStart = GetTimeMicros();
             for (T& check : vChecks)
                 if (fOk)
                     fOk = check();
             vChecks.clear();
+            nBatchTime = GetTimeMicros() - nBatchStart;
         } while (true);
     }
 
@@ -126,8 +244,14 @@ public:
     //! Mutex to ensure only one concurrent CCheckQueueControl
     boost::mutex ControlMutex;
 
-    //! Create a new check queue
-    explicit CCheckQueue(unsigned int nBatchSizeIn) : nIdle(0), nTotal(0), fAllOk(true), nTodo(0), nBatchSize(nBatchSizeIn) {}
+    /**
+     * Create a new check queue. Workers beyond nWorkerQueuesIn still run checks, but
+     * without a queue of their own. 0 means one queue per hardware thread.
+     */
+    explicit CCheckQueue(unsigned int nBatchSizeIn, unsigned int nWorkerQueuesIn = 0)
+        : nWorkerQueues(nWorkerQueuesIn ? nWorkerQueuesIn : std::max(1U, std::thread::hardware_concurrency())),
+          worker_queues(new WorkerQueue[nWorkerQueues]), vSlotTaken(nWorkerQueues, false), nSlotsUsed(0), nNextQueue(0),
+          nQueued(0), nIdle(0), nTotal(0), fAllOk(true), nTodo(0), nBatchSize(nBatchSizeIn), nControlStart(0), nBusyTime(0) {}
 
     //! Worker thread
     void Thread()
@@ -144,18 +268,53 @@ public:
     //! Add a batch of checks to the queue
     void Add(std::vector<T>& vChecks)
     {
-        boost::unique_lock<boost::mutex> lock(mutex);
-        for (T& check : vChecks) {
-            queue.push_back(T());
-            check.swap(queue.back());
+        if (vChecks.empty()) return;
+
+        unsigned int nQueues;
+        unsigned int nFirst;
+        {
+            boost::unique_lock<boost::mutex> lock(mutex);
+            nQueues = std::max(1U, nSlotsUsed);
+            nFirst = nNextQueue;
+            nNextQueue = (nNextQueue + 1) % nQueues;
+        }
+
+        // Spread the checks over the worker queues, in runs so neighbouring checks stay together.
+        const size_t nRun = (vChecks.size() + nQueues - 1) / nQueues;
+        for (size_t i = 0, q = nFirst; i < vChecks.size(); i += nRun, q = (q + 1) % nQueues) {
+            WorkerQueue& queue = worker_queues[q];
+            boost::unique_lock<boost::mutex> lock(queue.mutex);
+            for (size_t k = i; k < std::min(i + nRun, vChecks.size()); k++) {
+                queue.checks.push_back(T());
+                vChecks[k].swap(queue.checks.back());
+            }
         }
+
+        boost::unique_lock<boost::mutex> lock(mutex);
+        nQueued += vChecks.size();
         nTodo += vChecks.size();
         if (vChecks.size() == 1)
             condWorker.notify_one();
-        else if (vChecks.size() > 1)
+        else
             condWorker.notify_all();
     }
 
+    //! Start timing a new round of work. Called when a CCheckQueueControl takes the queue.
+    void StartControl()
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        stats = CCheckQueueStats{};
+        nControlStart = GetTimeMicros();
+        nBusyTime = 0;
+    }
+
+    //! The stats of the last round of work that was waited for.
+    CCheckQueueStats GetLastStats()
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        return last_stats;
+    }
+
     ~CCheckQueue()
     {
     }
@@ -182,6 +341,7 @@ public:
         // passed queue is supposed to be unused, or nullptr
         if (pqueue != nullptr) {
             ENTER_CRITICAL_SECTION(pqueue->ControlMutex);
+            pqueue->StartControl();
         }
     }
 
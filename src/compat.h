@@ -92,6 +92,12 @@ typedef char* sockopt_arg_type;
 #define USE_POLL
 #endif
 
+// epoll keeps socket registrations across iterations of the socket handler
+// instead of passing every socket to the kernel on each call.
+#if defined(__linux__)
+#define USE_EPOLL
+#endif
+
 bool static inline IsSelectableSocket(const SOCKET& s) {
 #if defined(USE_POLL) || defined(WIN32)
     return true;
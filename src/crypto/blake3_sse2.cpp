@@ -0,0 +1,11 @@
+// Copyright (c) 2022 The Litecoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_SSE2
+
+extern "C" {
+#include <crypto/blake3/blake3_sse2.c>
+}
+
+#endif
@@ -0,0 +1,163 @@
+// Copyright (c) 2022 The Litecoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <crypto/scrypt.h>
+
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace scrypt_avx2 {
+namespace {
+
+// Each vector holds the same 32-bit word of 8 independent scrypt states, one per lane,
+// so Salsa20/8 runs on all of them at once without any shuffling.
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi32(x, y); }
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+template <int n>
+__m256i inline Rotl(__m256i x) { return _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - n)); }
+
+void inline XorSalsa8(__m256i B[16], const __m256i Bx[16])
+{
+    __m256i x[16];
+    for (int i = 0; i < 16; i++) {
+        x[i] = B[i] = Xor(B[i], Bx[i]);
+    }
+
+    for (int i = 0; i < 8; i += 2) {
+        /* Operate on columns. */
+        x[ 4] = Xor(x[ 4], Rotl<7>(Add(x[ 0], x[12])));  x[ 9] = Xor(x[ 9], Rotl<7>(Add(x[ 5], x[ 1])));
+        x[14] = Xor(x[14], Rotl<7>(Add(x[10], x[ 6])));  x[ 3] = Xor(x[ 3], Rotl<7>(Add(x[15], x[11])));
+
+        x[ 8] = Xor(x[ 8], Rotl<9>(Add(x[ 4], x[ 0])));  x[13] = Xor(x[13], Rotl<9>(Add(x[ 9], x[ 5])));
+        x[ 2] = Xor(x[ 2], Rotl<9>(Add(x[14], x[10])));  x[ 7] = Xor(x[ 7], Rotl<9>(Add(x[ 3], x[15])));
+
+        x[12] = Xor(x[12], Rotl<13>(Add(x[ 8], x[ 4])));  x[ 1] = Xor(x[ 1], Rotl<13>(Add(x[13], x[ 9])));
+        x[ 6] = Xor(x[ 6], Rotl<13>(Add(x[ 2], x[14])));  x[11] = Xor(x[11], Rotl<13>(Add(x[ 7], x[ 3])));
+
+        x[ 0] = Xor(x[ 0], Rotl<18>(Add(x[12], x[ 8])));  x[ 5] = Xor(x[ 5], Rotl<18>(Add(x[ 1], x[13])));
+        x[10] = Xor(x[10], Rotl<18>(Add(x[ 6], x[ 2])));  x[15] = Xor(x[15], Rotl<18>(Add(x[11], x[ 7])));
+
+        /* Operate on rows. */
+        x[ 1] = Xor(x[ 1], Rotl<7>(Add(x[ 0], x[ 3])));  x[ 6] = Xor(x[ 6], Rotl<7>(Add(x[ 5], x[ 4])));
+        x[11] = Xor(x[11], Rotl<7>(Add(x[10], x[ 9])));  x[12] = Xor(x[12], Rotl<7>(Add(x[15], x[14])));
+
+        x[ 2] = Xor(x[ 2], Rotl<9>(Add(x[ 1], x[ 0])));  x[ 7] = Xor(x[ 7], Rotl<9>(Add(x[ 6], x[ 5])));
+        x[ 8] = Xor(x[ 8], Rotl<9>(Add(x[11], x[10])));  x[13] = Xor(x[13], Rotl<9>(Add(x[12], x[15])));
+
+        x[ 3] = Xor(x[ 3], Rotl<13>(Add(x[ 2], x[ 1])));  x[ 4] = Xor(x[ 4], Rotl<13>(Add(x[ 7], x[ 6])));
+        x[ 9] = Xor(x[ 9], Rotl<13>(Add(x[ 8], x[11])));  x[14] = Xor(x[14], Rotl<13>(Add(x[13], x[12])));
+
+        x[ 0] = Xor(x[ 0], Rotl<18>(Add(x[ 3], x[ 2])));  x[ 5] = Xor(x[ 5], Rotl<18>(Add(x[ 4], x[ 7])));
+        x[10] = Xor(x[10], Rotl<18>(Add(x[ 9], x[ 8])));  x[15] = Xor(x[15], Rotl<18>(Add(x[14], x[13])));
+    }
+
+    for (int i = 0; i < 16; i++) {
+        B[i] = Add(B[i], x[i]);
+    }
+}
+
+/** Transposes an 8x8 matrix of 32-bit words, r[i] holding row i. */
+void inline Transpose8x8(__m256i r[8])
+{
+    const __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+    const __m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+    const __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+    const __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+    const __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+    const __m256i t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+    const __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+    const __m256i t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+
+    const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+    const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+    const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+    const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+    const __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+    const __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+    const __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+    const __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+
+    r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+    r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+    r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+    r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+    r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+    r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+    r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+    r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+// Words of scratchpad per lane: 1024 blocks of 32 words.
+const size_t LANE_WORDS = 1024 * 32;
+
+} // namespace
+
+void Scrypt_8way(const char *input, char *output, char *scratchpad)
+{
+    alignas(32) uint8_t B[8][128];
+    __m256i X[32];
+    __m256i r[8];
+    uint32_t i, k, l;
+
+    // Each lane gets its own contiguous 128 KiB of scratchpad, so that the data-dependent
+    // reads in the second loop touch one 128-byte block per lane instead of 8.
+    uint32_t *V = (uint32_t *)(((uintptr_t)(scratchpad) + 63) & ~ (uintptr_t)(63));
+
+    for (l = 0; l < 8; l++) {
+        PBKDF2_SHA256((const uint8_t *)input + 80 * l, 80, (const uint8_t *)input + 80 * l, 80, 1, B[l], 128);
+    }
+
+    // x86 is little-endian, so loading the bytes is the same as le32dec.
+    for (k = 0; k < 32; k += 8) {
+        for (l = 0; l < 8; l++)
+            r[l] = _mm256_load_si256((const __m256i *)&B[l][4 * k]);
+        Transpose8x8(r);
+        for (l = 0; l < 8; l++)
+            X[k + l] = r[l];
+    }
+
+    for (i = 0; i < 1024; i++) {
+        for (k = 0; k < 32; k += 8) {
+            for (l = 0; l < 8; l++)
+                r[l] = X[k + l];
+            Transpose8x8(r);
+            for (l = 0; l < 8; l++)
+                _mm256_store_si256((__m256i *)&V[l * LANE_WORDS + i * 32 + k], r[l]);
+        }
+        XorSalsa8(&X[0], &X[16]);
+        XorSalsa8(&X[16], &X[0]);
+    }
+    for (i = 0; i < 1024; i++) {
+        alignas(32) uint32_t j[8];
+        _mm256_store_si256((__m256i *)j, _mm256_and_si256(X[16], _mm256_set1_epi32(1023)));
+
+        for (k = 0; k < 32; k += 8) {
+            for (l = 0; l < 8; l++)
+                r[l] = _mm256_load_si256((const __m256i *)&V[l * LANE_WORDS + j[l] * 32 + k]);
+            Transpose8x8(r);
+            for (l = 0; l < 8; l++)
+                X[k + l] = Xor(X[k + l], r[l]);
+        }
+        XorSalsa8(&X[0], &X[16]);
+        XorSalsa8(&X[16], &X[0]);
+    }
+
+    for (k = 0; k < 32; k += 8) {
+        for (l = 0; l < 8; l++)
+            r[l] = X[k + l];
+        Transpose8x8(r);
+        for (l = 0; l < 8; l++)
+            _mm256_store_si256((__m256i *)&B[l][4 * k], r[l]);
+    }
+
+    for (l = 0; l < 8; l++) {
+        PBKDF2_SHA256((const uint8_t *)input + 80 * l, 80, B[l], 128, 1, (uint8_t *)output + 32 * l, 32);
+    }
+}
+
+} // namespace scrypt_avx2
+
+#endif // ENABLE_AVX2
@@ -28,12 +28,26 @@
  */
 
 #include <crypto/scrypt.h>
+#include <crypto/common.h>
 
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
+#include <memory>
 #include <openssl/sha.h>
 
+#include <compat/cpuid.h>
+
+#if defined(ENABLE_AVX2) && !defined(BUILD_BITCOIN_INTERNAL)
+namespace scrypt_avx2
+{
+void Scrypt_8way(const char *input, char *output, char *scratchpad);
+}
+
+// 8 lanes of 128 KiB, aligned to 64 bytes.
+static const size_t SCRYPT_8WAY_SCRATCHPAD_SIZE = 8 * 131072 + 63;
+#endif
+
 #if defined(USE_SSE2) && !defined(USE_SSE2_ALWAYS)
 #ifdef _MSC_VER
 // MSVC 64bit is unable to use inline asm
@@ -331,3 +345,50 @@ void scrypt_1024_1_1_256(const char *input, char *output)
 	char scratchpad[SCRYPT_SCRATCHPAD_SIZE];
     scrypt_1024_1_1_256_sp(input, output, scratchpad);
 }
+
+#if defined(ENABLE_AVX2) && !defined(BUILD_BITCOIN_INTERNAL) && defined(HAVE_GETCPUID)
+static bool scrypt_detect_avx2()
+{
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    const bool have_xsave = (ecx >> 27) & 1;
+    const bool have_avx = (ecx >> 28) & 1;
+    if (!have_xsave || !have_avx) {
+        return false;
+    }
+
+    // Check that the OS has enabled the AVX registers.
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    if ((a & 6) != 6) {
+        return false;
+    }
+
+    GetCPUID(7, 0, eax, ebx, ecx, edx);
+    return (ebx >> 5) & 1;
+}
+#endif
+
+void scrypt_1024_1_1_256_batch(const char *input, char *output, size_t count)
+{
+#if defined(ENABLE_AVX2) && !defined(BUILD_BITCOIN_INTERNAL) && defined(HAVE_GETCPUID)
+    static const bool have_avx2 = scrypt_detect_avx2();
+    if (have_avx2 && count >= 8) {
+        std::unique_ptr<char[]> scratchpad(new char[SCRYPT_8WAY_SCRATCHPAD_SIZE]);
+        for (; count >= 8; count -= 8) {
+            scrypt_avx2::Scrypt_8way(input, output, scratchpad.get());
+            input += 8 * 80;
+            output += 8 * 32;
+        }
+    }
+#endif
+
+    if (count > 0) {
+        std::unique_ptr<char[]> scratchpad(new char[SCRYPT_SCRATCHPAD_SIZE]);
+        for (; count > 0; count--) {
+            scrypt_1024_1_1_256_sp(input, output, scratchpad.get());
+            input += 80;
+            output += 32;
+        }
+    }
+}
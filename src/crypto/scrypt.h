@@ -9,6 +9,12 @@ static const int SCRYPT_SCRATCHPAD_SIZE = 131072 + 63;
 void scrypt_1024_1_1_256(const char *input, char *output);
 void scrypt_1024_1_1_256_sp_generic(const char *input, char *output, char *scratchpad);
 
+/**
+ * Computes count scrypt_1024_1_1_256 hashes of consecutive 80-byte inputs into consecutive 32-byte outputs.
+ * With AVX2, 8 hashes are computed at a time, with their Salsa20/8 cores interleaved across vector lanes.
+ */
+void scrypt_1024_1_1_256_batch(const char *input, char *output, size_t count);
+
 #if defined(USE_SSE2)
 #include <string>
 #if defined(_M_X64) || defined(__x86_64__) || defined(_M_AMD64) || (defined(MAC_OSX) && defined(__i386__))
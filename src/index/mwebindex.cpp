@@ -0,0 +1,92 @@
+// Copyright (c) 2022 The Litecoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/mwebindex.h>
+#include <util/system.h>
+
+constexpr char DB_MWEB_KERNEL = 'k';
+constexpr char DB_MWEB_OUTPUT = 'o';
+constexpr char DB_MWEB_SPENT = 'i';
+
+std::unique_ptr<MWEBIndex> g_mwebindex;
+
+/** Access to the mwebindex database (indexes/mwebindex/) */
+class MWEBIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Read the location of the object with the given key. Returns false if it is not indexed.
+    bool ReadEntry(char key_type, const mw::Hash& id, MWEBIndexEntry& entry) const;
+
+    /// Write the locations of all kernels, outputs and inputs in the given MWEB block.
+    bool WriteBlock(const mw::Block& block, const CBlockIndex* pindex);
+};
+
+MWEBIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(GetDataDir() / "indexes" / "mwebindex", n_cache_size, f_memory, f_wipe)
+{}
+
+bool MWEBIndex::DB::ReadEntry(char key_type, const mw::Hash& id, MWEBIndexEntry& entry) const
+{
+    return Read(std::make_pair(key_type, id), entry);
+}
+
+bool MWEBIndex::DB::WriteBlock(const mw::Block& block, const CBlockIndex* pindex)
+{
+    MWEBIndexEntry entry;
+    entry.block_hash = pindex->GetBlockHash();
+    entry.height = pindex->nHeight;
+
+    CDBBatch batch(*this);
+    entry.position = 0;
+    for (const Kernel& kernel : block.GetKernels()) {
+        batch.Write(std::make_pair(DB_MWEB_KERNEL, kernel.GetKernelID()), entry);
+        entry.position++;
+    }
+
+    entry.position = 0;
+    for (const Output& output : block.GetOutputs()) {
+        batch.Write(std::make_pair(DB_MWEB_OUTPUT, output.GetOutputID()), entry);
+        entry.position++;
+    }
+
+    entry.position = 0;
+    for (const Input& input : block.GetInputs()) {
+        batch.Write(std::make_pair(DB_MWEB_SPENT, input.GetOutputID()), entry);
+        entry.position++;
+    }
+
+    return WriteBatch(batch);
+}
+
+MWEBIndex::MWEBIndex(size_t n_cache_size, bool f_memory, bool f_wipe)
+    : m_db(MakeUnique<MWEBIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+MWEBIndex::~MWEBIndex() {}
+
+bool MWEBIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    if (block.mweb_block.IsNull()) return true;
+
+    return m_db->WriteBlock(*block.mweb_block.m_block, pindex);
+}
+
+BaseIndex::DB& MWEBIndex::GetDB() const { return *m_db; }
+
+bool MWEBIndex::FindKernel(const mw::Hash& kernel_id, MWEBIndexEntry& entry) const
+{
+    return m_db->ReadEntry(DB_MWEB_KERNEL, kernel_id, entry);
+}
+
+bool MWEBIndex::FindOutput(const mw::Hash& output_id, MWEBIndexEntry& entry) const
+{
+    return m_db->ReadEntry(DB_MWEB_OUTPUT, output_id, entry);
+}
+
+bool MWEBIndex::FindSpend(const mw::Hash& output_id, MWEBIndexEntry& entry) const
+{
+    return m_db->ReadEntry(DB_MWEB_SPENT, output_id, entry);
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2022 The Litecoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_MWEBINDEX_H
+#define BITCOIN_INDEX_MWEBINDEX_H
+
+#include <chain.h>
+#include <index/base.h>
+#include <mw/models/crypto/Hash.h>
+#include <serialize.h>
+#include <uint256.h>
+
+/** The location of an MWEB kernel, output or input within the block chain. */
+struct MWEBIndexEntry
+{
+    uint256 block_hash;
+    int height{0};
+    //! Index into the block's sorted list of kernels, outputs or inputs.
+    uint32_t position{0};
+
+    SERIALIZE_METHODS(MWEBIndexEntry, obj)
+    {
+        READWRITE(obj.block_hash, VARINT_MODE(obj.height, VarIntMode::NONNEGATIVE_SIGNED), VARINT(obj.position));
+    }
+};
+
+/**
+ * MWEBIndex is used to look up MWEB kernels and outputs included in the
+ * blockchain by ID. The index is written to a LevelDB database and records
+ * the block and position of each kernel, each output, and each input by the
+ * ID of the output it spends.
+ *
+ * Entries are not removed when blocks are disconnected, so callers must
+ * check that the returned block is still in the active chain.
+ */
+class MWEBIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+protected:
+    bool WriteBlock(const CBlock& block, const CBlockIndex* pindex) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+    const char* GetName() const override { return "mwebindex"; }
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit MWEBIndex(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~MWEBIndex() override;
+
+    /// Look up the block that included the kernel with the given ID.
+    bool FindKernel(const mw::Hash& kernel_id, MWEBIndexEntry& entry) const;
+
+    /// Look up the block that created the output with the given ID.
+    bool FindOutput(const mw::Hash& output_id, MWEBIndexEntry& entry) const;
+
+    /// Look up the block that spent the output with the given ID.
+    bool FindSpend(const mw::Hash& output_id, MWEBIndexEntry& entry) const;
+};
+
+/// The global MWEB kernel and output index. May be null.
+extern std::unique_ptr<MWEBIndex> g_mwebindex;
+
+#endif // BITCOIN_INDEX_MWEBINDEX_H
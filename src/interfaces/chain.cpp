@@ -38,7 +38,7 @@
 namespace interfaces {
 namespace {
 
-bool FillBlock(const CBlockIndex* index, const FoundBlock& block, UniqueLock<RecursiveMutex>& lock)
+bool FillBlock(const CBlockIndex* index, const FoundBlock& block, UniqueLock<TimedRecursiveMutex>& lock)
 {
     if (!index) return false;
     if (block.m_hash) *block.m_hash = index->GetBlockHash();
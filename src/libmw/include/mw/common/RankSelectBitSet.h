@@ -0,0 +1,172 @@
+#pragma once
+
+#include <mw/common/BitSet.h>
+#include <boost/optional.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+/// <summary>
+/// An immutable bitset indexed for constant-time rank and logarithmic-time select.
+/// Bits are packed into 64-bit words, and the number of set bits preceding every
+/// superblock of 8 words (512 bits) is precomputed, so a rank query needs
+/// one lookup plus at most 8 popcounts, regardless of the size of the bitset.
+/// </summary>
+class RankSelectBitSet
+{
+public:
+    RankSelectBitSet()
+        : m_size(0), m_superblocks(1, 0) { }
+
+    explicit RankSelectBitSet(const BitSet& bits)
+        : m_size(bits.size())
+    {
+        using Block = boost::dynamic_bitset<>::block_type;
+        static constexpr size_t BITS_PER_BLOCK = boost::dynamic_bitset<>::bits_per_block;
+        static_assert(64 % BITS_PER_BLOCK == 0, "blocks must evenly divide 64-bit words");
+
+        std::vector<Block> blocks;
+        blocks.reserve(bits.bitset.num_blocks());
+        boost::to_block_range(bits.bitset, std::back_inserter(blocks));
+
+        m_words.resize((m_size + 63) / 64, 0);
+        for (size_t i = 0; i < blocks.size(); i++) {
+            m_words[(i * BITS_PER_BLOCK) / 64] |= (uint64_t)blocks[i] << ((i * BITS_PER_BLOCK) % 64);
+        }
+
+        BuildIndex();
+    }
+
+    /// <summary>
+    /// Builds the bitset from its serialized form (see BitSet::bytes()),
+    /// where the first bit of each byte is its most significant bit.
+    /// </summary>
+    static RankSelectBitSet From(const std::vector<uint8_t>& bytes)
+    {
+        RankSelectBitSet ret;
+        ret.m_size = bytes.size() * 8;
+        ret.m_words.resize((ret.m_size + 63) / 64, 0);
+        for (size_t i = 0; i < bytes.size(); i++) {
+            ret.m_words[i / 8] |= (uint64_t)ReverseBits(bytes[i]) << ((i % 8) * 8);
+        }
+
+        ret.BuildIndex();
+        return ret;
+    }
+
+    bool test(const uint64_t idx) const noexcept
+    {
+        return idx < m_size && ((m_words[idx / 64] >> (idx % 64)) & 1);
+    }
+
+    uint64_t count() const noexcept { return m_superblocks.back(); }
+    uint64_t size() const noexcept { return m_size; }
+
+    /// <summary>
+    /// Calculates the number of set bits that are strictly smaller than idx.
+    /// </summary>
+    /// <param name="idx">The index to calculate the rank for.</param>
+    /// <returns>The calculated rank.</returns>
+    uint64_t rank(const uint64_t idx) const noexcept
+    {
+        if (idx >= m_size) {
+            return count();
+        }
+
+        const size_t word_idx = idx / 64;
+        const size_t superblock_idx = word_idx / WORDS_PER_SUPERBLOCK;
+
+        uint64_t rank = m_superblocks[superblock_idx];
+        for (size_t i = superblock_idx * WORDS_PER_SUPERBLOCK; i < word_idx; i++) {
+            rank += PopCount(m_words[i]);
+        }
+
+        const uint64_t mask = (uint64_t(1) << (idx % 64)) - 1;
+        return rank + PopCount(m_words[word_idx] & mask);
+    }
+
+    /// <summary>
+    /// Finds the position of the set bit with the given rank, i.e. select(rank(i)) == i for every set bit i.
+    /// </summary>
+    /// <param name="rank">The number of set bits preceding the bit to find.</param>
+    /// <returns>The position of the bit, or boost::none if there are no more than rank set bits.</returns>
+    boost::optional<uint64_t> select(uint64_t rank) const noexcept
+    {
+        if (rank >= count()) {
+            return boost::none;
+        }
+
+        // The last superblock whose preceding count is <= rank contains the bit.
+        auto iter = std::upper_bound(m_superblocks.cbegin(), m_superblocks.cend(), rank);
+        const size_t superblock_idx = std::distance(m_superblocks.cbegin(), iter) - 1;
+        rank -= m_superblocks[superblock_idx];
+
+        size_t word_idx = superblock_idx * WORDS_PER_SUPERBLOCK;
+        while (PopCount(m_words[word_idx]) <= rank) {
+            rank -= PopCount(m_words[word_idx]);
+            ++word_idx;
+        }
+
+        uint64_t word = m_words[word_idx];
+        while (rank-- > 0) {
+            word &= word - 1; // Clear the lowest set bit
+        }
+
+        uint64_t bit = 0;
+        while (!((word >> bit) & 1)) {
+            ++bit;
+        }
+
+        return word_idx * 64 + bit;
+    }
+
+private:
+    static constexpr size_t WORDS_PER_SUPERBLOCK = 8;
+
+    void BuildIndex()
+    {
+        const size_t num_superblocks = (m_words.size() + WORDS_PER_SUPERBLOCK - 1) / WORDS_PER_SUPERBLOCK;
+        m_superblocks.assign(num_superblocks + 1, 0);
+
+        uint64_t total = 0;
+        for (size_t i = 0; i < m_words.size(); i++) {
+            if (i % WORDS_PER_SUPERBLOCK == 0) {
+                m_superblocks[i / WORDS_PER_SUPERBLOCK] = total;
+            }
+
+            total += PopCount(m_words[i]);
+        }
+
+        m_superblocks.back() = total;
+    }
+
+    static uint64_t PopCount(uint64_t word) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(word);
+#else
+        uint64_t count = 0;
+        while (word != 0) {
+            word &= word - 1;
+            ++count;
+        }
+        return count;
+#endif
+    }
+
+    static uint8_t ReverseBits(uint8_t byte) noexcept
+    {
+        byte = (byte & 0xF0) >> 4 | (byte & 0x0F) << 4;
+        byte = (byte & 0xCC) >> 2 | (byte & 0x33) << 2;
+        byte = (byte & 0xAA) >> 1 | (byte & 0x55) << 1;
+        return byte;
+    }
+
+    uint64_t m_size;
+    std::vector<uint64_t> m_words;
+
+    // m_superblocks[i] is the number of set bits in the words before superblock i.
+    // The extra last entry holds the total number of set bits.
+    std::vector<uint64_t> m_superblocks;
+};
@@ -11,10 +11,21 @@
 class Bulletproofs
 {
 public:
+    //
+    // Verifies the proofs that aren't already in the verification cache, and caches them if all are valid.
+    //
     static bool BatchVerify(
         const std::vector<ProofData>& rangeProofs
     );
 
+    //
+    // Verifies all of the proofs, without consulting or updating the verification cache.
+    // The proofs are split into sub-batches, which are verified in parallel on the CryptoCheckQueue.
+    //
+    static bool BatchVerifyUncached(
+        const std::vector<ProofData>& rangeProofs
+    );
+
     static RangeProof::CPtr Generate(
         const uint64_t amount,
         const SecretKey& key,
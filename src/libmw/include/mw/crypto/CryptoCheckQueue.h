@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+//
+// A unit of verification work, typically a sub-batch of proofs or signatures.
+// Satisfies the requirements of CCheckQueue (default constructible, swappable, bool operator()).
+//
+class CryptoCheck
+{
+public:
+    CryptoCheck() = default;
+    CryptoCheck(std::function<bool()> check) : m_check(std::move(check)) { }
+
+    bool operator()() { return m_check(); }
+    void swap(CryptoCheck& other) noexcept { m_check.swap(other.m_check); }
+
+private:
+    std::function<bool()> m_check;
+};
+
+//
+// Runs MWEB cryptographic verifications (rangeproofs, signatures) on a pool of worker threads.
+// The node starts one worker per additional -par thread, alongside the script-check threads.
+// Without any workers, checks run serially on the calling thread.
+//
+class CryptoCheckQueue
+{
+public:
+    //
+    // Body of a worker thread. Runs until the thread is interrupted.
+    //
+    static void Thread(const int worker_num);
+
+    //
+    // Number of threads that can run checks concurrently, including the calling thread.
+    //
+    static size_t NumThreads() noexcept;
+
+    //
+    // Runs the checks, spread across the worker threads, and waits for them to finish.
+    // Returns true only if every check succeeded.
+    //
+    static bool Run(std::vector<CryptoCheck>& checks);
+};
@@ -68,9 +68,57 @@ private:
     blake3_hasher m_hasher;
 };
 
+//
+// Exposes the nodes of BLAKE3's internal tree (1 KiB chunks joined by binary parent nodes),
+// so large buffers that change only in a few places can cache chaining values (CVs) and rehash
+// just the modified chunks. Combining the CVs in BLAKE3's tree order yields the same digest
+// that Hasher produces for the whole buffer.
+//
+class Blake3Tree
+{
+public:
+    static constexpr size_t CHUNK_LEN = BLAKE3_CHUNK_LEN;
+
+    // Chaining value of the (non-root) chunk at position chunk_counter. len must not exceed CHUNK_LEN.
+    static mw::Hash ChunkCV(const uint8_t* input, const size_t len, const uint64_t chunk_counter);
+
+    // Chaining value of a non-root parent node.
+    static mw::Hash ParentCV(const mw::Hash& left_cv, const mw::Hash& right_cv);
+
+    // Final digest of a tree whose root node has the given children.
+    static mw::Hash ParentRoot(const mw::Hash& left_cv, const mw::Hash& right_cv);
+};
+
+/** Detects the BLAKE3 backend used for this CPU, and checks that it works.
+ *  Returns a name describing the implementation.
+ */
+extern std::string Blake3AutoDetect();
+
 extern mw::Hash Hashed(const std::vector<uint8_t>& serialized);
 extern mw::Hash Hashed(const Traits::ISerializable& serializable);
 
+/** Hashes many independent messages, returning the same digests as calling Hashed() on each.
+ *  Messages of up to one chunk (1 KiB) that have the same number of 64-byte blocks
+ *  are compressed together, one message per SIMD lane.
+ */
+extern std::vector<mw::Hash> BatchHashed(const std::vector<std::vector<uint8_t>>& messages);
+
+/** While in scope, Inputs, Outputs and Kernels deserialized on this thread leave their hashes
+ *  uncomputed, so that the caller can compute them all at once with BatchHashed().
+ */
+class DeferredHashing
+{
+public:
+    DeferredHashing() : m_prev(s_active) { s_active = true; }
+    ~DeferredHashing() { s_active = m_prev; }
+
+    static bool IsActive() noexcept { return s_active; }
+
+private:
+    bool m_prev;
+    static thread_local bool s_active;
+};
+
 template<class T>
 mw::Hash Hashed(const EHashTag tag, const T& serializable)
 {
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <mw/models/crypto/ProofData.h>
+#include <mw/models/crypto/SignedMessage.h>
+
+// Default for -mwebsigcachesize, in MiB.
+static const int64_t DEFAULT_MWEB_SIG_CACHE_SIZE = 32;
+
+// Maximum for -mwebsigcachesize, in MiB.
+static const int64_t MAX_MWEB_SIG_CACHE_SIZE = 16384;
+
+//
+// Remembers the schnorr signatures and rangeproofs that have already been verified,
+// so that MWEB transactions aren't verified again when they are included in a block.
+//
+// Entries are salted hashes, held in CuckooCaches like the script signature cache.
+// The entries are sharded across several caches, each with its own lock,
+// so verification threads rarely contend with each other.
+//
+class VerificationCache
+{
+public:
+    //
+    // Resizes the cache to use up to max_size_mib MiB (clamped to [0, MAX_MWEB_SIG_CACHE_SIZE]).
+    // Any cached entries are dropped. Must not be called while other threads use the cache.
+    // Returns the number of entries the cache can hold.
+    //
+    static size_t Init(const int64_t max_size_mib);
+
+    static bool Contains(const SignedMessage& signed_message);
+    static void Insert(const SignedMessage& signed_message);
+
+    static bool Contains(const ProofData& proof);
+    static void Insert(const ProofData& proof);
+};
@@ -7,6 +7,32 @@
 // Forward Declarations
 class Database;
 
+//
+// Iterates over the UTXOs in the database, in output ID order.
+// Like any LevelDB iterator, it reads from a snapshot of the database
+// taken when it was created, so later writes don't affect it.
+//
+class UTXOCursor
+{
+public:
+	using UPtr = std::unique_ptr<UTXOCursor>;
+
+	explicit UTXOCursor(std::unique_ptr<mw::DBIterator>&& pIterator);
+
+	bool Valid() const;
+	void Next();
+
+	//
+	// Returns the UTXO at the cursor, or nullptr if it couldn't be read.
+	//
+	UTXO::CPtr GetUTXO() const;
+
+private:
+	void SkipLegacyKeys();
+
+	std::unique_ptr<mw::DBIterator> m_pIterator;
+};
+
 class CoinDB
 {
 public:
@@ -41,6 +67,18 @@ public:
 	//
 	void RemoveAllUTXOs();
 
+	//
+	// Returns a cursor over every UTXO in the database.
+	//
+	UTXOCursor::UPtr NewCursor() const;
+
+	//
+	// Rewrites any UTXOs stored under the hex-encoded output ID keys used by older versions,
+	// so they're stored under the binary keys instead. Returns the number of UTXOs migrated.
+	//
+	size_t MigrateHexKeys();
+
 private:
+	mw::DBWrapper* m_pDBWrapper;
 	std::unique_ptr<Database> m_pDatabase;
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mw/file/File.h>
+#include <mw/file/FileJournal.h>
 #include <mw/file/FilePath.h>
 #include <mw/file/MemMap.h>
 
@@ -35,10 +36,15 @@ public:
             ThrowFile_F("Buffer index is past the end of {}", m_file);
         }
 
+        // Only the bytes past the buffer index get overwritten, so those are all that need to be journaled.
+        FileUndo undo(m_fileSize);
+        if (m_bufferIndex < m_fileSize) {
+            undo.AddRange(m_bufferIndex, m_mmap.Read(m_bufferIndex, m_fileSize - m_bufferIndex));
+        }
+
         m_mmap.Unmap();
 
-        m_file.CopyTo(new_path);
-        m_file = File(new_path);
+        m_file = FileJournal::Snapshot(m_file, new_path, undo);
 
         if (m_fileSize != m_bufferIndex || !m_buffer.empty()) {
             m_file.Write(m_bufferIndex, m_buffer, true);
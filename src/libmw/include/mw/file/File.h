@@ -26,6 +26,10 @@ public:
     void Truncate(const uint64_t size);
 
     void CopyTo(const FilePath& new_path) const;
+    void Rename(const FilePath& new_path);
+
+    // Creates a hard link to this file at new_path. Returns false if the filesystem doesn't support it.
+    bool HardLinkTo(const FilePath& new_path) const;
 
     //
     // Traits
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <mw/common/Traits.h>
+#include <mw/file/File.h>
+#include <mw/file/FilePath.h>
+
+#include <functional>
+
+/// <summary>
+/// The original contents of the parts of a file that are about to be modified in place.
+/// Applying it to the modified file restores the file as it was when the undo was built.
+/// </summary>
+struct FileUndo : public Traits::ISerializable
+{
+    struct Range
+    {
+        uint64_t offset;
+        std::vector<uint8_t> bytes;
+
+        SERIALIZE_METHODS(Range, obj) { READWRITE(obj.offset, obj.bytes); }
+    };
+
+    FileUndo() : size(0) { }
+    FileUndo(const uint64_t size_in) : size(size_in) { }
+
+    // Size of the file before it was modified.
+    uint64_t size;
+
+    // Original contents of every modified range that was within the old file size.
+    std::vector<Range> ranges;
+
+    void AddRange(const uint64_t offset, std::vector<uint8_t>&& bytes);
+    void Apply(File& file) const;
+
+    IMPL_SERIALIZABLE(FileUndo, obj)
+    {
+        READWRITE(obj.size, obj.ranges);
+    }
+};
+
+/// <summary>
+/// Lets the MMR hash files and leafsets be flushed in place, instead of copying the whole file
+/// to the path of the new file index on every flush.
+///
+/// A flush to file index N hard-links N's path to the current file, after first persisting an
+/// undo journal (e.g. "O000005.undo") with the bytes the flush will overwrite. Until MMRInfo N
+/// is committed to the database, a restart rolls the shared file back to index N-1 using the
+/// journal. Once it is committed, the journals and older links are deleted by Cleanup.
+/// </summary>
+class FileJournal
+{
+public:
+    using PathFn = std::function<FilePath(const uint32_t file_index)>;
+
+    /// <summary>
+    /// Makes new_path refer to the contents of file, so it can be modified in place.
+    /// Falls back to copying the file when hard links are not supported.
+    /// </summary>
+    /// <param name="file">The file holding the latest flushed state.</param>
+    /// <param name="new_path">The path of the file for the new file index.</param>
+    /// <param name="undo">The original contents of the bytes that are about to be modified.</param>
+    /// <returns>The file at new_path.</returns>
+    static File Snapshot(const File& file, const FilePath& new_path, const FileUndo& undo);
+
+    /// <summary>
+    /// Rolls back any flushes beyond file_index that were never committed to the database,
+    /// and removes their files and journals.
+    /// </summary>
+    /// <param name="get_path">Returns the path of the file for a given file index.</param>
+    /// <param name="file_index">The file index of the latest committed MMRInfo.</param>
+    static void Recover(const PathFn& get_path, const uint32_t file_index);
+
+    /// <summary>
+    /// Removes the files and journals for all file indices before current_file_index.
+    /// </summary>
+    static void Cleanup(const PathFn& get_path, const uint32_t current_file_index);
+
+    static FilePath GetUndoPath(const FilePath& path) { return path.ReplaceExtension(".undo"); }
+};
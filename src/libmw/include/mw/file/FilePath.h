@@ -57,6 +57,12 @@ public:
     FilePath GetChild(const char* filename) const { return FilePath(m_path / ghc::filesystem::path(filename)); }
     FilePath GetChild(const std::string& filename) const { return FilePath(m_path / ghc::filesystem::path(filename)); }
 
+    FilePath ReplaceExtension(const std::string& extension) const
+    {
+        ghc::filesystem::path path = m_path;
+        return FilePath(path.replace_extension(extension));
+    }
+
     FilePath GetParent() const
     {
         if (!m_path.has_parent_path()) {
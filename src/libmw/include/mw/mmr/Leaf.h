@@ -24,6 +24,29 @@ public:
         return Leaf(index, std::move(hash), std::move(data));
     }
 
+    // Creates leaves for consecutive indices, starting at first_index, hashing them all as one batch.
+    static std::vector<Leaf> CreateBatch(const LeafIndex& first_index, std::vector<std::vector<uint8_t>> data)
+    {
+        std::vector<std::vector<uint8_t>> messages(data.size());
+        LeafIndex index = first_index;
+        for (size_t i = 0; i < data.size(); i++) {
+            CVectorWriter(SER_GETHASH, 0, messages[i], 0) << index.GetPosition() << data[i];
+            index = index.Next();
+        }
+
+        std::vector<mw::Hash> hashes = BatchHashed(messages);
+
+        std::vector<Leaf> leaves;
+        leaves.reserve(data.size());
+        index = first_index;
+        for (size_t i = 0; i < data.size(); i++) {
+            leaves.push_back(Leaf(index, std::move(hashes[i]), std::move(data[i])));
+            index = index.Next();
+        }
+
+        return leaves;
+    }
+
     static mw::Hash CalcHash(const LeafIndex& index, const std::vector<uint8_t>& data)
     {
         return Hasher()
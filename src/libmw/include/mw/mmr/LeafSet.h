@@ -6,7 +6,9 @@
 #include <mw/file/MemMap.h>
 #include <mw/models/crypto/Hash.h>
 #include <mw/mmr/LeafIndex.h>
+#include <set>
 #include <unordered_map>
+#include <unordered_set>
 
 class ILeafSet
 {
@@ -26,6 +28,16 @@ public:
 	const mmr::LeafIndex& GetNextLeafIdx() const noexcept { return m_nextLeafIdx; }
 	BitSet ToBitSet() const;
 
+	/// <summary>
+	/// Calculates the BLAKE3 chaining value of the complete, aligned subtree of 2^height leafset chunks
+	/// that starts at chunk (index << height). Chaining values are cached until a byte they cover changes,
+	/// so Root() only has to rehash the chunks modified since it was last calculated.
+	/// </summary>
+	/// <param name="height">The height of the subtree. A height of 0 refers to a single chunk.</param>
+	/// <param name="index">The index of the subtree among all subtrees of the same height.</param>
+	/// <returns>The chaining value of the subtree.</returns>
+	virtual mw::Hash GetSubtreeCV(const uint8_t height, const uint64_t index) const;
+
 	virtual void ApplyUpdates(
 		const uint32_t file_index,
 		const mmr::LeafIndex& nextLeafIdx,
@@ -35,10 +47,21 @@ public:
 protected:
 	uint8_t BitToByte(const uint8_t bit) const;
 
+	// Must be called by implementations whenever the byte at byteIdx may have changed.
+	void MarkDirty(const uint64_t byteIdx);
+	void ClearSubtreeCVs();
+
 	ILeafSet(const mmr::LeafIndex& nextLeafIdx)
 		: m_nextLeafIdx(nextLeafIdx) { }
 
 	mmr::LeafIndex m_nextLeafIdx;
+
+private:
+	std::vector<uint8_t> GetBytes(const uint64_t byteIdx, const uint64_t numBytes) const;
+	void InvalidateDirtyChunks() const;
+
+	mutable std::unordered_set<uint64_t> m_dirtyChunks;
+	mutable std::unordered_map<uint64_t, mw::Hash> m_subtreeCVs;
 };
 
 class LeafSet : public ILeafSet
@@ -88,7 +111,14 @@ public:
 	) final;
 	void Flush(const uint32_t file_index);
 
+	mw::Hash GetSubtreeCV(const uint8_t height, const uint64_t index) const final;
+
 private:
+	void MarkModified(const uint64_t byteIdx);
+
 	ILeafSet::Ptr m_pBacked;
 	std::unordered_map<uint64_t, uint8_t> m_modifiedBytes;
+
+	// Chunks containing at least one byte that differs from m_pBacked.
+	std::set<uint64_t> m_modifiedChunks;
 };
\ No newline at end of file
@@ -31,6 +31,33 @@ public:
     mmr::LeafIndex Add(const std::vector<uint8_t>& data) { return AddLeaf(mmr::Leaf::Create(GetNextLeafIdx(), data)); }
     mmr::LeafIndex Add(const Traits::ISerializable& serializable) { return AddLeaf(mmr::Leaf::Create(GetNextLeafIdx(), serializable.Serialized())); }
 
+    //
+    // Appends consecutive leaves, starting at GetNextLeafIdx().
+    // Implementations hash all new parent nodes of the same height as one batch.
+    //
+    virtual void AddLeaves(const std::vector<mmr::Leaf>& leaves);
+
+    template <class T>
+    std::vector<mmr::LeafIndex> AddBatch(const std::vector<T>& serializables)
+    {
+        std::vector<std::vector<uint8_t>> data;
+        data.reserve(serializables.size());
+        for (const T& serializable : serializables) {
+            data.push_back(serializable.Serialized());
+        }
+
+        std::vector<mmr::Leaf> leaves = mmr::Leaf::CreateBatch(GetNextLeafIdx(), std::move(data));
+        AddLeaves(leaves);
+
+        std::vector<mmr::LeafIndex> leaf_indices;
+        leaf_indices.reserve(leaves.size());
+        for (const mmr::Leaf& leaf : leaves) {
+            leaf_indices.push_back(leaf.GetLeafIndex());
+        }
+
+        return leaf_indices;
+    }
+
     /// <summary>
     /// Retrieves the leaf at the given leaf index.
     /// </summary>
@@ -79,6 +106,13 @@ public:
     /// <returns>The root hash of the MMR.</returns>
     mw::Hash Root() const;
 
+    /// <summary>
+    /// Gets the hashes of the peaks (the roots of the perfect binary trees the MMR consists of), from left to right.
+    /// Together with the number of leaves, these are all that's needed to calculate the root and to append more leaves.
+    /// </summary>
+    /// <returns>The peak hashes, or an empty vector if the MMR has no leaves.</returns>
+    std::vector<mw::Hash> GetPeaks() const;
+
     /// <summary>
     /// Adds the given leaves to the MMR.
     /// This also updates the database and MMR files when the MMR is not a cache.
@@ -94,6 +128,10 @@ public:
         const std::vector<mmr::Leaf>& leaves,
         const std::unique_ptr<mw::DBBatch>& pBatch
     ) = 0;
+
+protected:
+    // Calculates the hashes of the leaves and all of the nodes added with them, in position order.
+    std::vector<mw::Hash> CalcNodeHashes(const std::vector<mmr::Leaf>& leaves) const;
 };
 
 /// <summary>
@@ -108,6 +146,7 @@ public:
     virtual ~MemMMR() = default;
 
     mmr::LeafIndex AddLeaf(const mmr::Leaf& leaf) final;
+    void AddLeaves(const std::vector<mmr::Leaf>& leaves) final;
     mmr::Leaf GetLeaf(const mmr::LeafIndex& leafIdx) const final;
     mw::Hash GetHash(const mmr::Index& idx) const final;
 
@@ -156,6 +195,7 @@ public:
     static FilePath GetPath(const FilePath& dir, const char prefix, const uint32_t file_index);
 
     mmr::LeafIndex AddLeaf(const mmr::Leaf& leaf) final;
+    void AddLeaves(const std::vector<mmr::Leaf>& leaves) final;
 
     mmr::Leaf GetLeaf(const mmr::LeafIndex& leafIdx) const final;
     mw::Hash GetHash(const mmr::Index& idx) const final;
@@ -193,6 +233,7 @@ public:
     virtual ~PMMRCache() = default;
 
     mmr::LeafIndex AddLeaf(const mmr::Leaf& leaf) final;
+    void AddLeaves(const std::vector<mmr::Leaf>& leaves) final;
 
     mmr::Leaf GetLeaf(const mmr::LeafIndex& leafIdx) const final;
     mmr::LeafIndex GetNextLeafIdx() const noexcept final;
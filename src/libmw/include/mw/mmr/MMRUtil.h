@@ -9,6 +9,13 @@ class MMRUtil
 public:
     static mw::Hash CalcParentHash(const mmr::Index& index, const mw::Hash& left_hash, const mw::Hash& right_hash);
 
+    // Batched CalcParentHash for parents that don't depend on each other, like the new nodes at a single height.
+    static std::vector<mw::Hash> CalcParentHashes(
+        const std::vector<mmr::Index>& indices,
+        const std::vector<mw::Hash>& left_hashes,
+        const std::vector<mw::Hash>& right_hashes
+    );
+
     static BitSet BuildCompactBitSet(const uint64_t num_leaves, const BitSet& unspent_leaf_indices);
     static BitSet DiffCompactBitSet(const BitSet& prev_compact, const BitSet& new_compact);
 
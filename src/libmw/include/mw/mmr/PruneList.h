@@ -4,6 +4,7 @@
 #include <mw/mmr/Index.h>
 #include <mw/mmr/LeafIndex.h>
 #include <mw/common/BitSet.h>
+#include <mw/common/RankSelectBitSet.h>
 #include <memory>
 
 class PruneList
@@ -22,10 +23,12 @@ public:
     void Commit(const uint32_t file_index, const BitSet& compacted);
 
 private:
-    PruneList(const FilePath& dir, BitSet&& compacted, uint64_t total_shift)
+    PruneList(const FilePath& dir, RankSelectBitSet&& compacted, uint64_t total_shift)
         : m_dir(dir), m_compacted(std::move(compacted)), m_totalShift(total_shift) { }
 
     FilePath m_dir;
-    BitSet m_compacted;
+
+    // Indexed for rank queries, since every PMMR hash lookup needs the shift of its position.
+    RankSelectBitSet m_compacted;
     uint64_t m_totalShift;
 };
\ No newline at end of file
@@ -75,7 +75,7 @@ public:
         READWRITE(obj.m_inputPubKey);
         READWRITE(obj.m_outputPubKey);
         READWRITE(obj.m_signature);
-        SER_READ(obj, obj.m_hash = Hashed(obj));
+        SER_READ(obj, if (!DeferredHashing::IsActive()) obj.m_hash = Hashed(obj));
     }
 
     //
@@ -84,6 +84,8 @@ public:
     const mw::Hash& GetHash() const noexcept final { return m_hash; } // MW: TODO - Can we remove this?
 
 private:
+    friend class TxBody;
+
     // The ID of the output being spent.
     mw::Hash m_outputID;
 
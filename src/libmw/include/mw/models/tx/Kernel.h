@@ -188,7 +188,9 @@ public:
 
         s >> m_excess >> m_signature;
 
-        m_hash = Hashed(*this);
+        if (!DeferredHashing::IsActive()) {
+            m_hash = Hashed(*this);
+        }
     }
 
     //
@@ -198,6 +200,8 @@ public:
     const Commitment& GetCommitment() const noexcept final { return m_excess; }
 
 private:
+    friend class TxBody;
+
     uint8_t m_features;
     boost::optional<CAmount> m_fee;
     boost::optional<CAmount> m_pegin;
@@ -184,7 +184,7 @@ public:
         READWRITE(obj.m_message);
         READWRITE(obj.m_pProof);
         READWRITE(obj.m_signature);
-        SER_READ(obj, obj.m_hash = obj.ComputeHash());
+        SER_READ(obj, if (!DeferredHashing::IsActive()) obj.m_hash = obj.ComputeHash());
     }
 
     //
@@ -193,24 +193,29 @@ public:
     const mw::Hash& GetHash() const noexcept final { return m_hash; }
 
 private:
+    friend class TxBody;
+
     //
     // Outputs use a special serialization when hashing that only includes
     // the hash of the rangeproof, instead of the full 675 byte rangeproof.
     // 
     // This will make some light client use cases more efficient.
     //
-    mw::Hash ComputeHash() const noexcept
+    std::vector<uint8_t> SerializeForHash() const noexcept
     {
-        return Hasher()
-            .Append(m_commitment)
-            .Append(m_senderPubKey)
-            .Append(m_receiverPubKey)
-            .Append(m_message.GetHash())
-            .Append(m_pProof->GetHash())
-            .Append(m_signature)
-            .hash();
+        std::vector<uint8_t> serialized;
+        CVectorWriter(SER_GETHASH, 0, serialized, 0)
+            << m_commitment
+            << m_senderPubKey
+            << m_receiverPubKey
+            << m_message.GetHash()
+            << m_pProof->GetHash()
+            << m_signature;
+        return serialized;
     }
 
+    mw::Hash ComputeHash() const noexcept { return Hashed(SerializeForHash()); }
+
     Commitment m_commitment;
     PublicKey m_senderPubKey;
     PublicKey m_receiverPubKey;
@@ -97,14 +97,31 @@ public:
     //
     // Serialization/Deserialization
     //
-    IMPL_SERIALIZABLE(TxBody, obj)
+    IMPL_SERIALIZED(TxBody);
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
     {
-        READWRITE(obj.m_inputs, obj.m_outputs, obj.m_kernels);
+        s << m_inputs << m_outputs << m_kernels;
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        {
+            DeferredHashing deferred;
+            s >> m_inputs >> m_outputs >> m_kernels;
+        }
+
+        ComputeHashes();
     }
 
     void Validate() const;
 
 private:
+    // Calculates the input, output, and kernel hashes that were deferred during deserialization.
+    void ComputeHashes();
+
     // List of inputs spent by the transaction.
     std::vector<Input> m_inputs;
 
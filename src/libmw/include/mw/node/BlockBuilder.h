@@ -5,6 +5,7 @@
 #include <mw/models/tx/PegInCoin.h>
 #include <mw/node/CoinsView.h>
 #include <memory>
+#include <vector>
 
 MW_NAMESPACE
 
@@ -20,17 +21,27 @@ public:
     /// <param name="view">The CoinsView representing the latest state of the active chain. Must not be null.</param>
     /// <returns>A non-null BlockBuilder</returns>
     BlockBuilder(const uint64_t height, const mw::ICoinsView::Ptr& pCoinsView)
-        : m_height(height), m_weight(0), m_pCoinsView(std::make_shared<mw::CoinsViewCache>(pCoinsView)), m_pAggregated(nullptr){ }
+        : m_height(height), m_weight(0), m_pCoinsView(std::make_shared<mw::CoinsViewCache>(pCoinsView)) { }
 
+    /// <summary>
+    /// Adds a transaction to the block, if it fits and its inputs are available.
+    /// The transaction is assumed to have been validated by the mempool already.
+    /// </summary>
+    /// <param name="pTransaction">The transaction to add. Must not be null.</param>
+    /// <param name="pegins">The pegins from the canonical transaction, which must match the tx's pegin kernels.</param>
+    /// <returns>True if the transaction was added.</returns>
     bool AddTransaction(const Transaction::CPtr& pTransaction, const std::vector<PegInCoin>& pegins);
 
+    /// <summary>
+    /// Aggregates the added transactions and builds the block on top of the coins view.
+    /// </summary>
     mw::Block::Ptr BuildBlock() const;
 
 private:
     uint64_t m_height;
     uint64_t m_weight;
     mw::CoinsViewCache::Ptr m_pCoinsView;
-    Transaction::CPtr m_pAggregated;
+    std::vector<Transaction::CPtr> m_transactions;
 };
 
 END_NAMESPACE // mw
\ No newline at end of file
@@ -9,7 +9,9 @@
 #include <mw/mmr/MMR.h>
 #include <mw/mmr/LeafSet.h>
 #include <mw/interfaces/db_interface.h>
+#include <future>
 #include <memory>
+#include <unordered_map>
 
 // Forward Declarations
 class CoinDB;
@@ -41,6 +43,14 @@ public:
 
     // Virtual functions
     virtual std::vector<UTXO::CPtr> GetUTXOs(const mw::Hash& output_id) const = 0;
+
+    /// <summary>
+    /// Looks up the UTXOs for many output IDs at once, so the database can be read in a single pass.
+    /// </summary>
+    /// <param name="output_ids">The output IDs of the UTXOs to look for.</param>
+    /// <returns>The UTXOs of each output ID that has any. Output IDs without UTXOs are omitted.</returns>
+    virtual std::unordered_map<mw::Hash, std::vector<UTXO::CPtr>> FetchUTXOs(const std::vector<mw::Hash>& output_ids) const = 0;
+
     virtual void WriteBatch(
         const mw::DBBatch::UPtr& pBatch,
         const CoinsViewUpdates& updates,
@@ -75,6 +85,37 @@ private:
     std::shared_ptr<mw::DBWrapper> m_pDatabase;
 };
 
+//
+// Looks up the coins spent by a block, checks its kernel sums, and hashes its new output leaves
+// on a background thread, so that the work overlaps with validating the rest of the block.
+// Neither the view it was started from nor any of that view's bases may be used until the
+// prefetch has been passed to CoinsViewCache::ApplyBlock or destroyed.
+//
+class BlockPrefetch
+{
+public:
+    using UPtr = std::unique_ptr<BlockPrefetch>;
+
+    BlockPrefetch(const ICoinsView::Ptr& pBase, const mw::Header::CPtr& pPrevHeader, const mw::Block::CPtr& pBlock);
+
+    // Waits for the background thread. Any validation failure it found is discarded.
+    ~BlockPrefetch();
+
+private:
+    friend class CoinsViewCache;
+
+    struct Result {
+        std::unordered_map<mw::Hash, std::vector<UTXO::CPtr>> spent_utxos;
+        std::vector<mmr::Leaf> output_leaves;
+    };
+
+    mw::Hash m_blockHash;
+    mw::Header::CPtr m_pPrevHeader;
+
+    // Invalid if the background thread could not be started.
+    std::future<Result> m_result;
+};
+
 class CoinsViewCache : public mw::ICoinsView
 {
 public:
@@ -86,6 +127,15 @@ public:
     bool IsCache() const noexcept final { return true; }
 
     std::vector<UTXO::CPtr> GetUTXOs(const mw::Hash& output_id) const noexcept final;
+    std::unordered_map<mw::Hash, std::vector<UTXO::CPtr>> FetchUTXOs(const std::vector<mw::Hash>& output_ids) const final;
+
+    /// <summary>
+    /// Starts looking up the coins spent by the block, and hashing its outputs, on a background thread.
+    /// This view must not be used again until the returned prefetch is passed to ApplyBlock or destroyed.
+    /// </summary>
+    /// <param name="pBlock">The block that will be connected next. Must not be null.</param>
+    /// <returns>The pending prefetch. Never null.</returns>
+    BlockPrefetch::UPtr PrefetchBlock(const mw::Block::CPtr& pBlock) const;
 
     /// <summary>
     /// Validates and connects the block to the end of the chain.
@@ -93,8 +143,9 @@ public:
     /// </summary>
     /// <pre>Block must be validated via CheckBlock before connecting it to the chain.</pre>
     /// <param name="pBlock">The block to connect. Must not be null.</param>
+    /// <param name="pPrefetch">The optional prefetch returned by PrefetchBlock, whose results are used if they still apply to this view.</param>
     /// <throws>ValidationException if consensus rules are not met.</throws>
-    mw::BlockUndo::CPtr ApplyBlock(const mw::Block::CPtr& pBlock);
+    mw::BlockUndo::CPtr ApplyBlock(const mw::Block::CPtr& pBlock, BlockPrefetch::UPtr pPrefetch = nullptr);
 
     /// <summary>
     /// Removes a block from the end of the chain.
@@ -123,16 +174,32 @@ public:
     ILeafSet::Ptr GetLeafSet() const noexcept final { return m_pLeafSet; }
     IMMR::Ptr GetOutputPMMR() const noexcept final { return m_pOutputPMMR; }
 
+    /// <summary>
+    /// Estimates the memory used by the UTXOs fetched from the base view and by the pending updates.
+    /// The owning CCoinsViewCache includes this in its usage, so it counts against -dbcache.
+    /// </summary>
+    size_t DynamicMemoryUsage() const noexcept;
+
 private:
-    void AddUTXO(const uint64_t header_height, const Output& output);
+    void AddUTXOs(const uint64_t header_height, const std::vector<Output>& outputs);
+    void AddUTXOs(const uint64_t header_height, const std::vector<Output>& outputs, const std::vector<mmr::Leaf>& leaves);
     UTXO SpendUTXO(const mw::Hash& output_id);
 
+    // Returns the UTXOs in the base view, caching them in m_baseUTXOs.
+    const std::vector<UTXO::CPtr>& GetBaseUTXOs(const mw::Hash& output_id) const;
+    void CacheBaseUTXOs(const mw::Hash& output_id, std::vector<UTXO::CPtr> utxos) const;
+
     ICoinsView::Ptr m_pBase;
 
     LeafSetCache::Ptr m_pLeafSet;
     PMMRCache::Ptr m_pOutputPMMR;
 
     std::shared_ptr<CoinsViewUpdates> m_pUpdates;
+
+    // UTXOs previously fetched from the base view, which m_pUpdates are applied on top of.
+    // Only output IDs that have UTXOs in the base are cached. Cleared when flushed to the base.
+    mutable std::unordered_map<mw::Hash, std::vector<UTXO::CPtr>> m_baseUTXOs;
+    mutable size_t m_baseUTXOsUsage;
 };
 
 class CoinsViewDB : public mw::ICoinsView
@@ -149,6 +216,7 @@ public:
     bool IsCache() const noexcept final { return false; }
 
     std::vector<UTXO::CPtr> GetUTXOs(const mw::Hash& output_id) const final;
+    std::unordered_map<mw::Hash, std::vector<UTXO::CPtr>> FetchUTXOs(const std::vector<mw::Hash>& output_ids) const final;
     void WriteBatch(
         const mw::DBBatch::UPtr& pBatch,
         const CoinsViewUpdates& updates,
@@ -4,7 +4,9 @@
 #include <mw/models/tx/Output.h>
 #include <mw/models/wallet/Coin.h>
 #include <mw/models/wallet/StealthAddress.h>
+#include <boost/optional.hpp>
 #include <memory>
+#include <vector>
 
 // Forward Declarations
 class ScriptPubKeyMan;
@@ -23,6 +25,13 @@ public:
 
     bool RewindOutput(const Output& output, mw::Coin& coin) const;
 
+    //
+    // Returns the indices of the outputs whose view tag matches the scan secret.
+    // Only these outputs can belong to the wallet, so only they need to be rewound.
+    // The ECDH for each output is spread across the CryptoCheckQueue worker threads.
+    //
+    std::vector<size_t> FilterOutputs(const std::vector<Output>& outputs) const;
+
     StealthAddress GetStealthAddress(const uint32_t index) const;
     SecretKey GetSpendKey(const uint32_t index) const;
 
@@ -30,6 +39,9 @@ public:
     const SecretKey& GetSpendSecret() const noexcept { return m_spendSecret; }
     
 private:
+    // Returns the shared secret if the output has a view tag and it matches, otherwise boost::none.
+    boost::optional<PublicKey> CalcSharedSecret(const Output& output) const;
+
     const ScriptPubKeyMan& m_spk_man;
     SecretKey m_scanSecret;
     SecretKey m_spendSecret;
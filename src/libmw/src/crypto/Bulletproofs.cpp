@@ -2,7 +2,8 @@
 #include "Context.h"
 #include "ConversionUtil.h"
 
-#include <caches/Cache.h>
+#include <mw/crypto/CryptoCheckQueue.h>
+#include <mw/crypto/VerificationCache.h>
 #include <mw/exceptions/CryptoException.h>
 #include <mw/util/VectorUtil.h>
 
@@ -11,63 +12,58 @@ static constexpr size_t SCRATCH_SPACE_SIZE = 256 * MAX_WIDTH;
 static constexpr size_t PROOF_LEN = 675;
 static constexpr size_t NUM_BITS_PROVEN = 64;
 
-static Locked<LRUCache<Commitment, ProofData>> CACHE(std::make_shared<LRUCache<Commitment, ProofData>>(3000));
 static Locked<Context> BP_CONTEXT(std::make_shared<Context>());
 
-bool Bulletproofs::BatchVerify(const std::vector<ProofData>& proofs)
+// Proofs are verified in sub-batches of at least this many, since each sub-batch pays for its own
+// multi-exponentiation, and smaller sub-batches would lose more to that than they gain from parallelism.
+static constexpr size_t MIN_PROOFS_PER_CHECK = 8;
+
+static bool VerifyProofs(const std::vector<ProofData>& proofs, const size_t begin, const size_t end)
 {
+    static thread_local ScratchSpace scratch(BP_CONTEXT.Read()->Get(), SCRATCH_SPACE_SIZE);
+
+    const size_t num_proofs = end - begin;
+
     std::vector<secp256k1_pedersen_commitment> secpCommitments;
-    secpCommitments.reserve(proofs.size());
+    secpCommitments.reserve(num_proofs);
 
     std::vector<const uint8_t*> bulletproofPointers;
-    bulletproofPointers.reserve(proofs.size());
+    bulletproofPointers.reserve(num_proofs);
 
     std::vector<const uint8_t*> extraData;
-    extraData.reserve(proofs.size());
+    extraData.reserve(num_proofs);
 
     std::vector<size_t> extraDataLen;
-    extraDataLen.reserve(proofs.size());
+    extraDataLen.reserve(num_proofs);
 
-    for (const auto& proof : proofs)
+    for (size_t i = begin; i < end; i++)
     {
-        auto cache_writer = CACHE.Write();
-        if (!cache_writer->Cached(proof.commitment) || proof != cache_writer->Get(proof.commitment)) {
-            secpCommitments.push_back(ConversionUtil::ToSecp256k1(proof.commitment));
-            bulletproofPointers.emplace_back(proof.pRangeProof->data());
-
-            if (!proof.extraData.empty()) {
-                extraData.push_back(proof.extraData.data());
-                extraDataLen.push_back(proof.extraData.size());
-            } else {
-                extraData.push_back(nullptr);
-                extraDataLen.push_back(0);
-            }
+        const ProofData& proof = proofs[i];
+        secpCommitments.push_back(ConversionUtil::ToSecp256k1(proof.commitment));
+        bulletproofPointers.emplace_back(proof.pRangeProof->data());
+
+        if (!proof.extraData.empty()) {
+            extraData.push_back(proof.extraData.data());
+            extraDataLen.push_back(proof.extraData.size());
+        } else {
+            extraData.push_back(nullptr);
+            extraDataLen.push_back(0);
         }
     }
 
-    if (secpCommitments.empty()) {
-        return true;
-    }
-
     // array of generator multiplied by value in pedersen commitments (cannot be NULL)
-    std::vector<secp256k1_generator> valueGenerators;
-    for (size_t i = 0; i < secpCommitments.size(); i++)
-    {
-        valueGenerators.push_back(secp256k1_generator_const_h);
-    }
+    std::vector<secp256k1_generator> valueGenerators(num_proofs, secp256k1_generator_const_h);
 
     std::vector<secp256k1_pedersen_commitment*> commitmentPointers = VectorUtil::ToPointerVec(secpCommitments);
 
-    secp256k1_scratch_space* pScratchSpace = secp256k1_scratch_space_create(
-        BP_CONTEXT.Read()->Get(),
-        SCRATCH_SPACE_SIZE
-    );
+    // Verification only reads from the context, so the threads share it.
+    auto pContext = BP_CONTEXT.Read();
     const int result = secp256k1_bulletproof_rangeproof_verify_multi(
-        BP_CONTEXT.Read()->Get(),
-        pScratchSpace,
-        BP_CONTEXT.Read()->GetGenerators(),
+        pContext->Get(),
+        scratch.Get(),
+        pContext->GetGenerators(),
         bulletproofPointers.data(),
-        secpCommitments.size(),
+        num_proofs,
         PROOF_LEN,
         NULL,
         commitmentPointers.data(),
@@ -77,17 +73,54 @@ bool Bulletproofs::BatchVerify(const std::vector<ProofData>& proofs)
         extraData.data(),
         extraDataLen.data()
     );
-    secp256k1_scratch_space_destroy(pScratchSpace);
 
-    if (result == 1) {
-        auto cache_writer = CACHE.Write();
-        for (const auto& proof : proofs)
-        {
-            cache_writer->Put(proof.commitment, proof);
+    return result == 1;
+}
+
+bool Bulletproofs::BatchVerify(const std::vector<ProofData>& proofs)
+{
+    std::vector<ProofData> unverified;
+    for (const auto& proof : proofs)
+    {
+        if (!VerificationCache::Contains(proof)) {
+            unverified.push_back(proof);
         }
     }
 
-    return result == 1;
+    if (unverified.empty()) {
+        return true;
+    }
+
+    if (!BatchVerifyUncached(unverified)) {
+        return false;
+    }
+
+    for (const auto& proof : unverified)
+    {
+        VerificationCache::Insert(proof);
+    }
+
+    return true;
+}
+
+bool Bulletproofs::BatchVerifyUncached(const std::vector<ProofData>& proofs)
+{
+    if (proofs.empty()) {
+        return true;
+    }
+
+    // Split the proofs evenly across the available threads.
+    const size_t max_checks = (proofs.size() + MIN_PROOFS_PER_CHECK - 1) / MIN_PROOFS_PER_CHECK;
+    const size_t num_checks = std::min(CryptoCheckQueue::NumThreads(), max_checks);
+    const size_t proofs_per_check = (proofs.size() + num_checks - 1) / num_checks;
+
+    std::vector<CryptoCheck> checks;
+    for (size_t begin = 0; begin < proofs.size(); begin += proofs_per_check) {
+        const size_t end = std::min(begin + proofs_per_check, proofs.size());
+        checks.emplace_back([&proofs, begin, end]() { return VerifyProofs(proofs, begin, end); });
+    }
+
+    return CryptoCheckQueue::Run(checks);
 }
 
 RangeProof::CPtr Bulletproofs::Generate(
@@ -39,4 +39,23 @@ public:
 private:
     secp256k1_context* m_pContext;
     secp256k1_bulletproof_generators* m_pGenerators;
+};
+
+//
+// Scratch space for batch verification, meant to be created once per thread and reused by every batch verified on it.
+// Frames are allocated from it as needed, so it only holds memory while a batch is being verified.
+//
+class ScratchSpace
+{
+public:
+    ScratchSpace(const secp256k1_context* pContext, const size_t max_size)
+        : m_pScratch(secp256k1_scratch_space_create(pContext, max_size)) { }
+    ScratchSpace(const ScratchSpace&) = delete;
+    ScratchSpace& operator=(const ScratchSpace&) = delete;
+    ~ScratchSpace() { secp256k1_scratch_space_destroy(m_pScratch); }
+
+    secp256k1_scratch_space* Get() noexcept { return m_pScratch; }
+
+private:
+    secp256k1_scratch_space* m_pScratch;
 };
\ No newline at end of file
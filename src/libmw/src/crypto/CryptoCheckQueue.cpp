@@ -0,0 +1,42 @@
+#include <mw/crypto/CryptoCheckQueue.h>
+
+#include <checkqueue.h>
+#include <util/threadnames.h>
+#include <tinyformat.h>
+
+#include <algorithm>
+#include <atomic>
+
+// Each check is already a sub-batch sized for one thread, so workers take them one at a time.
+static CCheckQueue<CryptoCheck> QUEUE(1);
+static std::atomic<size_t> NUM_WORKERS(0);
+
+void CryptoCheckQueue::Thread(const int worker_num)
+{
+    util::ThreadRename(strprintf("mwebch.%i", worker_num));
+
+    // The worker stops counting towards NumThreads() once interrupted.
+    struct WorkerCounter {
+        WorkerCounter() { NUM_WORKERS++; }
+        ~WorkerCounter() { NUM_WORKERS--; }
+    } counter;
+
+    QUEUE.Thread();
+}
+
+size_t CryptoCheckQueue::NumThreads() noexcept
+{
+    return NUM_WORKERS + 1;
+}
+
+bool CryptoCheckQueue::Run(std::vector<CryptoCheck>& checks)
+{
+    if (checks.size() <= 1 || NUM_WORKERS == 0) {
+        return std::all_of(checks.begin(), checks.end(), [](CryptoCheck& check) { return check(); });
+    }
+
+    // The calling thread joins the workers until the queue is drained.
+    CCheckQueueControl<CryptoCheck> control(&QUEUE);
+    control.Add(checks);
+    return control.Wait();
+}
@@ -1,15 +1,77 @@
+#if defined(HAVE_CONFIG_H)
+#include <config/bitcoin-config.h>
+#endif
+
 #include <mw/crypto/Hasher.h>
 
+#include <map>
+
+// The SIMD backends are built into their own libraries (see crypto/blake3_*.cpp),
+// and blake3_dispatch.c picks between them at runtime based on CPUID.
+#if !defined(ENABLE_AVX512) || defined(BUILD_BITCOIN_INTERNAL)
 #define BLAKE3_NO_AVX512 1
+#endif
+#if !defined(ENABLE_AVX2) || defined(BUILD_BITCOIN_INTERNAL)
 #define BLAKE3_NO_AVX2 1
+#endif
+#if !defined(ENABLE_SSE41) || defined(BUILD_BITCOIN_INTERNAL)
 #define BLAKE3_NO_SSE41 1
+#endif
+#if !defined(ENABLE_SSE2) || defined(BUILD_BITCOIN_INTERNAL)
 #define BLAKE3_NO_SSE2 1
+#endif
 extern "C" {
 #include <crypto/blake3/blake3.c>
 #include <crypto/blake3/blake3_dispatch.c>
 #include <crypto/blake3/blake3_portable.c>
 }
 
+namespace {
+
+bool SelfTest()
+{
+    // 16 chunks of the official BLAKE3 test vector input, so every lane of the widest backend is used.
+    std::vector<uint8_t> input(16 * BLAKE3_CHUNK_LEN);
+    for (size_t i = 0; i < input.size(); i++) {
+        input[i] = (uint8_t)(i % 251);
+    }
+
+    static const uint8_t expected[32] = {
+        0xf8, 0x75, 0xd6, 0x64, 0x6d, 0xe2, 0x89, 0x85, 0x64, 0x6f, 0x34, 0xee, 0x13, 0xbe, 0x9a, 0x57,
+        0x6f, 0xd5, 0x15, 0xf7, 0x6b, 0x5b, 0x0a, 0x26, 0xbb, 0x32, 0x47, 0x35, 0x04, 0x1d, 0xdd, 0xe4
+    };
+
+    return memcmp(Hashed(input).data(), expected, sizeof(expected)) == 0;
+}
+
+} // namespace
+
+std::string Blake3AutoDetect()
+{
+    std::string ret = "portable";
+#if defined(IS_X86)
+    const int features = get_cpu_features();
+    (void)features;
+#if !defined(BLAKE3_NO_SSE2)
+    if (features & SSE2) ret = "sse2";
+#endif
+#if !defined(BLAKE3_NO_SSE41)
+    if (features & SSE41) ret = "sse41";
+#endif
+#if !defined(BLAKE3_NO_AVX2)
+    if (features & AVX2) ret = "avx2";
+#endif
+#if !defined(BLAKE3_NO_AVX512)
+    if ((features & (AVX512F | AVX512VL)) == (AVX512F | AVX512VL)) ret = "avx512";
+#endif
+#endif
+
+    ret += "(" + std::to_string(blake3_simd_degree()) + "way)";
+
+    assert(SelfTest());
+    return ret;
+}
+
 mw::Hash Hashed(const std::vector<uint8_t>& serialized)
 {
     Hasher hasher;
@@ -20,4 +82,106 @@ mw::Hash Hashed(const std::vector<uint8_t>& serialized)
 mw::Hash Hashed(const Traits::ISerializable& serializable)
 {
     return Hashed(serializable.Serialized());
+}
+
+std::vector<mw::Hash> BatchHashed(const std::vector<std::vector<uint8_t>>& messages)
+{
+    std::vector<mw::Hash> hashes(messages.size());
+
+    // Group the single-chunk messages by the number of blocks that precede their final block.
+    std::map<size_t, std::vector<size_t>> groups;
+    for (size_t i = 0; i < messages.size(); i++) {
+        const size_t len = messages[i].size();
+        if (len > BLAKE3_CHUNK_LEN) {
+            hashes[i] = Hashed(messages[i]);
+        } else {
+            groups[len == 0 ? 0 : (len - 1) / BLAKE3_BLOCK_LEN].push_back(i);
+        }
+    }
+
+    std::vector<const uint8_t*> inputs;
+    std::vector<uint8_t> cvs;
+    for (const auto& group : groups) {
+        const size_t num_blocks = group.first;
+        const std::vector<size_t>& indices = group.second;
+
+        // blake3_hash_many only handles full blocks, so it compresses everything but the final block.
+        if (num_blocks > 0) {
+            inputs.clear();
+            for (const size_t idx : indices) {
+                inputs.push_back(messages[idx].data());
+            }
+
+            cvs.resize(indices.size() * BLAKE3_OUT_LEN);
+            blake3_hash_many(inputs.data(), inputs.size(), num_blocks, IV, 0, false, 0, CHUNK_START, 0, cvs.data());
+        }
+
+        for (size_t j = 0; j < indices.size(); j++) {
+            const std::vector<uint8_t>& message = messages[indices[j]];
+
+            uint32_t cv[8];
+            if (num_blocks > 0) {
+                load_key_words(cvs.data() + (j * BLAKE3_OUT_LEN), cv);
+            } else {
+                memcpy(cv, IV, BLAKE3_KEY_LEN);
+            }
+
+            const size_t offset = num_blocks * BLAKE3_BLOCK_LEN;
+            uint8_t block[BLAKE3_BLOCK_LEN] = {0};
+            if (message.size() > offset) {
+                memcpy(block, message.data() + offset, message.size() - offset);
+            }
+
+            uint8_t flags = CHUNK_END | ROOT;
+            if (num_blocks == 0) {
+                flags |= CHUNK_START;
+            }
+
+            blake3_compress_in_place(cv, block, (uint8_t)(message.size() - offset), 0, flags);
+            store_cv_words(hashes[indices[j]].data(), cv);
+        }
+    }
+
+    return hashes;
+}
+
+thread_local bool DeferredHashing::s_active = false;
+
+mw::Hash Blake3Tree::ChunkCV(const uint8_t* input, const size_t len, const uint64_t chunk_counter)
+{
+    assert(len <= CHUNK_LEN);
+
+    blake3_chunk_state state;
+    chunk_state_init(&state, IV, 0);
+    state.chunk_counter = chunk_counter;
+    chunk_state_update(&state, input, len);
+
+    output_t output = chunk_state_output(&state);
+    mw::Hash cv;
+    output_chaining_value(&output, cv.data());
+    return cv;
+}
+
+mw::Hash Blake3Tree::ParentCV(const mw::Hash& left_cv, const mw::Hash& right_cv)
+{
+    uint8_t block[BLAKE3_BLOCK_LEN];
+    memcpy(block, left_cv.data(), BLAKE3_OUT_LEN);
+    memcpy(block + BLAKE3_OUT_LEN, right_cv.data(), BLAKE3_OUT_LEN);
+
+    output_t output = parent_output(block, IV, 0);
+    mw::Hash cv;
+    output_chaining_value(&output, cv.data());
+    return cv;
+}
+
+mw::Hash Blake3Tree::ParentRoot(const mw::Hash& left_cv, const mw::Hash& right_cv)
+{
+    uint8_t block[BLAKE3_BLOCK_LEN];
+    memcpy(block, left_cv.data(), BLAKE3_OUT_LEN);
+    memcpy(block + BLAKE3_OUT_LEN, right_cv.data(), BLAKE3_OUT_LEN);
+
+    output_t output = parent_output(block, IV, 0);
+    mw::Hash root;
+    output_root_bytes(&output, 0, root.data(), root.size());
+    return root;
 }
\ No newline at end of file
@@ -2,17 +2,21 @@
 #include "Context.h"
 #include "ConversionUtil.h"
 
-#include <caches/Cache.h>
 #include <mw/common/Logger.h>
+#include <mw/crypto/CryptoCheckQueue.h>
+#include <mw/crypto/VerificationCache.h>
 #include <mw/exceptions/CryptoException.h>
 #include <mw/util/VectorUtil.h>
 
-static Locked<LRUCache<SignedMessage, bool>> CACHE(std::make_shared<LRUCache<SignedMessage, bool>>(3000));
 static Locked<Context> SCHNORR_CONTEXT(std::make_shared<Context>());
 
 static constexpr uint64_t MAX_WIDTH = 1 << 20;
 static constexpr size_t SCRATCH_SPACE_SIZE = 256 * MAX_WIDTH;
 
+// Signatures are verified in sub-batches of at least this many, since each sub-batch pays for its own
+// multi-exponentiation, and smaller sub-batches would lose more to that than they gain from parallelism.
+static constexpr size_t MIN_SIGNATURES_PER_CHECK = 16;
+
 Signature Schnorr::Sign(
     const uint8_t* secretKey,
     const mw::Hash& message)
@@ -50,7 +54,7 @@ bool Schnorr::Verify(
     const mw::Hash& message)
 {
     SignedMessage signed_message(message, sumPubKeys, signature);
-    if (CACHE.Write()->Cached(signed_message)) {
+    if (VerificationCache::Contains(signed_message)) {
         return true;
     }
 
@@ -67,56 +71,82 @@ bool Schnorr::Verify(
         false
     );
     if (verifyResult == 1) {
-        CACHE.Write()->Put(signed_message, true);
+        VerificationCache::Insert(signed_message);
     }
 
     return verifyResult == 1;
 }
 
-bool Schnorr::BatchVerify(const std::vector<SignedMessage>& signatures)
+static bool VerifySignatures(const std::vector<SignedMessage>& signatures, const size_t begin, const size_t end)
 {
-    std::vector<SignedMessage> unverified_messages;
+    const size_t num_signatures = end - begin;
+
     std::vector<secp256k1_pubkey> parsedPubKeys;
+    parsedPubKeys.reserve(num_signatures);
+
     std::vector<secp256k1_schnorrsig> parsedSignatures;
-    std::vector<const uint8_t*> messageData;
+    parsedSignatures.reserve(num_signatures);
 
-    for (const SignedMessage& signed_message : signatures) {
-        if (CACHE.Write()->Cached(signed_message)) {
-            continue;
-        }
+    std::vector<const uint8_t*> messageData;
+    messageData.reserve(num_signatures);
 
-        unverified_messages.push_back(signed_message);
+    for (size_t i = begin; i < end; i++) {
+        const SignedMessage& signed_message = signatures[i];
         parsedPubKeys.push_back(ConversionUtil::ToSecp256k1(signed_message.GetPublicKey()));
         parsedSignatures.push_back(ConversionUtil::ToSecp256k1(signed_message.GetSignature()));
         messageData.push_back(signed_message.GetMsgHash().data());
     }
 
-    if (unverified_messages.empty()) {
-        return true;
-    }
-
     std::vector<secp256k1_pubkey*> pubKeyPtrs = VectorUtil::ToPointerVec(parsedPubKeys);
     std::vector<secp256k1_schnorrsig*> signaturePtrs = VectorUtil::ToPointerVec(parsedSignatures);
 
-    secp256k1_scratch_space* pScratchSpace = secp256k1_scratch_space_create(
-        SCHNORR_CONTEXT.Read()->Get(),
-        SCRATCH_SPACE_SIZE
-    );
+    // Verification only reads from the context, so the threads share it.
+    // Each thread reuses its own scratch space.
+    auto pContext = SCHNORR_CONTEXT.Read();
+    static thread_local ScratchSpace scratch(pContext->Get(), SCRATCH_SPACE_SIZE);
     const int verifyResult = secp256k1_schnorrsig_verify_batch(
-        SCHNORR_CONTEXT.Read()->Get(),
-        pScratchSpace,
+        pContext->Get(),
+        scratch.Get(),
         signaturePtrs.data(),
         messageData.data(),
         pubKeyPtrs.data(),
-        unverified_messages.size()
+        num_signatures
     );
-    secp256k1_scratch_space_destroy(pScratchSpace);
 
-    if (verifyResult == 1) {
-        for (const SignedMessage& message : unverified_messages) {
-            CACHE.Write()->Put(message, true);
+    return verifyResult == 1;
+}
+
+bool Schnorr::BatchVerify(const std::vector<SignedMessage>& signatures)
+{
+    std::vector<SignedMessage> unverified_messages;
+    for (const SignedMessage& signed_message : signatures) {
+        if (!VerificationCache::Contains(signed_message)) {
+            unverified_messages.push_back(signed_message);
         }
     }
 
-    return verifyResult == 1;
-}
\ No newline at end of file
+    if (unverified_messages.empty()) {
+        return true;
+    }
+
+    // Split the signatures evenly across the available threads.
+    const size_t max_checks = (unverified_messages.size() + MIN_SIGNATURES_PER_CHECK - 1) / MIN_SIGNATURES_PER_CHECK;
+    const size_t num_checks = std::min(CryptoCheckQueue::NumThreads(), max_checks);
+    const size_t signatures_per_check = (unverified_messages.size() + num_checks - 1) / num_checks;
+
+    std::vector<CryptoCheck> checks;
+    for (size_t begin = 0; begin < unverified_messages.size(); begin += signatures_per_check) {
+        const size_t end = std::min(begin + signatures_per_check, unverified_messages.size());
+        checks.emplace_back([&unverified_messages, begin, end]() { return VerifySignatures(unverified_messages, begin, end); });
+    }
+
+    if (!CryptoCheckQueue::Run(checks)) {
+        return false;
+    }
+
+    for (const SignedMessage& message : unverified_messages) {
+        VerificationCache::Insert(message);
+    }
+
+    return true;
+}
@@ -0,0 +1,140 @@
+#include <mw/crypto/VerificationCache.h>
+#include <mw/common/Logger.h>
+#include <mw/crypto/Hasher.h>
+
+#include <cuckoocache.h>
+#include <random.h>
+#include <script/sigcache.h>
+#include <uint256.h>
+
+#include <boost/thread/shared_mutex.hpp>
+
+#include <array>
+
+static constexpr size_t NUM_SHARDS = 16;
+
+class CacheShard
+{
+public:
+    CacheShard() { m_cache.setup(0); }
+
+    bool Contains(const uint256& entry)
+    {
+        boost::shared_lock<boost::shared_mutex> lock(m_mutex);
+        return m_cache.contains(entry, false);
+    }
+
+    void Insert(const uint256& entry)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(m_mutex);
+        m_cache.insert(entry);
+    }
+
+    size_t SetupBytes(const size_t bytes)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(m_mutex);
+        return m_cache.setup_bytes(bytes);
+    }
+
+private:
+    CuckooCache::cache<uint256, SignatureCacheHasher> m_cache;
+    boost::shared_mutex m_mutex;
+};
+
+class Cache
+{
+public:
+    Cache()
+    {
+        // Entries are salted, so an attacker can't craft signatures or proofs
+        // whose entries collide in the cache and evict each other.
+        m_salted_hasher << GetRandHash();
+    }
+
+    uint256 SignatureEntry(const SignedMessage& signed_message) const
+    {
+        Hasher hasher = m_salted_hasher;
+        hasher << uint8_t('S') << signed_message;
+        return ToEntry(hasher.hash());
+    }
+
+    uint256 ProofEntry(const ProofData& proof) const
+    {
+        Hasher hasher = m_salted_hasher;
+        hasher << uint8_t('P') << proof.commitment << proof.pRangeProof->vec() << proof.extraData;
+        return ToEntry(hasher.hash());
+    }
+
+    CacheShard& GetShard(const uint256& entry)
+    {
+        // Every byte of the entry feeds one of the cuckoo hashes, so the shard is picked by
+        // xor-ing all of them, which leaves each hash uniformly distributed within a shard.
+        uint8_t shard = 0;
+        for (const uint8_t byte : entry) {
+            shard ^= byte;
+        }
+
+        return m_shards[shard % NUM_SHARDS];
+    }
+
+    size_t SetupBytes(const size_t bytes)
+    {
+        size_t num_elements = 0;
+        for (CacheShard& shard : m_shards) {
+            num_elements += shard.SetupBytes(bytes / NUM_SHARDS);
+        }
+
+        return num_elements;
+    }
+
+private:
+    static uint256 ToEntry(const mw::Hash& hash)
+    {
+        uint256 entry;
+        memcpy(entry.begin(), hash.data(), entry.size());
+        return entry;
+    }
+
+    Hasher m_salted_hasher;
+    std::array<CacheShard, NUM_SHARDS> m_shards;
+};
+
+static Cache CACHE;
+
+size_t VerificationCache::Init(const int64_t max_size_mib)
+{
+    const size_t max_bytes = std::min(std::max(max_size_mib, (int64_t)0), MAX_MWEB_SIG_CACHE_SIZE) * ((size_t)1 << 20);
+    const size_t num_elements = CACHE.SetupBytes(max_bytes);
+    LOG_INFO_F(
+        "Using {} MiB out of {} requested for MWEB signature and proof cache, able to store {} elements",
+        (num_elements * sizeof(uint256)) >> 20,
+        max_bytes >> 20,
+        num_elements
+    );
+
+    return num_elements;
+}
+
+bool VerificationCache::Contains(const SignedMessage& signed_message)
+{
+    const uint256 entry = CACHE.SignatureEntry(signed_message);
+    return CACHE.GetShard(entry).Contains(entry);
+}
+
+void VerificationCache::Insert(const SignedMessage& signed_message)
+{
+    const uint256 entry = CACHE.SignatureEntry(signed_message);
+    CACHE.GetShard(entry).Insert(entry);
+}
+
+bool VerificationCache::Contains(const ProofData& proof)
+{
+    const uint256 entry = CACHE.ProofEntry(proof);
+    return CACHE.GetShard(entry).Contains(entry);
+}
+
+void VerificationCache::Insert(const ProofData& proof)
+{
+    const uint256 entry = CACHE.ProofEntry(proof);
+    CACHE.GetShard(entry).Insert(entry);
+}
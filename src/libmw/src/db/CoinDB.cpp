@@ -1,10 +1,64 @@
 #include <mw/db/CoinDB.h>
+#include <mw/common/Logger.h>
 #include "common/Database.h"
 
+#include <algorithm>
+
 static const DBTable UTXO_TABLE = { 'U' };
 
+// Number of UTXOs rewritten per batch when migrating from hex-encoded keys.
+static constexpr size_t MIGRATION_BATCH_SIZE = 10'000;
+
+// UTXOs are keyed by the raw 32-byte output ID.
+// Older versions used the 64 character hex encoding instead.
+static std::string ToKey(const mw::Hash& output_id)
+{
+    return std::string(output_id.data(), output_id.data() + output_id.size());
+}
+
+UTXOCursor::UTXOCursor(std::unique_ptr<mw::DBIterator>&& pIterator)
+    : m_pIterator(std::move(pIterator))
+{
+    m_pIterator->Seek(UTXO_TABLE.BuildKey(""));
+    SkipLegacyKeys();
+}
+
+bool UTXOCursor::Valid() const
+{
+    std::string key;
+    return m_pIterator->Valid() && m_pIterator->GetKey(key) && !key.empty() && key.front() == UTXO_TABLE.GetPrefix();
+}
+
+void UTXOCursor::Next()
+{
+    m_pIterator->Next();
+    SkipLegacyKeys();
+}
+
+UTXO::CPtr UTXOCursor::GetUTXO() const
+{
+    std::vector<uint8_t> value;
+    if (!m_pIterator->GetValue(value)) {
+        return nullptr;
+    }
+
+    auto pUTXO = std::make_shared<UTXO>();
+    CDataStream(value, SER_DISK, PROTOCOL_VERSION) >> *pUTXO;
+    return pUTXO;
+}
+
+// Hex-encoded keys are only left over if MigrateHexKeys() was interrupted.
+// Their UTXOs are migrated on the next startup, so they're skipped here.
+void UTXOCursor::SkipLegacyKeys()
+{
+    std::string key;
+    while (Valid() && m_pIterator->GetKey(key) && key.size() != mw::Hash::size() + 1) {
+        m_pIterator->Next();
+    }
+}
+
 CoinDB::CoinDB(mw::DBWrapper* pDBWrapper, mw::DBBatch* pBatch)
-    : m_pDatabase(std::make_unique<Database>(pDBWrapper, pBatch)) { }
+    : m_pDBWrapper(pDBWrapper), m_pDatabase(std::make_unique<Database>(pDBWrapper, pBatch)) { }
 
 CoinDB::~CoinDB() { }
 
@@ -12,8 +66,13 @@ std::unordered_map<mw::Hash, UTXO::CPtr> CoinDB::GetUTXOs(const std::vector<mw::
 {
     std::unordered_map<mw::Hash, UTXO::CPtr> utxos;
 
-    for (const mw::Hash& output_id : output_ids) {
-        auto pUTXO = m_pDatabase->Get<UTXO>(UTXO_TABLE, output_id.ToHex());
+    // LevelDB has no multi-get, but looking the keys up in order
+    // keeps consecutive reads within the same blocks and files.
+    std::vector<mw::Hash> sorted_ids = output_ids;
+    std::sort(sorted_ids.begin(), sorted_ids.end());
+
+    for (const mw::Hash& output_id : sorted_ids) {
+        auto pUTXO = m_pDatabase->Get<UTXO>(UTXO_TABLE, ToKey(output_id));
         if (pUTXO != nullptr) {
             utxos.insert({output_id, pUTXO->item});
         }
@@ -28,7 +87,7 @@ void CoinDB::AddUTXOs(const std::vector<UTXO::CPtr>& utxos)
     std::transform(
         utxos.cbegin(), utxos.cend(),
         std::back_inserter(entries),
-        [](const UTXO::CPtr& pUTXO) { return DBEntry<UTXO>(pUTXO->GetOutputID().ToHex(), pUTXO); }
+        [](const UTXO::CPtr& pUTXO) { return DBEntry<UTXO>(ToKey(pUTXO->GetOutputID()), pUTXO); }
     );
 
     m_pDatabase->Put(UTXO_TABLE, entries);
@@ -37,11 +96,65 @@ void CoinDB::AddUTXOs(const std::vector<UTXO::CPtr>& utxos)
 void CoinDB::RemoveUTXOs(const std::vector<mw::Hash>& output_ids)
 {
     for (const mw::Hash& output_id : output_ids) {
-        m_pDatabase->Delete(UTXO_TABLE, output_id.ToHex());
+        m_pDatabase->Delete(UTXO_TABLE, ToKey(output_id));
     }
 }
 
 void CoinDB::RemoveAllUTXOs()
 {
     m_pDatabase->DeleteAll(UTXO_TABLE);
-}
\ No newline at end of file
+}
+
+UTXOCursor::UPtr CoinDB::NewCursor() const
+{
+    return std::make_unique<UTXOCursor>(m_pDBWrapper->NewIterator());
+}
+
+size_t CoinDB::MigrateHexKeys()
+{
+    if (!m_pDBWrapper) {
+        return 0;
+    }
+
+    // Hex keys all share the same length, and hex digits sort after '0',
+    // so every legacy key sorts at or after this one.
+    const std::string first_hex_key = UTXO_TABLE.BuildKey(std::string(mw::Hash::size() * 2, '0'));
+
+    size_t num_migrated = 0;
+    while (true) {
+        std::vector<std::string> hex_keys;
+
+        auto pIter = m_pDBWrapper->NewIterator();
+        pIter->Seek(first_hex_key);
+        while (pIter->Valid() && hex_keys.size() < MIGRATION_BATCH_SIZE) {
+            std::string key;
+            if (!pIter->GetKey(key) || key.size() != first_hex_key.size() || key.front() != UTXO_TABLE.GetPrefix()) {
+                break;
+            }
+
+            hex_keys.push_back(std::move(key));
+            pIter->Next();
+        }
+
+        if (hex_keys.empty()) {
+            break;
+        }
+
+        auto pBatch = m_pDBWrapper->CreateBatch();
+        for (const std::string& hex_key : hex_keys) {
+            std::vector<uint8_t> value;
+            if (m_pDBWrapper->Read(hex_key, value)) {
+                const mw::Hash output_id = mw::Hash::FromHex(hex_key.substr(1));
+                pBatch->Write(UTXO_TABLE.BuildKey(ToKey(output_id)), value);
+            }
+
+            pBatch->Erase(hex_key);
+        }
+
+        pBatch->Commit();
+        num_migrated += hex_keys.size();
+        LOG_INFO_F("Migrated {} MWEB UTXOs to binary keys", num_migrated);
+    }
+
+    return num_migrated;
+}
@@ -113,7 +113,11 @@ void File::Write(const std::vector<uint8_t>& bytes)
 void File::Write(const size_t startIndex, const std::vector<uint8_t>& bytes, const bool truncate)
 {
     if (!bytes.empty()) {
-        std::fstream file(m_path.m_path, std::ios::out | std::ios::binary | std::ios::app);
+        if (!Exists()) {
+            Create();
+        }
+
+        std::fstream file(m_path.m_path, std::ios::in | std::ios::out | std::ios::binary);
         if (!file.is_open()) {
             ThrowFile_F("Failed to write to file: {}", m_path);
         }
@@ -166,4 +170,25 @@ void File::CopyTo(const FilePath& new_path) const
     if (ec) {
         ThrowFile_F("Failed to copy {} to {}", m_path, new_path);
     }
-}
\ No newline at end of file
+}
+void File::Rename(const FilePath& new_path)
+{
+    std::error_code ec;
+    ghc::filesystem::rename(m_path.m_path, new_path.m_path, ec);
+    if (ec) {
+        ThrowFile_F("Failed to rename {} to {}", m_path, new_path);
+    }
+
+    m_path = new_path;
+}
+
+bool File::HardLinkTo(const FilePath& new_path) const
+{
+    if (new_path.Exists()) {
+        new_path.Remove();
+    }
+
+    std::error_code ec;
+    ghc::filesystem::create_hard_link(m_path.m_path, new_path.m_path, ec);
+    return !ec;
+}
@@ -0,0 +1,88 @@
+#include <mw/file/FileJournal.h>
+#include <mw/common/Logger.h>
+
+void FileUndo::AddRange(const uint64_t offset, std::vector<uint8_t>&& bytes)
+{
+    if (!ranges.empty() && ranges.back().offset + ranges.back().bytes.size() == offset) {
+        ranges.back().bytes.insert(ranges.back().bytes.end(), bytes.cbegin(), bytes.cend());
+    } else {
+        ranges.push_back(Range{ offset, std::move(bytes) });
+    }
+}
+
+void FileUndo::Apply(File& file) const
+{
+    for (const Range& range : ranges) {
+        file.Write(range.offset, range.bytes, false);
+    }
+
+    file.Truncate(size);
+}
+
+File FileJournal::Snapshot(const File& file, const FilePath& new_path, const FileUndo& undo)
+{
+    if (file.GetPath() == new_path) {
+        return file;
+    }
+
+    if (new_path.Exists()) {
+        new_path.Remove();
+    }
+
+    // The journal must be complete before the shared file is touched,
+    // so it's written to a temporary file and then renamed.
+    FilePath undo_path = GetUndoPath(new_path);
+    FilePath tmp_path = new_path.ReplaceExtension(".tmp");
+    tmp_path.Remove();
+
+    File tmp_file(tmp_path);
+    tmp_file.Write(undo.Serialized());
+    tmp_file.Rename(undo_path);
+
+    if (!file.HardLinkTo(new_path)) {
+        LOG_WARNING_F("Failed to link {} to {}. Copying instead.", file, new_path);
+        undo_path.Remove();
+        file.CopyTo(new_path);
+    }
+
+    return File(new_path);
+}
+
+void FileJournal::Recover(const PathFn& get_path, const uint32_t file_index)
+{
+    uint32_t latest_index = file_index;
+    while (get_path(latest_index + 1).Exists() || GetUndoPath(get_path(latest_index + 1)).Exists()) {
+        ++latest_index;
+    }
+
+    File file(get_path(file_index));
+    for (uint32_t index = latest_index; index > file_index; index--) {
+        FilePath path = get_path(index);
+        FilePath undo_path = GetUndoPath(path);
+        if (undo_path.Exists() && file.Exists()) {
+            LOG_INFO_F("Rolling back uncommitted flush of {}", path);
+            FileUndo::Deserialize(File(undo_path).ReadBytes()).Apply(file);
+        }
+
+        undo_path.Remove();
+        path.ReplaceExtension(".tmp").Remove();
+        path.Remove();
+    }
+}
+
+void FileJournal::Cleanup(const PathFn& get_path, const uint32_t current_file_index)
+{
+    GetUndoPath(get_path(current_file_index)).Remove();
+
+    uint32_t file_index = current_file_index;
+    while (file_index > 0) {
+        FilePath prev_path = get_path(--file_index);
+        FilePath prev_undo_path = GetUndoPath(prev_path);
+        if (!prev_path.Exists() && !prev_undo_path.Exists()) {
+            break;
+        }
+
+        prev_path.Remove();
+        prev_undo_path.Remove();
+    }
+}
@@ -1,5 +1,6 @@
 #include <mw/mmr/LeafSet.h>
 #include <mw/crypto/Hasher.h>
+#include <mw/util/BitUtil.h>
 
 using namespace mmr;
 
@@ -28,15 +29,95 @@ bool ILeafSet::Contains(const LeafIndex& idx) const noexcept
 
 mw::Hash ILeafSet::Root() const
 {
-    uint64_t numBytes = (m_nextLeafIdx.Get() + 7) / 8;
+    const uint64_t numBytes = (m_nextLeafIdx.Get() + 7) / 8;
+    if (numBytes <= Blake3Tree::CHUNK_LEN) {
+        return Hashed(GetBytes(0, numBytes));
+    }
+
+    // BLAKE3 puts the largest power-of-2 number of chunks that leaves at least one byte
+    // for the right side into the left subtree, and then recurses on the right side.
+    // Every left subtree is therefore complete and aligned, so its chaining value can be cached.
+    const uint64_t numChunks = (numBytes + Blake3Tree::CHUNK_LEN - 1) / Blake3Tree::CHUNK_LEN;
+
+    std::vector<mw::Hash> leftCVs;
+    uint64_t chunkIdx = 0;
+    while (numChunks - chunkIdx > 1) {
+        const uint8_t height = BitUtil::CountBitsSet(BitUtil::FillOnesToRight(numChunks - chunkIdx - 1)) - 1;
+        leftCVs.push_back(GetSubtreeCV(height, chunkIdx >> height));
+        chunkIdx += (uint64_t)1 << height;
+    }
+
+    // The last chunk may be partial, so it's always hashed directly.
+    const uint64_t lastChunkStart = chunkIdx * Blake3Tree::CHUNK_LEN;
+    std::vector<uint8_t> lastChunk = GetBytes(lastChunkStart, numBytes - lastChunkStart);
+    mw::Hash rightCV = Blake3Tree::ChunkCV(lastChunk.data(), lastChunk.size(), chunkIdx);
+
+    while (leftCVs.size() > 1) {
+        rightCV = Blake3Tree::ParentCV(leftCVs.back(), rightCV);
+        leftCVs.pop_back();
+    }
+
+    return Blake3Tree::ParentRoot(leftCVs.front(), rightCV);
+}
 
+mw::Hash ILeafSet::GetSubtreeCV(const uint8_t height, const uint64_t index) const
+{
+    InvalidateDirtyChunks();
+
+    const uint64_t key = (index << 6) | height;
+    auto iter = m_subtreeCVs.find(key);
+    if (iter != m_subtreeCVs.cend()) {
+        return iter->second;
+    }
+
+    mw::Hash cv;
+    if (height == 0) {
+        std::vector<uint8_t> chunk = GetBytes(index * Blake3Tree::CHUNK_LEN, Blake3Tree::CHUNK_LEN);
+        cv = Blake3Tree::ChunkCV(chunk.data(), chunk.size(), index);
+    } else {
+        cv = Blake3Tree::ParentCV(
+            GetSubtreeCV(height - 1, index * 2),
+            GetSubtreeCV(height - 1, (index * 2) + 1)
+        );
+    }
+
+    m_subtreeCVs.insert({ key, cv });
+    return cv;
+}
+
+void ILeafSet::MarkDirty(const uint64_t byteIdx)
+{
+    m_dirtyChunks.insert(byteIdx / Blake3Tree::CHUNK_LEN);
+}
+
+void ILeafSet::ClearSubtreeCVs()
+{
+    m_dirtyChunks.clear();
+    m_subtreeCVs.clear();
+}
+
+std::vector<uint8_t> ILeafSet::GetBytes(const uint64_t byteIdx, const uint64_t numBytes) const
+{
     std::vector<uint8_t> bytes(numBytes);
-    for (uint64_t byte_idx = 0; byte_idx < numBytes; byte_idx++) {
-        uint8_t byte = GetByte(byte_idx);
-        bytes[byte_idx] = byte;
+    for (uint64_t i = 0; i < numBytes; i++) {
+        bytes[i] = GetByte(byteIdx + i);
+    }
+
+    return bytes;
+}
+
+// Removes the cached chaining values of every dirty chunk and all of the subtrees containing it.
+// Ancestors are removed even when a descendant isn't cached, since LeafSetCache may only cache
+// the upper levels of a subtree.
+void ILeafSet::InvalidateDirtyChunks() const
+{
+    for (const uint64_t chunkIdx : m_dirtyChunks) {
+        for (uint8_t height = 0; height < 58; height++) {
+            m_subtreeCVs.erase(((chunkIdx >> height) << 6) | height);
+        }
     }
 
-    return Hashed(bytes);
+    m_dirtyChunks.clear();
 }
 
 void ILeafSet::Rewind(const uint64_t numLeaves, const std::vector<LeafIndex>& leavesToAdd)
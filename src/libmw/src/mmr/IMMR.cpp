@@ -4,10 +4,28 @@
 using namespace mmr;
 
 mw::Hash IMMR::Root() const
+{
+    const uint64_t num_nodes = mmr::LeafIndex::At(GetNumLeaves()).GetPosition();
+
+    // Bag 'em
+    const std::vector<mw::Hash> peaks = GetPeaks();
+    mw::Hash hash;
+    for (auto iter = peaks.crbegin(); iter != peaks.crend(); iter++) {
+        if (hash.IsZero()) {
+            hash = *iter;
+        } else {
+            hash = MMRUtil::CalcParentHash(Index::At(num_nodes), *iter, hash);
+        }
+    }
+
+    return hash;
+}
+
+std::vector<mw::Hash> IMMR::GetPeaks() const
 {
     const uint64_t num_nodes = mmr::LeafIndex::At(GetNumLeaves()).GetPosition();
     if (num_nodes == 0) {
-        return mw::Hash{};
+        return {};
     }
 
     // Find the "peaks"
@@ -28,16 +46,68 @@ mw::Hash IMMR::Root() const
 
     assert(numLeft == 0);
 
-    // Bag 'em
-    mw::Hash hash;
-    for (auto iter = peakIndices.crbegin(); iter != peakIndices.crend(); iter++) {
-        mw::Hash peakHash = GetHash(Index::At(*iter));
-        if (hash.IsZero()) {
-            hash = peakHash;
-        } else {
-            hash = MMRUtil::CalcParentHash(Index::At(num_nodes), peakHash, hash);
+    std::vector<mw::Hash> peaks;
+    peaks.reserve(peakIndices.size());
+    for (const uint64_t peakIdx : peakIndices) {
+        peaks.push_back(GetHash(Index::At(peakIdx)));
+    }
+
+    return peaks;
+}
+void IMMR::AddLeaves(const std::vector<Leaf>& leaves)
+{
+    for (const Leaf& leaf : leaves) {
+        AddLeaf(leaf);
+    }
+}
+
+std::vector<mw::Hash> IMMR::CalcNodeHashes(const std::vector<Leaf>& leaves) const
+{
+    if (leaves.empty()) {
+        return {};
+    }
+
+    assert(leaves.front().GetLeafIndex() == GetNextLeafIdx());
+
+    const uint64_t first_pos = leaves.front().GetNodeIndex().GetPosition();
+    const uint64_t end_pos = leaves.back().GetLeafIndex().Next().GetPosition();
+    std::vector<mw::Hash> nodes(end_pos - first_pos);
+
+    // Parents of the same height never depend on each other, so they're hashed
+    // together once all of the nodes below them are known.
+    std::vector<std::vector<Index>> parents_by_height;
+    for (const Leaf& leaf : leaves) {
+        nodes[leaf.GetNodeIndex().GetPosition() - first_pos] = leaf.GetHash();
+
+        Index nextIdx = leaf.GetNodeIndex().GetNext();
+        while (!nextIdx.IsLeaf()) {
+            if (parents_by_height.size() < nextIdx.GetHeight()) {
+                parents_by_height.resize(nextIdx.GetHeight());
+            }
+
+            parents_by_height[nextIdx.GetHeight() - 1].push_back(nextIdx);
+            nextIdx = nextIdx.GetNext();
         }
     }
 
-    return hash;
-}
\ No newline at end of file
+    auto get_hash = [this, &nodes, first_pos](const Index& idx) {
+        return idx.GetPosition() < first_pos ? GetHash(idx) : nodes[idx.GetPosition() - first_pos];
+    };
+
+    for (const std::vector<Index>& parents : parents_by_height) {
+        std::vector<mw::Hash> left_hashes, right_hashes;
+        left_hashes.reserve(parents.size());
+        right_hashes.reserve(parents.size());
+        for (const Index& parent : parents) {
+            left_hashes.push_back(get_hash(parent.GetLeftChild()));
+            right_hashes.push_back(get_hash(parent.GetRightChild()));
+        }
+
+        std::vector<mw::Hash> parent_hashes = MMRUtil::CalcParentHashes(parents, left_hashes, right_hashes);
+        for (size_t i = 0; i < parents.size(); i++) {
+            nodes[parents[i].GetPosition() - first_pos] = std::move(parent_hashes[i]);
+        }
+    }
+
+    return nodes;
+}
@@ -1,10 +1,18 @@
 #include <mw/mmr/LeafSet.h>
 #include <mw/crypto/Hasher.h>
+#include <mw/file/FileJournal.h>
+
+#include <map>
 
 using namespace mmr;
 
 LeafSet::Ptr LeafSet::Open(const FilePath& leafset_dir, const uint32_t file_index)
 {
+    FileJournal::Recover(
+        [&leafset_dir](const uint32_t index) { return GetPath(leafset_dir, index); },
+        file_index
+    );
+
     File file = GetPath(leafset_dir, file_index);
     if (!file.Exists()) {
         file.Create();
@@ -34,6 +42,7 @@ void LeafSet::ApplyUpdates(
 {
     for (auto byte : modifiedBytes) {
         m_modifiedBytes[byte.first + 8] = byte.second;
+        MarkDirty(byte.first);
     }
 
     // In case of rewind, make sure to clear everything above the new next
@@ -48,8 +57,6 @@ void LeafSet::ApplyUpdates(
 
 void LeafSet::Flush(const uint32_t file_index)
 {
-    m_mmap.Unmap();
-
     std::vector<uint8_t> nextLeafIdxBytes = m_nextLeafIdx.Serialized();
     assert(nextLeafIdxBytes.size() == 8);
 
@@ -57,10 +64,23 @@ void LeafSet::Flush(const uint32_t file_index)
         m_modifiedBytes[i] = nextLeafIdxBytes[i];
     }
 
-    FilePath new_leafset_path = GetPath(m_dir, file_index);
-    m_mmap.GetFile().CopyTo(new_leafset_path);
+    // Journal the original value of every byte that's about to be overwritten,
+    // so the shared file can be rolled back if this flush is never committed.
+    FileUndo undo(m_mmap.size());
+    std::map<uint64_t, uint8_t> sorted_bytes(m_modifiedBytes.cbegin(), m_modifiedBytes.cend());
+    for (const auto& byte : sorted_bytes) {
+        if (byte.first < m_mmap.size()) {
+            undo.AddRange(byte.first, { m_mmap.ReadByte(byte.first) });
+        }
+    }
+
+    m_mmap.Unmap();
 
-    File new_leafset_file(std::move(new_leafset_path));
+    File new_leafset_file = FileJournal::Snapshot(
+        m_mmap.GetFile(),
+        GetPath(m_dir, file_index),
+        undo
+    );
     new_leafset_file.WriteBytes(m_modifiedBytes);
 
     m_mmap = MemMap{ new_leafset_file };
@@ -71,15 +91,10 @@ void LeafSet::Flush(const uint32_t file_index)
 
 void LeafSet::Cleanup(const uint32_t current_file_index) const
 {
-    uint32_t file_index = current_file_index;
-    while (file_index > 0) {
-        FilePath prev_leafset = GetPath(m_dir, --file_index);
-        if (prev_leafset.Exists()) {
-            prev_leafset.Remove();
-        } else {
-            break;
-        }
-    }
+    FileJournal::Cleanup(
+        [this](const uint32_t index) { return GetPath(m_dir, index); },
+        current_file_index
+    );
 }
 
 uint8_t LeafSet::GetByte(const uint64_t byteIdx) const
@@ -103,4 +118,5 @@ uint8_t LeafSet::GetByte(const uint64_t byteIdx) const
 void LeafSet::SetByte(const uint64_t byteIdx, const uint8_t value)
 {
     m_modifiedBytes[byteIdx + 8] = value;
+    MarkDirty(byteIdx);
 }
\ No newline at end of file
@@ -12,6 +12,7 @@ void LeafSetCache::ApplyUpdates(
 
     for (auto byte : modifiedBytes) {
         m_modifiedBytes[byte.first] = byte.second;
+        MarkModified(byte.first);
     }
 }
 
@@ -19,6 +20,20 @@ void LeafSetCache::Flush(const uint32_t file_index)
 {
     m_pBacked->ApplyUpdates(file_index, m_nextLeafIdx, m_modifiedBytes);
     m_modifiedBytes.clear();
+    m_modifiedChunks.clear();
+    ClearSubtreeCVs();
+}
+
+mw::Hash LeafSetCache::GetSubtreeCV(const uint8_t height, const uint64_t index) const
+{
+    // Subtrees without any modified chunks can use the backing leafset's cached chaining values.
+    const uint64_t firstChunk = index << height;
+    auto iter = m_modifiedChunks.lower_bound(firstChunk);
+    if (iter == m_modifiedChunks.cend() || *iter >= firstChunk + ((uint64_t)1 << height)) {
+        return m_pBacked->GetSubtreeCV(height, index);
+    }
+
+    return ILeafSet::GetSubtreeCV(height, index);
 }
 
 uint8_t LeafSetCache::GetByte(const uint64_t byteIdx) const
@@ -35,4 +50,11 @@ uint8_t LeafSetCache::GetByte(const uint64_t byteIdx) const
 void LeafSetCache::SetByte(const uint64_t byteIdx, const uint8_t value)
 {
     m_modifiedBytes[byteIdx] = value;
+    MarkModified(byteIdx);
+}
+
+void LeafSetCache::MarkModified(const uint64_t byteIdx)
+{
+    m_modifiedChunks.insert(byteIdx / Blake3Tree::CHUNK_LEN);
+    MarkDirty(byteIdx);
 }
\ No newline at end of file
@@ -16,6 +16,24 @@ mw::Hash MMRUtil::CalcParentHash(const Index& index, const mw::Hash& left_hash,
         .hash();
 }
 
+std::vector<mw::Hash> MMRUtil::CalcParentHashes(
+    const std::vector<Index>& indices,
+    const std::vector<mw::Hash>& left_hashes,
+    const std::vector<mw::Hash>& right_hashes)
+{
+    assert(indices.size() == left_hashes.size() && indices.size() == right_hashes.size());
+
+    std::vector<std::vector<uint8_t>> messages(indices.size());
+    for (size_t i = 0; i < indices.size(); i++) {
+        CVectorWriter(SER_GETHASH, 0, messages[i], 0)
+            << indices[i].GetPosition()
+            << left_hashes[i]
+            << right_hashes[i];
+    }
+
+    return BatchHashed(messages);
+}
+
 BitSet MMRUtil::BuildCompactBitSet(const uint64_t num_leaves, const BitSet& unspent_leaf_indices)
 {
     BitSet compactable_node_indices(num_leaves * 2);
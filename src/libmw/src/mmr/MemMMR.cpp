@@ -19,6 +19,13 @@ LeafIndex MemMMR::AddLeaf(const Leaf& leaf)
     return leaf.GetLeafIndex();
 }
 
+void MemMMR::AddLeaves(const std::vector<Leaf>& leaves)
+{
+    std::vector<mw::Hash> nodes = CalcNodeHashes(leaves);
+    m_hashes.insert(m_hashes.end(), nodes.begin(), nodes.end());
+    m_leaves.insert(m_leaves.end(), leaves.cbegin(), leaves.cend());
+}
+
 Leaf MemMMR::GetLeaf(const LeafIndex& leafIdx) const
 {
     assert(leafIdx.Get() < m_leaves.size());
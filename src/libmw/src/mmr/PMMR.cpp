@@ -4,6 +4,7 @@
 #include <mw/common/Logger.h>
 #include <mw/db/LeafDB.h>
 #include <mw/exceptions/NotFoundException.h>
+#include <mw/file/FileJournal.h>
 
 using namespace mmr;
 
@@ -14,6 +15,11 @@ PMMR::Ptr PMMR::Open(
     const mw::DBWrapper::Ptr& pDBWrapper,
     const PruneList::CPtr& pPruneList)
 {
+    FileJournal::Recover(
+        [&mmr_dir, dbPrefix](const uint32_t index) { return GetPath(mmr_dir, dbPrefix, index); },
+        file_index
+    );
+
     auto pHashFile = AppendOnlyFile::Load(
         GetPath(mmr_dir, dbPrefix, file_index)
     );
@@ -50,6 +56,18 @@ LeafIndex PMMR::AddLeaf(const mmr::Leaf& leaf)
     return leaf.GetLeafIndex();
 }
 
+void PMMR::AddLeaves(const std::vector<Leaf>& leaves)
+{
+    for (const mw::Hash& hash : CalcNodeHashes(leaves)) {
+        m_pHashFile->Append(hash.vec());
+    }
+
+    for (const Leaf& leaf : leaves) {
+        m_leafMap[leaf.GetLeafIndex()] = m_leaves.size();
+        m_leaves.push_back(leaf);
+    }
+}
+
 Leaf PMMR::GetLeaf(const LeafIndex& idx) const
 {
     auto it = m_leafMap.find(idx);
@@ -113,9 +131,7 @@ void PMMR::BatchWrite(
     LOG_TRACE_F("Writing batch {} with first leaf {}", file_index, firstLeafIdx.Get());
 
     Rewind(firstLeafIdx.Get());
-    for (const Leaf& leaf : leaves) {
-        AddLeaf(leaf);
-    }
+    AddLeaves(leaves);
 
     m_pHashFile->Commit(GetPath(m_dir, m_dbPrefix, file_index));
 
@@ -129,13 +145,8 @@ void PMMR::BatchWrite(
 
 void PMMR::Cleanup(const uint32_t current_file_index) const
 {
-    uint32_t file_index = current_file_index;
-    while (file_index > 0) {
-        FilePath prev_hashfile = GetPath(m_dir, m_dbPrefix, --file_index);
-        if (prev_hashfile.Exists()) {
-            prev_hashfile.Remove();
-        } else {
-            break;
-        }
-    }
+    FileJournal::Cleanup(
+        [this](const uint32_t index) { return GetPath(m_dir, m_dbPrefix, index); },
+        current_file_index
+    );
 }
\ No newline at end of file
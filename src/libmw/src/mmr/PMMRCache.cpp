@@ -22,6 +22,13 @@ LeafIndex PMMRCache::AddLeaf(const Leaf& leaf)
     return leaf.GetLeafIndex();
 }
 
+void PMMRCache::AddLeaves(const std::vector<Leaf>& leaves)
+{
+    std::vector<mw::Hash> nodes = CalcNodeHashes(leaves);
+    m_nodes.insert(m_nodes.end(), nodes.begin(), nodes.end());
+    m_leaves.insert(m_leaves.end(), leaves.cbegin(), leaves.cend());
+}
+
 Leaf PMMRCache::GetLeaf(const LeafIndex& leafIdx) const
 {
     if (leafIdx < m_firstLeaf) {
@@ -90,9 +97,7 @@ void PMMRCache::BatchWrite(
 {
     LOG_TRACE_F("Writing batch {}", firstLeafIdx.Get());
     Rewind(firstLeafIdx.Get());
-    for (const Leaf& leaf : leaves) {
-        Add(leaf.vec());
-    }
+    AddLeaves(leaves);
 }
 
 void PMMRCache::Flush(const uint32_t file_index, const std::unique_ptr<mw::DBBatch>& pBatch)
@@ -7,9 +7,9 @@ PruneList::Ptr PruneList::Open(const FilePath& parent_dir, const uint32_t file_i
 {
     File file = GetPath(parent_dir, file_index);
 
-    BitSet bitset;
+    RankSelectBitSet bitset;
     if (file.Exists()) {
-        bitset = BitSet::From(file.ReadBytes());
+        bitset = RankSelectBitSet::From(file.ReadBytes());
     }
 
     uint64_t total_shift = bitset.count();
@@ -24,9 +24,6 @@ FilePath PruneList::GetPath(const FilePath& dir, const uint32_t file_index)
 uint64_t PruneList::GetShift(const Index& index) const noexcept
 {
     assert(!m_compacted.test(index.GetPosition()));
-
-    // NOTE: rank() uses an inefficient algorithm.
-    // A shift cache with an efficient "nearest-neighbor" searching algorithm would be better.
     return m_compacted.rank(index.GetPosition());
 }
 
@@ -40,6 +37,6 @@ void PruneList::Commit(const uint32_t file_index, const BitSet& compacted)
     File(GetPath(m_dir, file_index))
         .Write(compacted.bytes());
 
-    m_compacted = compacted;
-    m_totalShift = compacted.count();
+    m_compacted = RankSelectBitSet(compacted);
+    m_totalShift = m_compacted.count();
 }
\ No newline at end of file
@@ -14,10 +14,7 @@ void mw::Block::Validate() const
     StealthSumValidator::Validate(m_pHeader->GetStealthOffset(), m_body);
 
     MemMMR kernel_mmr;
-    std::for_each(
-        GetKernels().cbegin(), GetKernels().cend(),
-        [&kernel_mmr](const Kernel& kernel) { kernel_mmr.Add(kernel); }
-    );
+    kernel_mmr.AddBatch(GetKernels());
     if (m_pHeader->GetKernelRoot() != kernel_mmr.Root()) {
         ThrowValidation(EConsensusError::MMR_MISMATCH);
     }
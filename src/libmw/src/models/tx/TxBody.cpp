@@ -6,6 +6,37 @@
 #include <unordered_set>
 #include <numeric>
 
+void TxBody::ComputeHashes()
+{
+    std::vector<std::vector<uint8_t>> messages;
+    messages.reserve(m_inputs.size() + m_outputs.size() + m_kernels.size());
+    for (const Input& input : m_inputs) {
+        messages.push_back(input.Serialized());
+    }
+
+    for (const Output& output : m_outputs) {
+        messages.push_back(output.SerializeForHash());
+    }
+
+    for (const Kernel& kernel : m_kernels) {
+        messages.push_back(kernel.Serialized());
+    }
+
+    std::vector<mw::Hash> hashes = BatchHashed(messages);
+    auto iter = hashes.begin();
+    for (Input& input : m_inputs) {
+        input.m_hash = std::move(*iter++);
+    }
+
+    for (Output& output : m_outputs) {
+        output.m_hash = std::move(*iter++);
+    }
+
+    for (Kernel& kernel : m_kernels) {
+        kernel.m_hash = std::move(*iter++);
+    }
+}
+
 std::vector<PegInCoin> TxBody::GetPegIns() const noexcept
 {
     std::vector<PegInCoin> pegins;
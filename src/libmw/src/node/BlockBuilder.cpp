@@ -1,5 +1,4 @@
 #include <mw/node/BlockBuilder.h>
-#include <mw/consensus/Aggregation.h>
 #include <mw/consensus/KernelSumValidator.h>
 #include <mw/consensus/Params.h>
 #include <mw/consensus/Weight.h>
@@ -11,7 +10,7 @@ MW_NAMESPACE
 
 bool BlockBuilder::AddTransaction(const Transaction::CPtr& pTransaction, const std::vector<PegInCoin>& pegins)
 {
-    // Check weight
+    // Check weight. Weight is additive, so the block's weight is the sum of its transactions' weights.
     uint64_t weight = Weight::Calculate(pTransaction->GetBody());
     if ((weight + m_weight) > mw::MAX_BLOCK_WEIGHT) {
         LOG_ERROR("Exceeds max block weight");
@@ -53,12 +52,8 @@ bool BlockBuilder::AddTransaction(const Transaction::CPtr& pTransaction, const s
         }
     }
 
-    // Validate transaction
-    try {
-        pTransaction->Validate();
-    } catch (std::exception& e) {
-        LOG_DEBUG_F("Failed to add transaction {}. Error: {}", pTransaction, e.what());
-    }
+    // The transaction's signatures and rangeproofs were already verified when it was accepted to the mempool,
+    // and the block is fully validated before it's connected, so they aren't checked again here.
 
     // Make sure all inputs are available.
     for (const Input& input : pTransaction->GetInputs()) {
@@ -76,19 +71,9 @@ bool BlockBuilder::AddTransaction(const Transaction::CPtr& pTransaction, const s
         }
     }
 
-    // Aggregate transactions
-    auto pAggregated = pTransaction;
-    if (m_pAggregated != nullptr) {
-        pAggregated = Aggregation::Aggregate({ m_pAggregated, pTransaction });
-    }
-
-    if (pAggregated == nullptr) {
-        LOG_ERROR("Failed to aggregate transaction");
-        return false;
-    }
-
-    m_pAggregated = pAggregated;
-    m_weight = Weight::Calculate(pAggregated->GetBody());
+    // The transactions are only aggregated (and their components sorted) once, in BuildBlock.
+    m_transactions.push_back(pTransaction);
+    m_weight += weight;
 
     return true;
 }
@@ -96,13 +81,7 @@ bool BlockBuilder::AddTransaction(const Transaction::CPtr& pTransaction, const s
 mw::Block::Ptr BlockBuilder::BuildBlock() const
 {
     mw::CoinsViewCache cache(m_pCoinsView);
-
-    std::vector<mw::Transaction::CPtr> txs;
-    if (m_pAggregated != nullptr) {
-        txs.push_back(m_pAggregated);
-    }
-
-    return cache.BuildNextBlock(m_height, txs);
+    return cache.BuildNextBlock(m_height, m_transactions);
 }
 
 END_NAMESPACE
\ No newline at end of file
@@ -1,8 +1,20 @@
 #pragma once
 
 #include <mw/models/tx/UTXO.h>
+#include <memusage.h>
 #include <unordered_map>
 
+//
+// Approximate heap usage of a cached UTXO: the object itself, its rangeproof,
+// and the heap buffers backing its commitment, keys, signature and hashes.
+//
+inline size_t UTXOMemoryUsage(const UTXO& utxo) noexcept
+{
+    return memusage::MallocUsage(sizeof(UTXO))
+        + memusage::MallocUsage(utxo.GetRangeProof()->size())
+        + 12 * memusage::MallocUsage(mw::Hash::size());
+}
+
 struct CoinAction {
     bool IsSpend() const noexcept { return pUTXO == nullptr; }
 
@@ -39,11 +51,22 @@ public:
     void Clear() noexcept
     {
         m_actions.clear();
+        m_usage = 0;
+    }
+
+    size_t DynamicMemoryUsage() const noexcept
+    {
+        return memusage::DynamicUsage(m_actions) + m_usage;
     }
 
 private:
     void AddAction(const mw::Hash& output_id, CoinAction&& action)
     {
+        m_usage += memusage::MallocUsage(sizeof(CoinAction));
+        if (action.pUTXO != nullptr) {
+            m_usage += UTXOMemoryUsage(*action.pUTXO);
+        }
+
         auto iter = m_actions.find(output_id);
         if (iter != m_actions.end()) {
             std::vector<CoinAction>& actions = iter->second;
@@ -56,4 +79,7 @@ private:
     }
 
     std::unordered_map<mw::Hash, std::vector<CoinAction>> m_actions;
+
+    // Heap usage of the actions and their UTXOs, not counting the map itself.
+    size_t m_usage{0};
 };
\ No newline at end of file
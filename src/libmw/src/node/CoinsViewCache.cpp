@@ -7,18 +7,55 @@
 
 #include "CoinActions.h"
 
+#include <system_error>
+
 using namespace mw;
 
+BlockPrefetch::BlockPrefetch(const ICoinsView::Ptr& pBase, const mw::Header::CPtr& pPrevHeader, const mw::Block::CPtr& pBlock)
+    : m_blockHash(pBlock->GetHash()), m_pPrevHeader(pPrevHeader)
+{
+    auto prefetch = [pBase, pPrevHeader, pBlock]() {
+        BlindingFactor prev_offset = pPrevHeader != nullptr ? pPrevHeader->GetKernelOffset() : BlindingFactor();
+        KernelSumValidator::ValidateForBlock(pBlock->GetTxBody(), pBlock->GetKernelOffset(), prev_offset);
+
+        Result result;
+        result.spent_utxos = pBase->FetchUTXOs(pBlock->GetTxBody().GetSpentIDs());
+
+        std::vector<std::vector<uint8_t>> leaf_data;
+        for (const mw::Hash& output_hash : Hashes::From(pBlock->GetOutputs())) {
+            leaf_data.push_back(output_hash.Serialized());
+        }
+
+        const uint64_t num_txos = pPrevHeader != nullptr ? pPrevHeader->GetNumTXOs() : 0;
+        result.output_leaves = mmr::Leaf::CreateBatch(mmr::LeafIndex::At(num_txos), std::move(leaf_data));
+        return result;
+    };
+
+    try {
+        m_result = std::async(std::launch::async, std::move(prefetch));
+    } catch (const std::system_error& e) {
+        LOG_WARNING_F("Failed to start prefetch thread: {}", e.what());
+    }
+}
+
+BlockPrefetch::~BlockPrefetch()
+{
+    if (m_result.valid()) {
+        m_result.wait();
+    }
+}
+
 CoinsViewCache::CoinsViewCache(const ICoinsView::Ptr& pBase)
     : ICoinsView(pBase->GetBestHeader(), pBase->GetDatabase()),
       m_pBase(pBase),
       m_pLeafSet(std::make_unique<LeafSetCache>(pBase->GetLeafSet())),
       m_pOutputPMMR(std::make_unique<PMMRCache>(pBase->GetOutputPMMR())),
-      m_pUpdates(std::make_shared<CoinsViewUpdates>()) {}
+      m_pUpdates(std::make_shared<CoinsViewUpdates>()),
+      m_baseUTXOsUsage(0) {}
 
 std::vector<UTXO::CPtr> CoinsViewCache::GetUTXOs(const mw::Hash& output_id) const noexcept
 {
-    std::vector<UTXO::CPtr> utxos = m_pBase->GetUTXOs(output_id);
+    std::vector<UTXO::CPtr> utxos = GetBaseUTXOs(output_id);
 
     std::vector<CoinAction> actions = m_pUpdates->GetActions(output_id);
     for (const CoinAction& action : actions) {
@@ -33,15 +70,107 @@ std::vector<UTXO::CPtr> CoinsViewCache::GetUTXOs(const mw::Hash& output_id) cons
     return utxos;
 }
 
-mw::BlockUndo::CPtr CoinsViewCache::ApplyBlock(const mw::Block::CPtr& pBlock)
+std::unordered_map<mw::Hash, std::vector<UTXO::CPtr>> CoinsViewCache::FetchUTXOs(const std::vector<mw::Hash>& output_ids) const
+{
+    std::vector<mw::Hash> missing_ids;
+    for (const mw::Hash& output_id : output_ids) {
+        if (m_baseUTXOs.find(output_id) == m_baseUTXOs.end()) {
+            missing_ids.push_back(output_id);
+        }
+    }
+
+    if (!missing_ids.empty()) {
+        for (auto& fetched : m_pBase->FetchUTXOs(missing_ids)) {
+            CacheBaseUTXOs(fetched.first, std::move(fetched.second));
+        }
+    }
+
+    std::unordered_map<mw::Hash, std::vector<UTXO::CPtr>> utxos_by_id;
+    for (const mw::Hash& output_id : output_ids) {
+        std::vector<UTXO::CPtr> utxos = GetUTXOs(output_id);
+        if (!utxos.empty()) {
+            utxos_by_id[output_id] = std::move(utxos);
+        }
+    }
+
+    return utxos_by_id;
+}
+
+const std::vector<UTXO::CPtr>& CoinsViewCache::GetBaseUTXOs(const mw::Hash& output_id) const
+{
+    static const std::vector<UTXO::CPtr> NO_UTXOS;
+
+    auto iter = m_baseUTXOs.find(output_id);
+    if (iter == m_baseUTXOs.end()) {
+        std::vector<UTXO::CPtr> utxos = m_pBase->GetUTXOs(output_id);
+        if (utxos.empty()) {
+            return NO_UTXOS;
+        }
+
+        CacheBaseUTXOs(output_id, std::move(utxos));
+        iter = m_baseUTXOs.find(output_id);
+    }
+
+    return iter->second;
+}
+
+void CoinsViewCache::CacheBaseUTXOs(const mw::Hash& output_id, std::vector<UTXO::CPtr> utxos) const
+{
+    for (const UTXO::CPtr& pUTXO : utxos) {
+        m_baseUTXOsUsage += memusage::DynamicUsage(pUTXO) + UTXOMemoryUsage(*pUTXO);
+    }
+
+    m_baseUTXOsUsage += memusage::MallocUsage(utxos.capacity() * sizeof(UTXO::CPtr)) + memusage::MallocUsage(mw::Hash::size());
+    m_baseUTXOs.insert({output_id, std::move(utxos)});
+}
+
+size_t CoinsViewCache::DynamicMemoryUsage() const noexcept
+{
+    return memusage::DynamicUsage(m_baseUTXOs) + m_baseUTXOsUsage + m_pUpdates->DynamicMemoryUsage();
+}
+
+BlockPrefetch::UPtr CoinsViewCache::PrefetchBlock(const mw::Block::CPtr& pBlock) const
+{
+    assert(pBlock != nullptr);
+
+    return std::make_unique<BlockPrefetch>(m_pBase, GetBestHeader(), pBlock);
+}
+
+mw::BlockUndo::CPtr CoinsViewCache::ApplyBlock(const mw::Block::CPtr& pBlock, BlockPrefetch::UPtr pPrefetch)
 {
     assert(pBlock != nullptr);
 
     auto pPreviousHeader = GetBestHeader();
+
+    // The prefetch can only be used if it was started from this view's current state.
+    // Otherwise it's ignored, along with any failure it found, and the block is checked from scratch.
+    bool prefetched = pPrefetch != nullptr
+        && pPrefetch->m_result.valid()
+        && pPrefetch->m_blockHash == pBlock->GetHash()
+        && pPrefetch->m_pPrevHeader == pPreviousHeader;
+
+    BlockPrefetch::Result prefetch_result;
+    if (prefetched) {
+        // Rethrows any ValidationException from the kernel sum check.
+        prefetch_result = pPrefetch->m_result.get();
+    }
+    pPrefetch.reset();
+
     SetBestHeader(pBlock->GetHeader());
 
-    BlindingFactor prev_offset = pPreviousHeader != nullptr ? pPreviousHeader->GetKernelOffset() : BlindingFactor();
-    KernelSumValidator::ValidateForBlock(pBlock->GetTxBody(), pBlock->GetKernelOffset(), prev_offset);
+    if (prefetched) {
+        for (auto& fetched : prefetch_result.spent_utxos) {
+            if (m_baseUTXOs.find(fetched.first) == m_baseUTXOs.end()) {
+                CacheBaseUTXOs(fetched.first, std::move(fetched.second));
+            }
+        }
+    } else {
+        BlindingFactor prev_offset = pPreviousHeader != nullptr ? pPreviousHeader->GetKernelOffset() : BlindingFactor();
+        KernelSumValidator::ValidateForBlock(pBlock->GetTxBody(), pBlock->GetKernelOffset(), prev_offset);
+
+        // Look up all of the spent coins together, rather than one at a time.
+        FetchUTXOs(pBlock->GetTxBody().GetSpentIDs());
+    }
 
     std::vector<UTXO> coinsSpent;
     std::for_each(
@@ -52,14 +181,15 @@ mw::BlockUndo::CPtr CoinsViewCache::ApplyBlock(const mw::Block::CPtr& pBlock)
         }
     );
 
-    std::vector<mw::Hash> coinsAdded;
-    std::for_each(
-        pBlock->GetOutputs().cbegin(), pBlock->GetOutputs().cend(),
-        [this, &pBlock, &coinsAdded](const Output& output) {
-            AddUTXO(pBlock->GetHeight(), output);
-            coinsAdded.push_back(output.GetOutputID());
-        }
-    );
+    // The leaves were hashed at the index following the previous header's outputs,
+    // which should always match the PMMR, but fall back to rehashing them if it doesn't.
+    const std::vector<mmr::Leaf>& leaves = prefetch_result.output_leaves;
+    if (prefetched && (leaves.empty() || leaves.front().GetLeafIndex() == m_pOutputPMMR->GetNextLeafIdx())) {
+        AddUTXOs(pBlock->GetHeight(), pBlock->GetOutputs(), leaves);
+    } else {
+        AddUTXOs(pBlock->GetHeight(), pBlock->GetOutputs());
+    }
+    std::vector<mw::Hash> coinsAdded = pBlock->GetTxBody().GetOutputIDs();
 
     auto pHeader = pBlock->GetHeader();
     if (pHeader->GetOutputRoot() != GetOutputPMMR()->Root()
@@ -114,15 +244,9 @@ mw::Block::Ptr CoinsViewCache::BuildNextBlock(const uint64_t height, const std::
     auto pTransaction = Aggregation::Aggregate(transactions);
 
     MemMMR::Ptr pKernelMMR = std::make_shared<MemMMR>();
-    std::for_each(
-        pTransaction->GetKernels().cbegin(), pTransaction->GetKernels().cend(),
-        [&pKernelMMR](const Kernel& kernel) { pKernelMMR->Add(kernel); }
-    );
+    pKernelMMR->AddBatch(pTransaction->GetKernels());
 
-    std::for_each(
-        pTransaction->GetOutputs().cbegin(), pTransaction->GetOutputs().cend(),
-        [this, height](const Output& output) { AddUTXO(height, output); }
-    );
+    AddUTXOs(height, pTransaction->GetOutputs());
 
     std::for_each(
         pTransaction->GetInputs().cbegin(), pTransaction->GetInputs().cend(),
@@ -170,14 +294,24 @@ bool CoinsViewCache::HasCoinInCache(const mw::Hash& output_id) const noexcept
     return false;
 }
 
-void CoinsViewCache::AddUTXO(const uint64_t header_height, const Output& output)
+void CoinsViewCache::AddUTXOs(const uint64_t header_height, const std::vector<Output>& outputs)
 {
-    mmr::LeafIndex leafIdx = m_pOutputPMMR->Add(output.GetOutputID());
-    m_pLeafSet->Add(leafIdx);
+    std::vector<mmr::LeafIndex> leaf_indices = m_pOutputPMMR->AddBatch(Hashes::From(outputs));
+    for (size_t i = 0; i < outputs.size(); i++) {
+        m_pLeafSet->Add(leaf_indices[i]);
+        m_pUpdates->AddUTXO(std::make_shared<UTXO>(header_height, std::move(leaf_indices[i]), outputs[i]));
+    }
+}
 
-    auto pUTXO = std::make_shared<UTXO>(header_height, std::move(leafIdx), output);
+void CoinsViewCache::AddUTXOs(const uint64_t header_height, const std::vector<Output>& outputs, const std::vector<mmr::Leaf>& leaves)
+{
+    assert(outputs.size() == leaves.size());
 
-    m_pUpdates->AddUTXO(pUTXO);
+    m_pOutputPMMR->AddLeaves(leaves);
+    for (size_t i = 0; i < outputs.size(); i++) {
+        m_pLeafSet->Add(leaves[i].GetLeafIndex());
+        m_pUpdates->AddUTXO(std::make_shared<UTXO>(header_height, leaves[i].GetLeafIndex(), outputs[i]));
+    }
 }
 
 UTXO CoinsViewCache::SpendUTXO(const mw::Hash& output_id)
@@ -217,6 +351,10 @@ void CoinsViewCache::Flush(const std::unique_ptr<mw::DBBatch>& pBatch)
     
     m_pBase->WriteBatch(pBatch, *m_pUpdates, GetBestHeader());
 
+    // The base now includes the updates, so the UTXOs fetched from it are stale.
+    m_baseUTXOs.clear();
+    m_baseUTXOsUsage = 0;
+
     MMRInfo mmr_info;
     if (!m_pBase->IsCache()) {
         auto current_mmr_info = MMRInfoDB(GetDatabase().get(), pBatch.get())
@@ -18,6 +18,9 @@ CoinsViewDB::Ptr CoinsViewDB::Open(
     uint32_t file_index = current_mmr_info ? current_mmr_info->index : 0;
     uint32_t compact_index = current_mmr_info ? current_mmr_info->compact_index : 0;
 
+    // Older versions keyed UTXOs by hex-encoded output ID.
+    CoinDB(pDBWrapper.get(), nullptr).MigrateHexKeys();
+
     auto pLeafSet = LeafSet::Open(datadir, file_index);
     auto pPruneList = PruneList::Open(datadir, compact_index);
     auto pOutputMMR = PMMR::Open('O', datadir, file_index, pDBWrapper, pPruneList);
@@ -32,10 +35,18 @@ std::vector<UTXO::CPtr> CoinsViewDB::GetUTXOs(const mw::Hash& output_id) const
     return GetUTXOs(coinDB, output_id);
 }
 
-std::vector<UTXO::CPtr> CoinsViewDB::GetUTXOs(const CoinDB& coinDB, const mw::Hash& output_id) const
+std::unordered_map<mw::Hash, std::vector<UTXO::CPtr>> CoinsViewDB::FetchUTXOs(const std::vector<mw::Hash>& output_ids) const
 {
-    std::vector<uint8_t> value;
+    std::unordered_map<mw::Hash, std::vector<UTXO::CPtr>> utxos;
+    for (auto& utxo : CoinDB(GetDatabase().get(), nullptr).GetUTXOs(output_ids)) {
+        utxos.insert({utxo.first, {std::move(utxo.second)}});
+    }
+
+    return utxos;
+}
 
+std::vector<UTXO::CPtr> CoinsViewDB::GetUTXOs(const CoinDB& coinDB, const mw::Hash& output_id) const
+{
     auto utxos_by_hash = coinDB.GetUTXOs({output_id});
     auto iter = utxos_by_hash.find(output_id);
     if (iter != utxos_by_hash.cend()) {
@@ -55,9 +66,6 @@ void CoinsViewDB::AddUTXO(CoinDB& coinDB, const Output& output)
 
 void CoinsViewDB::AddUTXO(CoinDB& coinDB, const UTXO::CPtr& pUTXO)
 {
-    std::vector<UTXO::CPtr> utxos = GetUTXOs(coinDB, pUTXO->GetOutputID());
-    utxos.push_back(pUTXO);
-
     coinDB.AddUTXOs(std::vector<UTXO::CPtr>{ pUTXO });
 }
 
@@ -1,4 +1,5 @@
 #include <mw/wallet/Keychain.h>
+#include <mw/crypto/CryptoCheckQueue.h>
 #include <mw/crypto/Hasher.h>
 #include <mw/crypto/SecretKeys.h>
 #include <mw/models/tx/OutputMask.h>
@@ -6,19 +7,17 @@
 
 MW_NAMESPACE
 
+// Scanning an output is a single EC multiplication, so workers take several at a time.
+static constexpr size_t MIN_OUTPUTS_PER_CHECK = 16;
+
 bool Keychain::RewindOutput(const Output& output, mw::Coin& coin) const
 {
-    if (!output.HasStandardFields()) {
-        return false;
-    }
-
-    PublicKey shared_secret = output.Ke().Mul(GetScanSecret());
-    uint8_t view_tag = Hashed(EHashTag::TAG, shared_secret)[0];
-    if (view_tag != output.GetViewTag()) {
+    boost::optional<PublicKey> shared_secret = CalcSharedSecret(output);
+    if (!shared_secret) {
         return false;
     }
 
-    SecretKey t = Hashed(EHashTag::DERIVE, shared_secret);
+    SecretKey t = Hashed(EHashTag::DERIVE, *shared_secret);
     PublicKey B_i = output.Ko().Div(Hashed(EHashTag::OUT_KEY, t));
 
     // Check if B_i belongs to wallet
@@ -64,6 +63,65 @@ bool Keychain::RewindOutput(const Output& output, mw::Coin& coin) const
     return true;
 }
 
+std::vector<size_t> Keychain::FilterOutputs(const std::vector<Output>& outputs) const
+{
+    if (outputs.empty()) {
+        return {};
+    }
+
+    // Each check only writes the flags for its own range, so no locking is needed.
+    std::vector<uint8_t> is_candidate(outputs.size(), 0);
+    auto scan_outputs = [this, &outputs, &is_candidate](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            try {
+                is_candidate[i] = CalcSharedSecret(outputs[i]) ? 1 : 0;
+            } catch (const std::exception&) {
+                // Let RewindOutput handle (and report) malformed outputs as before.
+                is_candidate[i] = 1;
+            }
+        }
+
+        return true;
+    };
+
+    // Split the outputs evenly across the available threads.
+    const size_t max_checks = (outputs.size() + MIN_OUTPUTS_PER_CHECK - 1) / MIN_OUTPUTS_PER_CHECK;
+    const size_t num_checks = std::min(CryptoCheckQueue::NumThreads(), max_checks);
+    const size_t outputs_per_check = (outputs.size() + num_checks - 1) / num_checks;
+
+    std::vector<CryptoCheck> checks;
+    for (size_t begin = 0; begin < outputs.size(); begin += outputs_per_check) {
+        const size_t end = std::min(begin + outputs_per_check, outputs.size());
+        checks.emplace_back([&scan_outputs, begin, end]() { return scan_outputs(begin, end); });
+    }
+
+    CryptoCheckQueue::Run(checks);
+
+    std::vector<size_t> candidates;
+    for (size_t i = 0; i < outputs.size(); i++) {
+        if (is_candidate[i]) {
+            candidates.push_back(i);
+        }
+    }
+
+    return candidates;
+}
+
+boost::optional<PublicKey> Keychain::CalcSharedSecret(const Output& output) const
+{
+    if (!output.HasStandardFields()) {
+        return boost::none;
+    }
+
+    PublicKey shared_secret = output.Ke().Mul(GetScanSecret());
+    uint8_t view_tag = Hashed(EHashTag::TAG, shared_secret)[0];
+    if (view_tag != output.GetViewTag()) {
+        return boost::none;
+    }
+
+    return boost::make_optional(std::move(shared_secret));
+}
+
 StealthAddress Keychain::GetStealthAddress(const uint32_t index) const
 {
     PublicKey Bi = PublicKey::From(GetSpendKey(index));
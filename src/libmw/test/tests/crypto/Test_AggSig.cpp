@@ -2,12 +2,16 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <mw/crypto/CryptoCheckQueue.h>
 #include <mw/crypto/MuSig.h>
 #include <mw/crypto/PublicKeys.h>
 #include <mw/crypto/Schnorr.h>
+#include <mw/crypto/VerificationCache.h>
 
 #include <test_framework/TestMWEB.h>
 
+#include <boost/thread/thread.hpp>
+
 BOOST_FIXTURE_TEST_SUITE(TestAggSig, MWEBTestingSetup)
 
 BOOST_AUTO_TEST_CASE(AggSigInteraction)
@@ -94,4 +98,41 @@ BOOST_AUTO_TEST_CASE(SingleSchnorrSig)
     BOOST_REQUIRE(valid == true);
 }
 
-BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
+BOOST_AUTO_TEST_CASE(ParallelBatchVerify)
+{
+    boost::thread_group workers;
+    for (int i = 0; i < 2; i++) {
+        workers.create_thread([i]() { return CryptoCheckQueue::Thread(i); });
+    }
+
+    // Enough signatures to be split into several sub-batches.
+    std::vector<SignedMessage> signatures;
+    for (size_t i = 0; i < 50; i++) {
+        signatures.push_back(Schnorr::SignMessage(SecretKey::Random(), SecretKey::Random().GetBigInt()));
+    }
+
+    std::vector<SignedMessage> invalid_signatures = signatures;
+    invalid_signatures.back() = SignedMessage(
+        signatures.back().GetMsgHash(),
+        PublicKey::Random(),
+        signatures.back().GetSignature()
+    );
+
+    BOOST_REQUIRE(!VerificationCache::Contains(signatures.front()));
+    BOOST_REQUIRE(!Schnorr::BatchVerify(invalid_signatures));
+    BOOST_REQUIRE(!VerificationCache::Contains(signatures.front()));
+
+    BOOST_REQUIRE(Schnorr::BatchVerify(signatures));
+    for (const SignedMessage& signature : signatures) {
+        BOOST_REQUIRE(VerificationCache::Contains(signature));
+    }
+
+    // The cached signatures are skipped, but the invalid one is still checked.
+    BOOST_REQUIRE(!Schnorr::BatchVerify(invalid_signatures));
+    BOOST_REQUIRE(!VerificationCache::Contains(invalid_signatures.back()));
+
+    workers.interrupt_all();
+    workers.join_all();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -3,9 +3,12 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <mw/crypto/Bulletproofs.h>
+#include <mw/crypto/CryptoCheckQueue.h>
 
 #include <test_framework/TestMWEB.h>
 
+#include <boost/thread/thread.hpp>
+
 BOOST_FIXTURE_TEST_SUITE(TestRangeProofs, MWEBTestingSetup)
 
 BOOST_AUTO_TEST_CASE(RangeProofs)
@@ -48,4 +51,43 @@ BOOST_AUTO_TEST_CASE(RangeProofs)
     BOOST_REQUIRE(Bulletproofs::BatchVerify(rangeProofs));
 }
 
-BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
+BOOST_AUTO_TEST_CASE(ParallelBatchVerify)
+{
+    boost::thread_group workers;
+    for (int i = 0; i < 2; i++) {
+        workers.create_thread([i]() { return CryptoCheckQueue::Thread(i); });
+    }
+
+    // Enough proofs to be split into several sub-batches.
+    std::vector<ProofData> rangeProofs;
+    for (uint64_t value = 0; value < 20; value++) {
+        BlindingFactor blind = BlindingFactor::Random();
+        std::vector<uint8_t> extraData = SecretKey::Random().vec();
+        RangeProof::CPtr pRangeProof = Bulletproofs::Generate(
+            value,
+            SecretKey(blind.vec()),
+            SecretKey::Random(),
+            SecretKey::Random(),
+            ProofMessage{},
+            extraData
+        );
+        rangeProofs.push_back(ProofData{ Commitment::Blinded(blind, value), pRangeProof, extraData });
+    }
+
+    BOOST_REQUIRE(Bulletproofs::BatchVerifyUncached(rangeProofs));
+
+    // An invalid proof in the last sub-batch must fail the whole batch.
+    std::vector<ProofData> invalidProofs = rangeProofs;
+    invalidProofs.back().extraData = SecretKey::Random().vec();
+    BOOST_REQUIRE(!Bulletproofs::BatchVerifyUncached(invalidProofs));
+    BOOST_REQUIRE(!Bulletproofs::BatchVerify(invalidProofs));
+
+    // Valid proofs are cached, and cached proofs are not accepted for a different extraData.
+    BOOST_REQUIRE(Bulletproofs::BatchVerify(rangeProofs));
+    BOOST_REQUIRE(!Bulletproofs::BatchVerify(invalidProofs));
+
+    workers.interrupt_all();
+    workers.join_all();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,130 @@
+// Copyright (c) 2022 The Litecoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <mw/db/CoinDB.h>
+
+#include <test_framework/TestMWEB.h>
+#include <test_framework/models/TxOutput.h>
+
+BOOST_FIXTURE_TEST_SUITE(TestCoinDB, MWEBTestingSetup)
+
+static UTXO::CPtr CreateUTXO(const uint64_t leaf_idx)
+{
+    test::TxOutput output = test::TxOutput::Create(SecretKey::Random(), StealthAddress::Random(), 1000);
+    return std::make_shared<UTXO>(100, mmr::LeafIndex::At(leaf_idx), output.GetOutput());
+}
+
+BOOST_AUTO_TEST_CASE(CoinDBBinaryKeys)
+{
+    auto pDatabase = GetDB();
+
+    UTXO::CPtr utxo1 = CreateUTXO(0);
+    UTXO::CPtr utxo2 = CreateUTXO(1);
+    UTXO::CPtr utxo3 = CreateUTXO(2);
+
+    {
+        auto pBatch = pDatabase->CreateBatch();
+        CoinDB(pDatabase.get(), pBatch.get()).AddUTXOs({utxo1, utxo2});
+        pBatch->Commit();
+    }
+
+    // UTXOs are stored under 'U' followed by the raw output ID.
+    const mw::Hash& id1 = utxo1->GetOutputID();
+    std::vector<uint8_t> value;
+    BOOST_REQUIRE(pDatabase->Read("U" + std::string(id1.data(), id1.data() + id1.size()), value));
+    BOOST_REQUIRE(value == utxo1->Serialized());
+    BOOST_REQUIRE(!pDatabase->Read("U" + id1.ToHex(), value));
+
+    CoinDB coinDB(pDatabase.get());
+    auto utxos = coinDB.GetUTXOs({utxo3->GetOutputID(), utxo2->GetOutputID(), utxo1->GetOutputID()});
+    BOOST_REQUIRE(utxos.size() == 2);
+    BOOST_REQUIRE(utxos.at(utxo1->GetOutputID())->Serialized() == utxo1->Serialized());
+    BOOST_REQUIRE(utxos.at(utxo2->GetOutputID())->Serialized() == utxo2->Serialized());
+
+    {
+        auto pBatch = pDatabase->CreateBatch();
+        CoinDB(pDatabase.get(), pBatch.get()).RemoveUTXOs({utxo1->GetOutputID()});
+        pBatch->Commit();
+    }
+
+    utxos = coinDB.GetUTXOs({utxo1->GetOutputID(), utxo2->GetOutputID()});
+    BOOST_REQUIRE(utxos.size() == 1);
+    BOOST_REQUIRE(utxos.count(utxo2->GetOutputID()) == 1);
+}
+
+BOOST_AUTO_TEST_CASE(CoinDBMigrateHexKeys)
+{
+    auto pDatabase = GetDB();
+
+    // Write UTXOs using the old hex-encoded keys.
+    std::vector<UTXO::CPtr> utxos;
+    std::vector<mw::Hash> output_ids;
+    {
+        auto pBatch = pDatabase->CreateBatch();
+        for (uint64_t i = 0; i < 5; i++) {
+            utxos.push_back(CreateUTXO(i));
+            output_ids.push_back(utxos.back()->GetOutputID());
+            pBatch->Write("U" + utxos.back()->GetOutputID().ToHex(), utxos.back()->Serialized());
+        }
+        pBatch->Commit();
+    }
+
+    CoinDB coinDB(pDatabase.get());
+    BOOST_REQUIRE(coinDB.GetUTXOs({utxos.front()->GetOutputID()}).empty());
+
+    BOOST_REQUIRE(coinDB.MigrateHexKeys() == utxos.size());
+
+    auto migrated = coinDB.GetUTXOs(output_ids);
+    BOOST_REQUIRE(migrated.size() == utxos.size());
+    for (const UTXO::CPtr& pUTXO : utxos) {
+        BOOST_REQUIRE(migrated.at(pUTXO->GetOutputID())->Serialized() == pUTXO->Serialized());
+
+        std::vector<uint8_t> value;
+        BOOST_REQUIRE(!pDatabase->Read("U" + pUTXO->GetOutputID().ToHex(), value));
+    }
+
+    // Nothing is left to migrate.
+    BOOST_REQUIRE(coinDB.MigrateHexKeys() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(CoinDBCursor)
+{
+    auto pDatabase = GetDB();
+
+    std::vector<UTXO::CPtr> utxos;
+    {
+        auto pBatch = pDatabase->CreateBatch();
+        for (uint64_t i = 0; i < 10; i++) {
+            utxos.push_back(CreateUTXO(i));
+        }
+        CoinDB(pDatabase.get(), pBatch.get()).AddUTXOs(utxos);
+
+        // A UTXO left under a legacy hex key is skipped.
+        UTXO::CPtr legacy_utxo = CreateUTXO(10);
+        pBatch->Write("U" + legacy_utxo->GetOutputID().ToHex(), legacy_utxo->Serialized());
+        pBatch->Commit();
+    }
+
+    CoinDB coinDB(pDatabase.get());
+    UTXOCursor::UPtr pCursor = coinDB.NewCursor();
+
+    // UTXOs added after the cursor was created aren't seen by it.
+    {
+        auto pBatch = pDatabase->CreateBatch();
+        CoinDB(pDatabase.get(), pBatch.get()).AddUTXOs({CreateUTXO(11)});
+        pBatch->Commit();
+    }
+
+    std::sort(utxos.begin(), utxos.end(), [](const UTXO::CPtr& a, const UTXO::CPtr& b) { return a->GetOutputID() < b->GetOutputID(); });
+    for (const UTXO::CPtr& pUTXO : utxos) {
+        BOOST_REQUIRE(pCursor->Valid());
+        UTXO::CPtr pCursorUTXO = pCursor->GetUTXO();
+        BOOST_REQUIRE(pCursorUTXO != nullptr);
+        BOOST_REQUIRE(pCursorUTXO->Serialized() == pUTXO->Serialized());
+        pCursor->Next();
+    }
+    BOOST_REQUIRE(!pCursor->Valid());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,7 @@
 
 #include <mw/mmr/LeafSet.h>
 #include <mw/crypto/Hasher.h>
+#include <mw/file/FileJournal.h>
 
 #include <test_framework/TestMWEB.h>
 
@@ -58,4 +59,118 @@ BOOST_AUTO_TEST_CASE(LeafSetTest)
     }
 }
 
+static std::vector<uint8_t> ToBytes(const std::vector<bool>& leaves)
+{
+    std::vector<uint8_t> bytes((leaves.size() + 7) / 8);
+    for (size_t i = 0; i < leaves.size(); i++) {
+        if (leaves[i]) {
+            bytes[i / 8] |= (0x80 >> (i % 8));
+        }
+    }
+
+    return bytes;
+}
+
+BOOST_AUTO_TEST_CASE(LeafSetMultiChunkRoot)
+{
+    // Root() caches BLAKE3 chaining values of 1 KiB chunks (8192 leaves),
+    // so it must match hashing the whole bitmap across chunk boundaries.
+    LeafSet::Ptr pLeafset = LeafSet::Open(GetDataDir(), 0);
+    std::vector<bool> leaves;
+
+    for (uint64_t i = 0; i < 50000; i++) {
+        pLeafset->Add(mmr::LeafIndex::At(i));
+        leaves.push_back(true);
+
+        const uint64_t num_leaves = i + 1;
+        if (num_leaves % 8192 <= 8 || num_leaves % 8192 >= 8184 || num_leaves % 997 == 0) {
+            BOOST_REQUIRE(pLeafset->Root() == Hashed(ToBytes(leaves)));
+        }
+    }
+
+    for (size_t i = 0; i < 200; i++) {
+        const uint64_t idx = InsecureRandRange(leaves.size());
+        pLeafset->Remove(mmr::LeafIndex::At(idx));
+        leaves[idx] = false;
+    }
+    BOOST_REQUIRE(pLeafset->Root() == Hashed(ToBytes(leaves)));
+
+    // Modify a cache on top of the leafset. The leafset's root must remain unchanged.
+    LeafSetCache::Ptr pCache = std::make_shared<LeafSetCache>(pLeafset);
+    std::vector<bool> cache_leaves = leaves;
+    for (uint64_t i = 50000; i < 70000; i++) {
+        pCache->Add(mmr::LeafIndex::At(i));
+        cache_leaves.push_back(true);
+    }
+
+    for (size_t i = 0; i < 200; i++) {
+        const uint64_t idx = InsecureRandRange(cache_leaves.size());
+        pCache->Remove(mmr::LeafIndex::At(idx));
+        cache_leaves[idx] = false;
+    }
+    BOOST_REQUIRE(pCache->Root() == Hashed(ToBytes(cache_leaves)));
+    BOOST_REQUIRE(pLeafset->Root() == Hashed(ToBytes(leaves)));
+
+    // Rewind the cache to the middle of a chunk, restoring a few spent leaves.
+    std::vector<mmr::LeafIndex> leaves_to_add;
+    for (uint64_t idx = 0; idx < 30000; idx++) {
+        if (!cache_leaves[idx] && leaves_to_add.size() < 10) {
+            leaves_to_add.push_back(mmr::LeafIndex::At(idx));
+            cache_leaves[idx] = true;
+        }
+    }
+
+    pCache->Rewind(30000, leaves_to_add);
+    cache_leaves.resize(30000);
+    BOOST_REQUIRE(pCache->Root() == Hashed(ToBytes(cache_leaves)));
+
+    // Flush the cache to the leafset, and then to disk.
+    pCache->Flush(1);
+    BOOST_REQUIRE(pLeafset->Root() == Hashed(ToBytes(cache_leaves)));
+    BOOST_REQUIRE(pCache->Root() == Hashed(ToBytes(cache_leaves)));
+
+    pLeafset = LeafSet::Open(GetDataDir(), 1);
+    BOOST_REQUIRE(pLeafset->Root() == Hashed(ToBytes(cache_leaves)));
+}
+
+BOOST_AUTO_TEST_CASE(LeafSetJournal)
+{
+    LeafSet::Ptr pLeafset = LeafSet::Open(GetDataDir(), 0);
+    for (uint64_t idx = 0; idx < 100; idx++) {
+        pLeafset->Add(mmr::LeafIndex::At(idx));
+    }
+    pLeafset->Flush(1);
+    const mw::Hash root1 = pLeafset->Root();
+
+    pLeafset->Remove(mmr::LeafIndex::At(5));
+    pLeafset->Remove(mmr::LeafIndex::At(6));
+    pLeafset->Remove(mmr::LeafIndex::At(50));
+    pLeafset->Add(mmr::LeafIndex::At(100));
+    pLeafset->Flush(2);
+    const mw::Hash root2 = pLeafset->Root();
+    BOOST_REQUIRE(root1 != root2);
+    BOOST_REQUIRE(FileJournal::GetUndoPath(LeafSet::GetPath(GetDataDir(), 2)).Exists());
+
+    // Reopening at file index 1 simulates a crash before MMRInfo 2 was committed.
+    pLeafset = LeafSet::Open(GetDataDir(), 1);
+    BOOST_REQUIRE(pLeafset->Root() == root1);
+    BOOST_REQUIRE(pLeafset->GetNextLeafIdx().Get() == 100);
+    BOOST_REQUIRE(!LeafSet::GetPath(GetDataDir(), 2).Exists());
+
+    pLeafset->Remove(mmr::LeafIndex::At(5));
+    pLeafset->Remove(mmr::LeafIndex::At(6));
+    pLeafset->Remove(mmr::LeafIndex::At(50));
+    pLeafset->Add(mmr::LeafIndex::At(100));
+    pLeafset->Flush(2);
+    BOOST_REQUIRE(pLeafset->Root() == root2);
+
+    pLeafset->Cleanup(2);
+    BOOST_REQUIRE(!LeafSet::GetPath(GetDataDir(), 0).Exists());
+    BOOST_REQUIRE(!LeafSet::GetPath(GetDataDir(), 1).Exists());
+    BOOST_REQUIRE(!FileJournal::GetUndoPath(LeafSet::GetPath(GetDataDir(), 2)).Exists());
+
+    pLeafset = LeafSet::Open(GetDataDir(), 2);
+    BOOST_REQUIRE(pLeafset->Root() == root2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -2,6 +2,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <mw/file/FileJournal.h>
 #include <mw/mmr/MMR.h>
 
 #include <test_framework/TestMWEB.h>
@@ -39,12 +40,14 @@ BOOST_AUTO_TEST_CASE(MMRTest)
     BOOST_REQUIRE(pmmr->GetNumLeaves() == 4);
     BOOST_REQUIRE(pmmr->GetNumNodes() == 7);
     BOOST_CHECK_EQUAL(pmmr->Root().ToHex(), "9ab6e3c4a8594b9846b39b6beefe8f704c1de720f28426ddf3898bd4f8d6e45f");
+    BOOST_REQUIRE(pmmr->GetPeaks() == std::vector<mw::Hash>{ pmmr->Root() });
 
     pmmr->Add(leaf4);
     BOOST_REQUIRE(pmmr->GetLeaf(LeafIndex::At(4)) == Leaf::Create(LeafIndex::At(4), leaf4));
     BOOST_REQUIRE(pmmr->GetNumLeaves() == 5);
     BOOST_REQUIRE(pmmr->GetNumNodes() == 8);
     BOOST_CHECK_EQUAL(pmmr->Root().ToHex(), "376ef1612abbb461ab78f317569c9a19d054f2c928c79410d50403564b91c5f7");
+    BOOST_REQUIRE(pmmr->GetPeaks() == std::vector<mw::Hash>({ pmmr->GetHash(Index::At(6)), pmmr->GetHash(Index::At(7)) }));
 
     pmmr->Rewind(4);
     BOOST_REQUIRE(pmmr->GetNumLeaves() == 4);
@@ -94,4 +97,101 @@ BOOST_AUTO_TEST_CASE(PMMRCacheTest)
     cache.Flush(1, nullptr);
 }
 
+BOOST_AUTO_TEST_CASE(MMRAddBatch)
+{
+    PMMR::Ptr pmmr = PMMR::Open('O', GetDataDir() / "mmr", 0, GetDB(), nullptr);
+    PMMRCache cache(pmmr);
+    MemMMR batch_mmr;
+    MemMMR mmr;
+
+    // Add batches of varying sizes, so they start and end at every kind of peak.
+    uint64_t num_leaves = 0;
+    for (size_t batch_size : {1, 2, 3, 7, 16, 0, 5, 33, 1, 64}) {
+        std::vector<mw::Hash> batch;
+        for (size_t i = 0; i < batch_size; i++) {
+            batch.push_back(mw::Hash(InsecureRand256().begin()));
+        }
+
+        std::vector<LeafIndex> leaf_indices = batch_mmr.AddBatch(batch);
+        cache.AddBatch(batch);
+        for (const mw::Hash& hash : batch) {
+            mmr.Add(hash);
+        }
+
+        BOOST_REQUIRE(leaf_indices.size() == batch_size);
+        for (size_t i = 0; i < batch_size; i++) {
+            BOOST_REQUIRE(leaf_indices[i] == LeafIndex::At(num_leaves + i));
+            BOOST_REQUIRE(batch_mmr.GetLeaf(leaf_indices[i]) == mmr.GetLeaf(leaf_indices[i]));
+        }
+
+        num_leaves += batch_size;
+        BOOST_REQUIRE(batch_mmr.GetNumLeaves() == num_leaves);
+        BOOST_REQUIRE(cache.GetNumLeaves() == num_leaves);
+        BOOST_REQUIRE(batch_mmr.Root() == mmr.Root());
+        BOOST_REQUIRE(cache.Root() == mmr.Root());
+    }
+
+    // Flushing batches the hashes written to the PMMR's hash file.
+    cache.Flush(1, nullptr);
+    BOOST_REQUIRE(pmmr->GetNumLeaves() == num_leaves);
+    BOOST_REQUIRE(pmmr->Root() == mmr.Root());
+}
+
+BOOST_AUTO_TEST_CASE(PMMRJournalTest)
+{
+    const FilePath mmr_dir = GetDataDir() / "mmr";
+    PMMR::Ptr pmmr = PMMR::Open('O', mmr_dir, 0, GetDB(), nullptr);
+
+    std::vector<uint8_t> leaf0({ 0, 1, 2 });
+    std::vector<uint8_t> leaf1({ 1, 2, 3 });
+    std::vector<uint8_t> leaf2({ 2, 3, 4 });
+    std::vector<uint8_t> leaf3({ 3, 4, 5 });
+    std::vector<uint8_t> leaf4({ 4, 5, 6 });
+
+    {
+        PMMRCache cache(pmmr);
+        cache.Add(leaf0);
+        cache.Add(leaf1);
+        cache.Add(leaf2);
+        cache.Add(leaf3);
+        cache.Flush(1, nullptr);
+    }
+
+    // Rewinding overwrites hashes in the shared file, so they must be journaled.
+    {
+        PMMRCache cache(pmmr);
+        cache.Rewind(3);
+        cache.Add(leaf4);
+        cache.Flush(2, nullptr);
+    }
+
+    const mw::Hash root2 = pmmr->Root();
+    BOOST_REQUIRE(PMMR::GetPath(mmr_dir, 'O', 2).Exists());
+    BOOST_REQUIRE(FileJournal::GetUndoPath(PMMR::GetPath(mmr_dir, 'O', 2)).Exists());
+
+    // Reopening at file index 1 simulates a crash before MMRInfo 2 was committed.
+    pmmr = PMMR::Open('O', mmr_dir, 1, GetDB(), nullptr);
+    BOOST_REQUIRE(pmmr->GetNumLeaves() == 4);
+    BOOST_CHECK_EQUAL(pmmr->Root().ToHex(), "9ab6e3c4a8594b9846b39b6beefe8f704c1de720f28426ddf3898bd4f8d6e45f");
+    BOOST_REQUIRE(!PMMR::GetPath(mmr_dir, 'O', 2).Exists());
+    BOOST_REQUIRE(!FileJournal::GetUndoPath(PMMR::GetPath(mmr_dir, 'O', 2)).Exists());
+
+    {
+        PMMRCache cache(pmmr);
+        cache.Rewind(3);
+        cache.Add(leaf4);
+        cache.Flush(2, nullptr);
+    }
+    BOOST_REQUIRE(pmmr->Root() == root2);
+
+    pmmr->Cleanup(2);
+    BOOST_REQUIRE(!PMMR::GetPath(mmr_dir, 'O', 0).Exists());
+    BOOST_REQUIRE(!PMMR::GetPath(mmr_dir, 'O', 1).Exists());
+    BOOST_REQUIRE(!FileJournal::GetUndoPath(PMMR::GetPath(mmr_dir, 'O', 2)).Exists());
+
+    pmmr = PMMR::Open('O', mmr_dir, 2, GetDB(), nullptr);
+    BOOST_REQUIRE(pmmr->GetNumLeaves() == 4);
+    BOOST_REQUIRE(pmmr->Root() == root2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
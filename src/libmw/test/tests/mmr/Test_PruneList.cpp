@@ -2,6 +2,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <mw/common/RankSelectBitSet.h>
 #include <mw/mmr/PruneList.h>
 
 #include <test_framework/TestMWEB.h>
@@ -23,4 +24,37 @@ BOOST_AUTO_TEST_CASE(PruneListTest)
     BOOST_REQUIRE(pPruneList->GetShift(mmr::Index::At(60)) == 15);
 }
 
+BOOST_AUTO_TEST_CASE(RankSelect)
+{
+    // Cover partial words, full superblocks, and runs of set and unset bits.
+    BitSet bits;
+    for (uint64_t i = 0; i < 5000; i++) {
+        bits.push_back(i < 1100 ? (i % 3 == 0) : (i < 2200 || InsecureRandBool()));
+    }
+
+    RankSelectBitSet indexed(bits);
+    BOOST_REQUIRE(indexed.size() == bits.size());
+    BOOST_REQUIRE(indexed.count() == bits.count());
+
+    uint64_t num_set = 0;
+    for (uint64_t i = 0; i < bits.size(); i++) {
+        BOOST_REQUIRE(indexed.test(i) == bits.test(i));
+        BOOST_REQUIRE(indexed.rank(i) == num_set);
+
+        if (bits.test(i)) {
+            BOOST_REQUIRE(indexed.select(num_set) == boost::make_optional(i));
+            ++num_set;
+        }
+    }
+
+    BOOST_REQUIRE(indexed.rank(bits.size()) == num_set);
+    BOOST_REQUIRE(!indexed.select(num_set));
+
+    // The serialized form must index the same bits.
+    RankSelectBitSet deserialized = RankSelectBitSet::From(bits.bytes());
+    for (uint64_t i = 0; i < bits.size(); i++) {
+        BOOST_REQUIRE(deserialized.rank(i) == indexed.rank(i));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -1,7 +1,76 @@
+// Copyright (c) 2022 The Litecoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <mw/node/CoinsView.h>
+#include <mw/node/BlockValidator.h>
+
+#include <test_framework/Miner.h>
+#include <test_framework/TestMWEB.h>
+
 // MW: TODO -  Write tests for CoinsViewCache::ApplyBlock using invalid blocks:
 // * Input commitment not in UTXO set
 // * Input's output pubkey doesn't match UTXO's receiver pubkey (K_o)
 // * Invalid output PMMR root
 // * Invalid output PMMR size
 // * Invalid leafset MMR root
-// * Invalid kernel excess sum
\ No newline at end of file
+// * Invalid kernel excess sum
+
+BOOST_FIXTURE_TEST_SUITE(TestCoinsView, MWEBTestingSetup)
+
+BOOST_AUTO_TEST_CASE(ApplyPrefetchedBlock)
+{
+    auto pDatabase = GetDB();
+
+    auto pDBView = mw::CoinsViewDB::Open(GetDataDir(), nullptr, pDatabase);
+    BOOST_REQUIRE(pDBView != nullptr);
+
+    test::Miner miner(GetDataDir());
+
+    // Connect a block with a pegin and flush it, so the next block spends a coin from the DB.
+    test::Tx block1_tx1 = test::Tx::CreatePegIn(1000);
+    auto block1 = miner.MineBlock(160, { block1_tx1 });
+    {
+        auto pCachedView = std::make_shared<mw::CoinsViewCache>(pDBView);
+        pCachedView->ApplyBlock(block1.GetBlock(), pCachedView->PrefetchBlock(block1.GetBlock()));
+
+        auto pBatch = pDatabase->CreateBatch();
+        pCachedView->Flush(pBatch);
+        pBatch->Commit();
+    }
+
+    test::Tx block2_tx1 = test::Tx::CreatePegOut(block1_tx1.GetOutputs().front());
+    test::Tx block2_tx2 = test::Tx::CreatePegIn(500);
+    auto block2 = miner.MineBlock(161, { block2_tx1, block2_tx2 });
+    BOOST_REQUIRE(BlockValidator::ValidateBlock(block2.GetBlock(), { block2_tx2.GetPegInCoin() }, { block2_tx1.GetPegOutCoin() }));
+
+    // Connecting with the prefetch gives the same result as connecting without it.
+    auto pPrefetchedView = std::make_shared<mw::CoinsViewCache>(pDBView);
+    mw::BlockUndo::CPtr pPrefetchedUndo = pPrefetchedView->ApplyBlock(block2.GetBlock(), pPrefetchedView->PrefetchBlock(block2.GetBlock()));
+
+    auto pSerialView = std::make_shared<mw::CoinsViewCache>(pDBView);
+    mw::BlockUndo::CPtr pSerialUndo = pSerialView->ApplyBlock(block2.GetBlock());
+
+    BOOST_CHECK(pPrefetchedView->GetOutputPMMR()->Root() == pSerialView->GetOutputPMMR()->Root());
+    BOOST_CHECK(pPrefetchedView->GetLeafSet()->Root() == pSerialView->GetLeafSet()->Root());
+    BOOST_REQUIRE(pPrefetchedUndo->GetCoinsSpent().size() == 1);
+    BOOST_REQUIRE(pSerialUndo->GetCoinsSpent().size() == 1);
+    BOOST_CHECK(pPrefetchedUndo->GetCoinsSpent().front().GetOutputID() == pSerialUndo->GetCoinsSpent().front().GetOutputID());
+    BOOST_CHECK(pPrefetchedUndo->GetCoinsSpent().front().GetLeafIndex() == pSerialUndo->GetCoinsSpent().front().GetLeafIndex());
+    BOOST_CHECK(pPrefetchedUndo->GetCoinsAdded() == pSerialUndo->GetCoinsAdded());
+
+    const mw::Hash& spent_id = block1_tx1.GetOutputs().front().GetOutputID();
+    const mw::Hash& added_id = block2_tx2.GetOutputs().front().GetOutputID();
+    BOOST_CHECK(pPrefetchedView->GetUTXOs(spent_id).empty());
+    BOOST_CHECK(pPrefetchedView->GetUTXOs(added_id).size() == 1);
+
+    // A prefetch of a different block is ignored, and an unused prefetch can be dropped.
+    auto pMismatchedView = std::make_shared<mw::CoinsViewCache>(pDBView);
+    pMismatchedView->ApplyBlock(block2.GetBlock(), pMismatchedView->PrefetchBlock(block1.GetBlock()));
+    BOOST_CHECK(pMismatchedView->GetOutputPMMR()->Root() == pSerialView->GetOutputPMMR()->Root());
+    BOOST_CHECK(pMismatchedView->GetUTXOs(spent_id).empty());
+
+    pMismatchedView->PrefetchBlock(block2.GetBlock()).reset();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -52,6 +52,11 @@ public:
         return m_pIterator->GetKey(key);
     }
 
+    bool GetValue(std::vector<uint8_t>& value) const final
+    {
+        return m_pIterator->GetValue(value);
+    }
+
     bool Valid() const final
     {
         return m_pIterator->Valid();
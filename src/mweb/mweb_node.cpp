@@ -189,11 +189,20 @@ bool Node::ValidateMWEBBlock(const CBlock& block)
     return BlockValidator::ValidateBlock(block.mweb_block.m_block, block_pegins, hogex_pegouts);
 }
 
-bool Node::ConnectBlock(const CBlock& block, const Consensus::Params& consensus_params, const CBlockIndex* pindexPrev, CBlockUndo& blockundo, mw::CoinsViewCache& mweb_view, BlockValidationState& state)
+mw::BlockPrefetch::UPtr Node::PrefetchBlock(const CBlock& block, const mw::CoinsViewCache& mweb_view)
+{
+    if (block.mweb_block.IsNull()) {
+        return nullptr;
+    }
+
+    return mweb_view.PrefetchBlock(block.mweb_block.m_block);
+}
+
+bool Node::ConnectBlock(const CBlock& block, const Consensus::Params& consensus_params, const CBlockIndex* pindexPrev, CBlockUndo& blockundo, mw::CoinsViewCache& mweb_view, BlockValidationState& state, mw::BlockPrefetch::UPtr pPrefetch)
 {
     if (!block.mweb_block.IsNull()) {
         try {
-            blockundo.mwundo = mweb_view.ApplyBlock(block.mweb_block.m_block);
+            blockundo.mwundo = mweb_view.ApplyBlock(block.mweb_block.m_block, std::move(pPrefetch));
         } catch (const std::exception& e) {
             // MWEB: Need to distinguish between invalid blocks and mutated blocks
             return state.Invalid(BlockValidationResult::BLOCK_MUTATED, "mweb-connect-failed", strprintf("MWEB::Node::ConnectBlock(): Failed to connect MWEB block: %s", e.what()));
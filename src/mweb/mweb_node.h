@@ -59,6 +59,16 @@ public:
         BlockValidationState& state
     );
 
+    /// <summary>
+    /// Starts looking up the coins spent by the extension block, and hashing its outputs, on a background thread,
+    /// so that the work overlaps with connecting the block's transparent transactions.
+    /// The MWEB view must not be used again until the prefetch is passed to ConnectBlock or destroyed.
+    /// </summary>
+    /// <param name="block">The CBlock that will be connected.</param>
+    /// <param name="mweb_view">The CoinsViewCache the block will be connected to.</param>
+    /// <returns>The pending prefetch, or nullptr if the block has no extension block.</returns>
+    static mw::BlockPrefetch::UPtr PrefetchBlock(const CBlock& block, const mw::CoinsViewCache& mweb_view);
+
     /// <summary>
     /// Applies the extension block to the end of the chain in the given view, updating the UTXO set in the process.
     /// The following rules are verified while connecting the block:
@@ -72,6 +82,7 @@ public:
     /// <param name="blockundo">The CBlockUndo which will be updated to include the MWEB undo data upon success.</param>
     /// <param name="mweb_view">The CoinsViewCache the block should be connected to.</param>
     /// <param name="state">The CValidationState to update if validation fails.</param>
+    /// <param name="pPrefetch">The optional prefetch started by PrefetchBlock.</param>
     /// <returns>True if all validation checks succeed, and the block is connected.</returns>
     static bool ConnectBlock(
         const CBlock& block,
@@ -79,7 +90,8 @@ public:
         const CBlockIndex* pindexPrev,
         CBlockUndo& blockundo,
         mw::CoinsViewCache& mweb_view,
-        BlockValidationState& state
+        BlockValidationState& state,
+        mw::BlockPrefetch::UPtr pPrefetch = nullptr
     );
 
     /// <summary>
@@ -7,56 +7,52 @@ using namespace MWEB;
 
 std::vector<mw::Coin> Wallet::RewindOutputs(const CTransaction& tx)
 {
-    std::vector<mw::Coin> coins;
-    for (const CTxOutput& txout : tx.GetOutputs()) {
-        if (txout.IsMWEB()) {
-            mw::Coin mweb_coin;
-            if (RewindOutput(tx.mweb_tx.m_transaction, txout.ToMWEB(), mweb_coin)) {
-                coins.push_back(mweb_coin);
-            }
-        }
+    if (tx.mweb_tx.IsNull()) {
+        return {};
     }
 
-    return coins;
+    return RewindOutputs(tx.mweb_tx.m_transaction->GetOutputs());
 }
 
-bool Wallet::RewindOutput(const boost::variant<mw::Block::CPtr, mw::Transaction::CPtr>& parent,
-        const mw::Hash& output_id, mw::Coin& coin)
+std::vector<mw::Coin> Wallet::RewindBlock(const mw::Block& block)
 {
-    if (GetCoin(output_id, coin)) {
-        return true;
-    }
+    return RewindOutputs(block.GetOutputs());
+}
 
+std::vector<mw::Coin> Wallet::RewindOutputs(const std::vector<Output>& outputs)
+{
     mw::Keychain::Ptr keychain = GetKeychain();
-    if (!keychain) {
-        return false;
-    }
 
-    bool rewound = false;
-    if (parent.type() == typeid(mw::Block::CPtr)) {
-        const mw::Block::CPtr& block = boost::get<mw::Block::CPtr>(parent);
-        for (const Output& output : block->GetOutputs()) {
-            if (output.GetOutputID() == output_id) {
-                rewound = keychain->RewindOutput(output, coin);
-                break;
-            }
+    // The view tag check is done in parallel, so only the few candidates are rewound here.
+    const std::vector<size_t> candidates = keychain ? keychain->FilterOutputs(outputs) : std::vector<size_t>{};
+    auto candidate_iter = candidates.cbegin();
+
+    std::vector<mw::Coin> coins;
+    std::vector<mw::Coin> rewound_coins;
+    for (size_t i = 0; i < outputs.size(); i++) {
+        const bool is_candidate = candidate_iter != candidates.cend() && *candidate_iter == i;
+        if (is_candidate) {
+            ++candidate_iter;
         }
-    } else {
-        const mw::Transaction::CPtr& tx = boost::get<mw::Transaction::CPtr>(parent);
-        for (const Output& output : tx->GetOutputs()) {
-            if (output.GetOutputID() == output_id) {
-                rewound = keychain->RewindOutput(output, coin);
-                break;
-            }
+
+        mw::Coin coin;
+        if (GetCoin(outputs[i].GetOutputID(), coin)) {
+            coins.push_back(std::move(coin));
+        } else if (is_candidate && keychain->RewindOutput(outputs[i], coin)) {
+            m_coins[coin.output_id] = coin;
+            rewound_coins.push_back(coin);
+            coins.push_back(std::move(coin));
         }
     }
 
-    if (rewound) {
-        m_coins[coin.output_id] = coin;
-        WalletBatch(m_pWallet->GetDatabase()).WriteMWEBCoin(coin);
+    if (!rewound_coins.empty()) {
+        WalletBatch batch(m_pWallet->GetDatabase());
+        for (const mw::Coin& coin : rewound_coins) {
+            batch.WriteMWEBCoin(coin);
+        }
     }
 
-    return rewound;
+    return coins;
 }
 
 bool Wallet::IsChange(const StealthAddress& address) const
@@ -10,7 +10,6 @@
 #include <streams.h>
 #include <util/strencodings.h>
 #include <boost/optional.hpp>
-#include <boost/variant.hpp>
 #include <map>
 #include <set>
 
@@ -32,16 +31,18 @@ public:
     bool GetCoin(const mw::Hash& output_id, mw::Coin& coin) const;
 
     std::vector<mw::Coin> RewindOutputs(const CTransaction& tx);
-    bool RewindOutput(
-        const boost::variant<mw::Block::CPtr, mw::Transaction::CPtr>& parent,
-        const mw::Hash& output_id,
-        mw::Coin& coin
-    );
+
+    /// <summary>
+    /// Rewinds every output in the block in a single pass, returning the coins that belong to the wallet.
+    /// Coins already known to the wallet are returned as-is. Newly found coins are also written to the wallet DB.
+    /// </summary>
+    std::vector<mw::Coin> RewindBlock(const mw::Block& block);
     StealthAddress GetStealthAddress(const uint32_t index) const;
 
     void LoadToWallet(const mw::Coin& coin);
 
 private:
+    std::vector<mw::Coin> RewindOutputs(const std::vector<Output>& outputs);
     mw::Keychain::Ptr GetKeychain() const;
 };
 
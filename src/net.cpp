@@ -36,6 +36,10 @@
 #include <poll.h>
 #endif
 
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+#endif
+
 #ifdef USE_UPNP
 #include <miniupnpc/miniupnpc.h>
 #include <miniupnpc/upnpcommands.h>
@@ -105,6 +109,14 @@ enum BindFlags {
 // The sleep time needs to be small to avoid new sockets stalling
 static const uint64_t SELECT_TIMEOUT_MILLISECONDS = 50;
 
+// typical socket buffer is 8K-64K
+static const size_t SOCKET_RECV_BUFFER_SIZE = 0x10000;
+
+#ifdef USE_EPOLL
+/** Maximum number of events collected by a single epoll_wait() call. */
+static const int MAX_EPOLL_EVENTS = 256;
+#endif
+
 const std::string NET_MESSAGE_COMMAND_OTHER = "*other*";
 
 static const uint64_t RANDOMIZER_ID_NETGROUP = 0x6c0edd8036ef4036ULL; // SHA256("netgroup")[0:8]
@@ -598,6 +610,7 @@ void CNode::copyStats(CNodeStats &stats, const std::vector<bool> &m_asmap)
     {
         LOCK(cs_vRecv);
         X(mapRecvBytesPerMsgCmd);
+        X(mapProcessTimePerMsgCmd);
         X(nRecvBytes);
     }
     X(m_legacyWhitelisted);
@@ -690,6 +703,16 @@ bool CNode::ReceiveMsgBytes(const char *pch, unsigned int nBytes, bool& complete
     return true;
 }
 
+void CNode::RecordProcessTime(const std::string& msg_type, int64_t time_us)
+{
+    LOCK(cs_vRecv);
+    mapMsgCmdSize::iterator i = mapProcessTimePerMsgCmd.find(msg_type);
+    if (i == mapProcessTimePerMsgCmd.end())
+        i = mapProcessTimePerMsgCmd.find(NET_MESSAGE_COMMAND_OTHER);
+    assert(i != mapProcessTimePerMsgCmd.end());
+    i->second += time_us;
+}
+
 int V1TransportDeserializer::readHeader(const char *pch, unsigned int nBytes)
 {
     // copy data to temporary parsing buffer
@@ -857,6 +880,62 @@ size_t CConnman::SocketSendData(CNode *pnode) const EXCLUSIVE_LOCKS_REQUIRED(pno
     return nSentSize;
 }
 
+int CConnman::SocketRecvData(CNode* pnode)
+{
+    char pchBuf[SOCKET_RECV_BUFFER_SIZE];
+    int nBytes = 0;
+    {
+        LOCK(pnode->cs_hSocket);
+        if (pnode->hSocket == INVALID_SOCKET)
+            return -1;
+        nBytes = recv(pnode->hSocket, pchBuf, sizeof(pchBuf), MSG_DONTWAIT);
+    }
+    if (nBytes > 0)
+    {
+        bool notify = false;
+        if (!pnode->ReceiveMsgBytes(pchBuf, nBytes, notify))
+            pnode->CloseSocketDisconnect();
+        RecordBytesRecv(nBytes);
+        if (notify) {
+            size_t nSizeAdded = 0;
+            auto it(pnode->vRecvMsg.begin());
+            for (; it != pnode->vRecvMsg.end(); ++it) {
+                // vRecvMsg contains only completed CNetMessage
+                // the single possible partially deserialized message are held by TransportDeserializer
+                nSizeAdded += it->m_raw_message_size;
+            }
+            {
+                LOCK(pnode->cs_vProcessMsg);
+                pnode->vProcessMsg.splice(pnode->vProcessMsg.end(), pnode->vRecvMsg, pnode->vRecvMsg.begin(), it);
+                pnode->nProcessQueueSize += nSizeAdded;
+                pnode->fPauseRecv = pnode->nProcessQueueSize > nReceiveFloodSize;
+            }
+            WakeMessageHandler();
+        }
+    }
+    else if (nBytes == 0)
+    {
+        // socket closed gracefully
+        if (!pnode->fDisconnect) {
+            LogPrint(BCLog::NET, "socket closed for peer=%d\n", pnode->GetId());
+        }
+        pnode->CloseSocketDisconnect();
+    }
+    else if (nBytes < 0)
+    {
+        // error
+        int nErr = WSAGetLastError();
+        if (nErr != WSAEWOULDBLOCK && nErr != WSAEMSGSIZE && nErr != WSAEINTR && nErr != WSAEINPROGRESS)
+        {
+            if (!pnode->fDisconnect) {
+                LogPrint(BCLog::NET, "socket recv error for peer=%d: %s\n", pnode->GetId(), NetworkErrorString(nErr));
+            }
+            pnode->CloseSocketDisconnect();
+        }
+    }
+    return nBytes;
+}
+
 struct NodeEvictionCandidate
 {
     NodeId id;
@@ -1154,6 +1233,7 @@ void CConnman::AcceptConnection(const ListenSocket& hListenSocket) {
     {
         LOCK(cs_vNodes);
         vNodes.push_back(pnode);
+        RegisterNodeSocket(pnode);
     }
 
     // We received a new connection, harvest entropy from the time (and our peer count)
@@ -1266,6 +1346,49 @@ void CConnman::InactivityCheck(CNode *pnode)
     }
 }
 
+std::string SocketEventsModeToString(SocketEventsMode mode)
+{
+    switch (mode) {
+    case SocketEventsMode::SELECT: return "select";
+    case SocketEventsMode::POLL: return "poll";
+    case SocketEventsMode::EPOLL: return "epoll";
+    } // no default case, so the compiler can warn about missing cases
+    assert(false);
+}
+
+bool SocketEventsModeFromString(const std::string& str, SocketEventsMode& mode)
+{
+#ifdef USE_EPOLL
+    if (str == "epoll") {
+        mode = SocketEventsMode::EPOLL;
+        return true;
+    }
+#endif
+#ifdef USE_POLL
+    if (str == "poll") {
+        mode = SocketEventsMode::POLL;
+        return true;
+    }
+#else
+    if (str == "select") {
+        mode = SocketEventsMode::SELECT;
+        return true;
+    }
+#endif
+    return false;
+}
+
+std::string SupportedSocketEventsModes()
+{
+#if defined(USE_EPOLL)
+    return "epoll, poll";
+#elif defined(USE_POLL)
+    return "poll";
+#else
+    return "select";
+#endif
+}
+
 bool CConnman::GenerateSelectSet(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_set, std::set<SOCKET> &error_set)
 {
     for (const ListenSocket& hListenSocket : vhListenSocket) {
@@ -1432,6 +1555,13 @@ void CConnman::SocketEvents(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_s
 
 void CConnman::SocketHandler()
 {
+#ifdef USE_EPOLL
+    if (m_epoll_fd != -1) {
+        SocketHandlerEpoll();
+        return;
+    }
+#endif
+
     std::set<SOCKET> recv_set, send_set, error_set;
     SocketEvents(recv_set, send_set, error_set);
 
@@ -1479,58 +1609,7 @@ void CConnman::SocketHandler()
         }
         if (recvSet || errorSet)
         {
-            // typical socket buffer is 8K-64K
-            char pchBuf[0x10000];
-            int nBytes = 0;
-            {
-                LOCK(pnode->cs_hSocket);
-                if (pnode->hSocket == INVALID_SOCKET)
-                    continue;
-                nBytes = recv(pnode->hSocket, pchBuf, sizeof(pchBuf), MSG_DONTWAIT);
-            }
-            if (nBytes > 0)
-            {
-                bool notify = false;
-                if (!pnode->ReceiveMsgBytes(pchBuf, nBytes, notify))
-                    pnode->CloseSocketDisconnect();
-                RecordBytesRecv(nBytes);
-                if (notify) {
-                    size_t nSizeAdded = 0;
-                    auto it(pnode->vRecvMsg.begin());
-                    for (; it != pnode->vRecvMsg.end(); ++it) {
-                        // vRecvMsg contains only completed CNetMessage
-                        // the single possible partially deserialized message are held by TransportDeserializer
-                        nSizeAdded += it->m_raw_message_size;
-                    }
-                    {
-                        LOCK(pnode->cs_vProcessMsg);
-                        pnode->vProcessMsg.splice(pnode->vProcessMsg.end(), pnode->vRecvMsg, pnode->vRecvMsg.begin(), it);
-                        pnode->nProcessQueueSize += nSizeAdded;
-                        pnode->fPauseRecv = pnode->nProcessQueueSize > nReceiveFloodSize;
-                    }
-                    WakeMessageHandler();
-                }
-            }
-            else if (nBytes == 0)
-            {
-                // socket closed gracefully
-                if (!pnode->fDisconnect) {
-                    LogPrint(BCLog::NET, "socket closed for peer=%d\n", pnode->GetId());
-                }
-                pnode->CloseSocketDisconnect();
-            }
-            else if (nBytes < 0)
-            {
-                // error
-                int nErr = WSAGetLastError();
-                if (nErr != WSAEWOULDBLOCK && nErr != WSAEMSGSIZE && nErr != WSAEINTR && nErr != WSAEINPROGRESS)
-                {
-                    if (!pnode->fDisconnect) {
-                        LogPrint(BCLog::NET, "socket recv error for peer=%d: %s\n", pnode->GetId(), NetworkErrorString(nErr));
-                    }
-                    pnode->CloseSocketDisconnect();
-                }
-            }
+            SocketRecvData(pnode);
         }
 
         //
@@ -1554,6 +1633,198 @@ void CConnman::SocketHandler()
     }
 }
 
+#ifdef USE_EPOLL
+void CConnman::SocketHandlerEpoll()
+{
+    // Don't block while nodes from the previous pass still have data to read.
+    struct epoll_event events[MAX_EPOLL_EVENTS];
+    int nEvents = epoll_wait(m_epoll_fd, events, MAX_EPOLL_EVENTS, m_epoll_pending_nodes.empty() ? SELECT_TIMEOUT_MILLISECONDS : 0);
+
+    if (interruptNet) return;
+
+    if (nEvents < 0) {
+        int nErr = errno;
+        if (nErr != EINTR) {
+            LogPrintf("socket epoll_wait error %s\n", NetworkErrorString(nErr));
+            if (!interruptNet.sleep_for(std::chrono::milliseconds(SELECT_TIMEOUT_MILLISECONDS)))
+                return;
+        }
+        nEvents = 0;
+    }
+
+    std::vector<CNode*> vNodesReady;
+    vNodesReady.swap(m_epoll_pending_nodes);
+
+    for (int i = 0; i < nEvents; i++) {
+        const struct epoll_event& event = events[i];
+
+        //
+        // Accept new connections
+        //
+        auto listen_it = std::find_if(vhListenSocket.begin(), vhListenSocket.end(),
+            [&event](const ListenSocket& hListenSocket) { return &hListenSocket == event.data.ptr; });
+        if (listen_it != vhListenSocket.end()) {
+            AcceptConnection(*listen_it);
+            continue;
+        }
+
+        // Nodes are only deleted by this thread, and only after their socket
+        // has been closed, which removes it from the epoll instance.
+        CNode* pnode = static_cast<CNode*>(event.data.ptr);
+        if (event.events & (EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP)) {
+            pnode->m_sock_recv_ready = true;
+        }
+        // On errors, also attempt to send so that a queued send fails and
+        // disconnects the peer instead of waiting for a writable edge.
+        if (event.events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) {
+            pnode->m_sock_send_ready = true;
+        }
+        if (!pnode->m_sock_pending) {
+            pnode->m_sock_pending = true;
+            pnode->AddRef();
+            vNodesReady.push_back(pnode);
+        }
+    }
+
+    // Everything else only needs a periodic look: inactivity checks, and
+    // readable nodes whose receive side has been unpaused since, for which no
+    // new edge will be reported.
+    std::vector<CNode*> vNodesCopy;
+    const int64_t nNow = GetTimeMillis();
+    if (nNow >= m_epoll_next_sweep) {
+        m_epoll_next_sweep = nNow + SELECT_TIMEOUT_MILLISECONDS;
+        LOCK(cs_vNodes);
+        vNodesCopy = vNodes;
+        for (CNode* pnode : vNodesCopy) {
+            pnode->AddRef();
+            if (!pnode->m_sock_pending && pnode->m_sock_recv_ready && !pnode->fPauseRecv) {
+                pnode->m_sock_pending = true;
+                pnode->AddRef();
+                vNodesReady.push_back(pnode);
+            }
+        }
+    }
+
+    //
+    // Service each ready socket
+    //
+    for (CNode* pnode : vNodesReady)
+    {
+        pnode->m_sock_pending = false;
+        if (interruptNet)
+            continue;
+
+        // As with select() and poll(), drain the send queue before receiving
+        // more, so that TCP flow control reaches peers that don't read.
+        bool fSendQueued;
+        {
+            LOCK(pnode->cs_vSend);
+            if (pnode->m_sock_send_ready && !pnode->vSendMsg.empty()) {
+                size_t nBytes = SocketSendData(pnode);
+                if (nBytes) {
+                    RecordBytesSent(nBytes);
+                }
+                // Whatever is left didn't fit in the socket buffer, wait for EPOLLOUT.
+                if (!pnode->vSendMsg.empty()) {
+                    pnode->m_sock_send_ready = false;
+                }
+            }
+            fSendQueued = !pnode->vSendMsg.empty();
+        }
+
+        if (!fSendQueued && pnode->m_sock_recv_ready && !pnode->fPauseRecv) {
+            // A short read means the socket buffer is empty, and the next
+            // data to arrive will be reported as a new edge.
+            if (SocketRecvData(pnode) != (int)SOCKET_RECV_BUFFER_SIZE) {
+                pnode->m_sock_recv_ready = false;
+            } else if (!pnode->fPauseRecv) {
+                pnode->m_sock_pending = true;
+                pnode->AddRef();
+                m_epoll_pending_nodes.push_back(pnode);
+            }
+        }
+    }
+
+    for (CNode* pnode : vNodesCopy)
+    {
+        if (interruptNet)
+            break;
+        InactivityCheck(pnode);
+    }
+
+    {
+        LOCK(cs_vNodes);
+        for (CNode* pnode : vNodesReady)
+            pnode->Release();
+        for (CNode* pnode : vNodesCopy)
+            pnode->Release();
+    }
+}
+#endif
+
+void CConnman::InitSocketEvents()
+{
+#ifdef USE_EPOLL
+    if (m_socket_events_mode == SocketEventsMode::EPOLL && m_epoll_fd == -1) {
+        m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (m_epoll_fd == -1) {
+            LogPrintf("Failed to create epoll instance: %s\n", NetworkErrorString(errno));
+        }
+        for (ListenSocket& hListenSocket : vhListenSocket) {
+            if (m_epoll_fd == -1) break;
+            // Listening sockets stay level-triggered: only one connection is
+            // accepted per pass, and the rest keep the socket reported.
+            struct epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.ptr = &hListenSocket;
+            if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, hListenSocket.socket, &event) != 0) {
+                LogPrintf("Failed to add listening socket to epoll instance: %s\n", NetworkErrorString(errno));
+                CloseSocketEvents();
+            }
+        }
+        if (m_epoll_fd == -1) {
+            m_socket_events_mode = SocketEventsMode::POLL;
+        }
+    }
+#endif
+    LogPrintf("Using %s for socket events\n", SocketEventsModeToString(m_socket_events_mode));
+}
+
+void CConnman::CloseSocketEvents()
+{
+#ifdef USE_EPOLL
+    for (CNode* pnode : m_epoll_pending_nodes) {
+        pnode->m_sock_pending = false;
+        pnode->Release();
+    }
+    m_epoll_pending_nodes.clear();
+    if (m_epoll_fd != -1) {
+        close(m_epoll_fd);
+        m_epoll_fd = -1;
+    }
+#endif
+}
+
+void CConnman::RegisterNodeSocket(CNode* pnode)
+{
+#ifdef USE_EPOLL
+    if (m_epoll_fd == -1) return;
+
+    // Registered while the socket is known to be open; closing it removes
+    // the registration, so the node pointer never outlives it.
+    LOCK(pnode->cs_hSocket);
+    if (pnode->hSocket == INVALID_SOCKET) return;
+
+    struct epoll_event event{};
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    event.data.ptr = pnode;
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, pnode->hSocket, &event) != 0) {
+        LogPrintf("Failed to add socket for peer=%d to epoll instance: %s\n", pnode->GetId(), NetworkErrorString(errno));
+        pnode->fDisconnect = true;
+    }
+#endif
+}
+
 void CConnman::ThreadSocketHandler()
 {
     while (!interruptNet)
@@ -2208,6 +2479,7 @@ void CConnman::OpenNetworkConnection(const CAddress& addrConnect, bool fCountFai
     {
         LOCK(cs_vNodes);
         vNodes.push_back(pnode);
+        RegisterNodeSocket(pnode);
     }
 }
 
@@ -2231,6 +2503,31 @@ void CConnman::ThreadMessageHandler()
             if (pnode->fDisconnect)
                 continue;
 
+            // A message processor thread is working on this node, and its
+            // messages have to be processed in order.
+            if (pnode->m_msgproc_busy)
+                continue;
+
+            if (m_msgproc_threads > 0 && m_msgproc->CanProcessMessagesConcurrently(pnode)) {
+                // Send first, as the node is out of our hands until the
+                // message processor thread is done with it.
+                {
+                    LOCK(pnode->cs_sendProcessing);
+                    m_msgproc->SendMessages(pnode);
+                }
+                if (flagInterruptMsgProc)
+                    return;
+
+                pnode->AddRef();
+                pnode->m_msgproc_busy = true;
+                {
+                    LOCK(m_msgproc_queue_mutex);
+                    m_msgproc_queue.push_back(pnode);
+                }
+                m_msgproc_queue_cond.notify_one();
+                continue;
+            }
+
             // Receive messages
             bool fMoreNodeWork = m_msgproc->ProcessMessages(pnode, flagInterruptMsgProc);
             fMoreWork |= (fMoreNodeWork && !pnode->fPauseSend);
@@ -2260,6 +2557,32 @@ void CConnman::ThreadMessageHandler()
     }
 }
 
+void CConnman::ThreadMessageProcessor()
+{
+    while (true)
+    {
+        CNode* pnode;
+        {
+            WAIT_LOCK(m_msgproc_queue_mutex, lock);
+            m_msgproc_queue_cond.wait(lock, [this]() EXCLUSIVE_LOCKS_REQUIRED(m_msgproc_queue_mutex) { return flagInterruptMsgProc || !m_msgproc_queue.empty(); });
+            if (flagInterruptMsgProc)
+                return;
+            pnode = m_msgproc_queue.front();
+            m_msgproc_queue.pop_front();
+        }
+
+        m_msgproc->ProcessMessages(pnode, flagInterruptMsgProc);
+
+        pnode->m_msgproc_busy = false;
+        {
+            LOCK(cs_vNodes);
+            pnode->Release();
+        }
+        // Let the message handler thread pick up the node's remaining work.
+        WakeMessageHandler();
+    }
+}
+
 bool CConnman::BindListenPort(const CService& addrBind, bilingual_str& strError, NetPermissionFlags permissions)
 {
     int nOne = 1;
@@ -2473,6 +2796,8 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
         return false;
     }
 
+    InitSocketEvents();
+
     for (const auto& strDest : connOptions.vSeedNodes) {
         AddAddrFetch(strDest);
     }
@@ -2552,6 +2877,12 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
 
     // Process messages
     threadMessageHandler = std::thread(&TraceThread<std::function<void()> >, "msghand", std::function<void()>(std::bind(&CConnman::ThreadMessageHandler, this)));
+    if (m_msgproc_threads > 0) {
+        LogPrintf("Using %d additional threads for message processing\n", m_msgproc_threads);
+    }
+    for (int i = 0; i < m_msgproc_threads; ++i) {
+        m_msgproc_workers.emplace_back(&TraceThread<std::function<void()> >, "msgproc", std::function<void()>(std::bind(&CConnman::ThreadMessageProcessor, this)));
+    }
 
     // Dump network addresses
     scheduler.scheduleEvery([this] { DumpAddresses(); }, DUMP_PEERS_INTERVAL);
@@ -2581,6 +2912,10 @@ void CConnman::Interrupt()
         flagInterruptMsgProc = true;
     }
     condMsgProc.notify_all();
+    {
+        LOCK(m_msgproc_queue_mutex);
+        m_msgproc_queue_cond.notify_all();
+    }
 
     interruptNet();
     InterruptSocks5(true);
@@ -2602,6 +2937,21 @@ void CConnman::StopThreads()
 {
     if (threadMessageHandler.joinable())
         threadMessageHandler.join();
+    for (std::thread& worker : m_msgproc_workers) {
+        if (worker.joinable())
+            worker.join();
+    }
+    m_msgproc_workers.clear();
+    {
+        // Drop the references held by nodes the workers didn't get to.
+        std::deque<CNode*> queued;
+        WITH_LOCK(m_msgproc_queue_mutex, queued.swap(m_msgproc_queue));
+        LOCK(cs_vNodes);
+        for (CNode* pnode : queued) {
+            pnode->m_msgproc_busy = false;
+            pnode->Release();
+        }
+    }
     if (threadOpenConnections.joinable())
         threadOpenConnections.join();
     if (threadOpenAddedConnections.joinable())
@@ -2637,6 +2987,8 @@ void CConnman::StopNodes()
             if (!CloseSocket(hListenSocket.socket))
                 LogPrintf("CloseSocket(hListenSocket) failed with error %s\n", NetworkErrorString(WSAGetLastError()));
 
+    CloseSocketEvents();
+
     // clean up some globals (to help leak detection)
     for (CNode* pnode : vNodes) {
         DeleteNode(pnode);
@@ -2978,9 +3330,12 @@ CNode::CNode(NodeId idIn, ServiceFlags nLocalServicesIn, int nMyStartingHeightIn
         m_addr_known = MakeUnique<CRollingBloomFilter>(5000, 0.001);
     }
 
-    for (const std::string &msg : getAllNetMessageTypes())
+    for (const std::string &msg : getAllNetMessageTypes()) {
         mapRecvBytesPerMsgCmd[msg] = 0;
+        mapProcessTimePerMsgCmd[msg] = 0;
+    }
     mapRecvBytesPerMsgCmd[NET_MESSAGE_COMMAND_OTHER] = 0;
+    mapProcessTimePerMsgCmd[NET_MESSAGE_COMMAND_OTHER] = 0;
 
     if (fLogIPs) {
         LogPrint(BCLog::NET, "Added connection to %s peer=%d\n", addrName, id);
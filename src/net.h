@@ -84,11 +84,37 @@ static const uint64_t MAX_UPLOAD_TIMEFRAME = 60 * 60 * 24;
 static const bool DEFAULT_BLOCKSONLY = false;
 /** -peertimeout default */
 static const int64_t DEFAULT_PEER_CONNECT_TIMEOUT = 60;
+/** -msgprocthreads default: threads processing messages that don't need cs_main, besides the message handler thread */
+static const int DEFAULT_MSGPROC_THREADS = 2;
+/** Maximum number of -msgprocthreads */
+static const int MAX_MSGPROC_THREADS = 16;
 
 static const bool DEFAULT_FORCEDNSSEED = false;
 static const size_t DEFAULT_MAXRECEIVEBUFFER = 5 * 1000;
 static const size_t DEFAULT_MAXSENDBUFFER    = 1 * 1000;
 
+/** How the socket handler thread waits for sockets to become ready. */
+enum class SocketEventsMode {
+    SELECT, //!< select() over socket sets rebuilt on every loop
+    POLL,   //!< poll() over socket sets rebuilt on every loop
+    EPOLL,  //!< persistent, edge-triggered epoll registrations
+};
+
+/** -socketevents default */
+#if defined(USE_EPOLL)
+static const SocketEventsMode DEFAULT_SOCKET_EVENTS_MODE = SocketEventsMode::EPOLL;
+#elif defined(USE_POLL)
+static const SocketEventsMode DEFAULT_SOCKET_EVENTS_MODE = SocketEventsMode::POLL;
+#else
+static const SocketEventsMode DEFAULT_SOCKET_EVENTS_MODE = SocketEventsMode::SELECT;
+#endif
+
+std::string SocketEventsModeToString(SocketEventsMode mode);
+/** Parse a -socketevents value. Returns false if the mode is unknown or not supported by this build. */
+bool SocketEventsModeFromString(const std::string& str, SocketEventsMode& mode);
+/** Comma-separated list of the -socketevents values supported by this build. */
+std::string SupportedSocketEventsModes();
+
 typedef int64_t NodeId;
 
 struct AddedNodeInfo
@@ -212,6 +238,8 @@ public:
         uint64_t nMaxOutboundTimeframe = 0;
         uint64_t nMaxOutboundLimit = 0;
         int64_t m_peer_connect_timeout = DEFAULT_PEER_CONNECT_TIMEOUT;
+        SocketEventsMode m_socket_events_mode = DEFAULT_SOCKET_EVENTS_MODE;
+        int m_msgproc_threads = DEFAULT_MSGPROC_THREADS;
         std::vector<std::string> vSeedNodes;
         std::vector<NetWhitelistPermissions> vWhitelistedRange;
         std::vector<NetWhitebindPermissions> vWhiteBinds;
@@ -239,6 +267,8 @@ public:
         nSendBufferMaxSize = connOptions.nSendBufferMaxSize;
         nReceiveFloodSize = connOptions.nReceiveFloodSize;
         m_peer_connect_timeout = connOptions.m_peer_connect_timeout;
+        m_socket_events_mode = connOptions.m_socket_events_mode;
+        m_msgproc_threads = connOptions.m_msgproc_threads;
         {
             LOCK(cs_totalBytesSent);
             nMaxOutboundTimeframe = connOptions.nMaxOutboundTimeframe;
@@ -425,6 +455,8 @@ private:
     void ProcessAddrFetch();
     void ThreadOpenConnections(std::vector<std::string> connect);
     void ThreadMessageHandler();
+    /** Process messages for nodes handed off by the message handler thread. */
+    void ThreadMessageProcessor();
     void AcceptConnection(const ListenSocket& hListenSocket);
     void DisconnectNodes();
     void NotifyNumConnectionsChanged();
@@ -432,6 +464,15 @@ private:
     bool GenerateSelectSet(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_set, std::set<SOCKET> &error_set);
     void SocketEvents(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_set, std::set<SOCKET> &error_set);
     void SocketHandler();
+    /** Create the epoll instance and register the listening sockets, if -socketevents=epoll. */
+    void InitSocketEvents();
+    /** Close the epoll instance and drop the nodes it still had queued. */
+    void CloseSocketEvents();
+    /** Add a new node's socket to the epoll instance, if there is one. */
+    void RegisterNodeSocket(CNode* pnode);
+#ifdef USE_EPOLL
+    void SocketHandlerEpoll();
+#endif
     void ThreadSocketHandler();
     void ThreadDNSAddressSeed();
 
@@ -457,6 +498,8 @@ private:
     NodeId GetNewNodeId();
 
     size_t SocketSendData(CNode *pnode) const;
+    /** Read once from a node's socket and hand complete messages to the message handler. Returns the result of recv(). */
+    int SocketRecvData(CNode* pnode);
     void DumpAddresses();
 
     // Network stats
@@ -486,6 +529,20 @@ private:
     // P2P timeout in seconds
     int64_t m_peer_connect_timeout;
 
+    SocketEventsMode m_socket_events_mode{DEFAULT_SOCKET_EVENTS_MODE};
+#ifdef USE_EPOLL
+    int m_epoll_fd{-1};
+    /**
+     * Nodes that still had unread data after the last pass of the socket
+     * handler. Edge-triggered epoll will not report them again, so they are
+     * serviced without waiting. Each holds a reference. Only accessed from
+     * the socket handler thread.
+     */
+    std::vector<CNode*> m_epoll_pending_nodes;
+    /** Time of the next inactivity check over all nodes, in milliseconds. */
+    int64_t m_epoll_next_sweep{0};
+#endif
+
     // Whitelisted ranges. Any node connecting from these is automatically
     // whitelisted (as well as those connecting to whitelisted binds).
     std::vector<NetWhitelistPermissions> vWhitelistedRange;
@@ -585,6 +642,16 @@ private:
     Mutex mutexMsgProc;
     std::atomic<bool> flagInterruptMsgProc{false};
 
+    /**
+     * Nodes whose next message the message handler thread has handed off to
+     * the -msgprocthreads workers. Each holds a reference and has
+     * m_msgproc_busy set until a worker is done with it.
+     */
+    std::deque<CNode*> m_msgproc_queue GUARDED_BY(m_msgproc_queue_mutex);
+    Mutex m_msgproc_queue_mutex;
+    std::condition_variable m_msgproc_queue_cond;
+    int m_msgproc_threads{DEFAULT_MSGPROC_THREADS};
+
     CThreadInterrupt interruptNet;
 
     std::thread threadDNSAddressSeed;
@@ -592,6 +659,7 @@ private:
     std::thread threadOpenAddedConnections;
     std::thread threadOpenConnections;
     std::thread threadMessageHandler;
+    std::vector<std::thread> m_msgproc_workers;
 
     /** flag for deciding to connect to an extra outbound peer,
      *  in excess of m_max_outbound_full_relay
@@ -623,6 +691,11 @@ class NetEventsInterface
 public:
     virtual bool ProcessMessages(CNode* pnode, std::atomic<bool>& interrupt) = 0;
     virtual bool SendMessages(CNode* pnode) = 0;
+    /**
+     * Whether the next unit of work ProcessMessages would do for this node
+     * can run on a message processor thread, concurrently with other nodes.
+     */
+    virtual bool CanProcessMessagesConcurrently(CNode* pnode) = 0;
     virtual void InitializeNode(CNode* pnode) = 0;
     virtual void FinalizeNode(const CNode& node, bool& update_connection_time) = 0;
 
@@ -707,6 +780,7 @@ public:
     mapMsgCmdSize mapSendBytesPerMsgCmd;
     uint64_t nRecvBytes;
     mapMsgCmdSize mapRecvBytesPerMsgCmd;
+    mapMsgCmdSize mapProcessTimePerMsgCmd;
     NetPermissionFlags m_permissionFlags;
     bool m_legacyWhitelisted;
     int64_t m_ping_usec;
@@ -904,6 +978,15 @@ public:
     const uint64_t nKeyedNetGroup;
     std::atomic_bool fPauseRecv{false};
     std::atomic_bool fPauseSend{false};
+    // Set while a message processor thread is working on this node, during
+    // which the message handler thread leaves it alone.
+    std::atomic_bool m_msgproc_busy{false};
+
+    // Readiness last reported by epoll, which only signals changes. Only
+    // accessed from the socket handler thread.
+    bool m_sock_recv_ready{false};
+    bool m_sock_send_ready{false};
+    bool m_sock_pending{false};
 
     bool IsOutboundOrBlockRelayConn() const {
         switch (m_conn_type) {
@@ -980,14 +1063,18 @@ public:
 protected:
     mapMsgCmdSize mapSendBytesPerMsgCmd;
     mapMsgCmdSize mapRecvBytesPerMsgCmd GUARDED_BY(cs_vRecv);
+    mapMsgCmdSize mapProcessTimePerMsgCmd GUARDED_BY(cs_vRecv); // total microseconds
 
 public:
     uint256 hashContinue;
     std::atomic<int> nStartingHeight{-1};
 
     // flood relay
-    std::vector<CAddress> vAddrToSend;
-    std::unique_ptr<CRollingBloomFilter> m_addr_known{nullptr};
+    // Addresses are relayed to this peer while other peers' messages are
+    // being processed, possibly on another thread.
+    Mutex m_addr_send_mutex;
+    std::vector<CAddress> vAddrToSend GUARDED_BY(m_addr_send_mutex);
+    std::unique_ptr<CRollingBloomFilter> m_addr_known PT_GUARDED_BY(m_addr_send_mutex){nullptr};
     bool fGetAddr{false};
     std::chrono::microseconds m_next_addr_send GUARDED_BY(cs_sendProcessing){0};
     std::chrono::microseconds m_next_local_addr_send GUARDED_BY(cs_sendProcessing){0};
@@ -1119,6 +1206,8 @@ public:
     }
 
     bool ReceiveMsgBytes(const char *pch, unsigned int nBytes, bool& complete);
+    /** Account for the time spent processing a received message of the given type. */
+    void RecordProcessTime(const std::string& msg_type, int64_t time_us);
 
     void SetCommonVersion(int greatest_common_version)
     {
@@ -1148,6 +1237,7 @@ public:
 
     void AddAddressKnown(const CAddress& _addr)
     {
+        LOCK(m_addr_send_mutex);
         assert(m_addr_known);
         m_addr_known->insert(_addr.GetKey());
     }
@@ -1162,6 +1252,7 @@ public:
         // Known checking here is only to save space from duplicates.
         // SendMessages will filter it again for knowns that were added
         // after addresses were pushed.
+        LOCK(m_addr_send_mutex);
         assert(m_addr_known);
         if (_addr.IsValid() && !m_addr_known->contains(_addr.GetKey()) && addr_format_supported) {
             if (vAddrToSend.size() >= MAX_ADDR_TO_SEND) {
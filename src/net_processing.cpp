@@ -11,6 +11,7 @@
 #include <blockfilter.h>
 #include <chainparams.h>
 #include <consensus/validation.h>
+#include <crypto/common.h>
 #include <hash.h>
 #include <index/blockfilterindex.h>
 #include <merkleblock.h>
@@ -18,6 +19,7 @@
 #include <netmessagemaker.h>
 #include <policy/fees.h>
 #include <policy/policy.h>
+#include <pow.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <random.h>
@@ -333,6 +335,11 @@ struct CNodeState {
     bool fWantsCmpctWitness;
     //! Whether this peer wants MWEB transactions in cmpctblocks/blocktxns
     bool fWantsCmpctMWEB;
+    /**
+     * Whether this peer negotiated compact block version 4, where the extension block is sent as short kernel IDs.
+     * Both sides send version 4 first when they support it, so this is also whether the peer sends them to us.
+     */
+    bool fWantsCmpctMWEBShortIDs;
     /**
      * If we've announced NODE_WITNESS to this peer: whether the peer sends witnesses in cmpctblocks/blocktxns,
      * otherwise: whether this peer sends non-witnesses in cmpctblocks/blocktxns.
@@ -414,6 +421,7 @@ struct CNodeState {
         fHaveMWEB = false;
         fWantsCmpctWitness = false;
         fWantsCmpctMWEB = false;
+        fWantsCmpctMWEBShortIDs = false;
         fSupportsDesiredCmpctVersion = false;
         m_chain_sync = { 0, nullptr, false, false };
         m_last_block_announcement = 0;
@@ -617,6 +625,20 @@ static void UpdateBlockAvailability(NodeId nodeid, const uint256 &hash) EXCLUSIV
     }
 }
 
+/**
+ * The compact block version to request announcements with. Version 4 is only
+ * used with peers that negotiated it, since others would ignore the request.
+ */
+static uint64_t GetCmpctBlockVersion(const CNode& node) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+{
+    CNodeState* nodestate = State(node.GetId());
+    if (nodestate && nodestate->fWantsCmpctMWEBShortIDs) {
+        return 4;
+    }
+
+    return node.GetCmpctBlockVersion();
+}
+
 /**
  * When a peer sends us a valid block, instruct it to announce blocks to us
  * using CMPCTBLOCK if possible by adding its nodeid to the end of
@@ -641,12 +663,12 @@ static void MaybeSetPeerAsAnnouncingHeaderAndIDs(NodeId nodeid, CConnman& connma
         }
         connman.ForNode(nodeid, [&connman](CNode* pfrom) EXCLUSIVE_LOCKS_REQUIRED(::cs_main) {
             AssertLockHeld(::cs_main);
-            uint64_t nCMPCTBLOCKVersion = pfrom->GetCmpctBlockVersion();
+            uint64_t nCMPCTBLOCKVersion = GetCmpctBlockVersion(*pfrom);
             if (lNodesAnnouncingHeaderAndIDs.size() >= 3) {
                 // As per BIP152, we only get 3 of our peers to announce
                 // blocks using compact encodings.
-                connman.ForNode(lNodesAnnouncingHeaderAndIDs.front(), [&connman, nCMPCTBLOCKVersion](CNode* pnodeStop){
-                    connman.PushMessage(pnodeStop, CNetMsgMaker(pnodeStop->GetCommonVersion()).Make(NetMsgType::SENDCMPCT, /*fAnnounceUsingCMPCTBLOCK=*/false, nCMPCTBLOCKVersion));
+                connman.ForNode(lNodesAnnouncingHeaderAndIDs.front(), [&connman](CNode* pnodeStop) EXCLUSIVE_LOCKS_REQUIRED(::cs_main) {
+                    connman.PushMessage(pnodeStop, CNetMsgMaker(pnodeStop->GetCommonVersion()).Make(NetMsgType::SENDCMPCT, /*fAnnounceUsingCMPCTBLOCK=*/false, GetCmpctBlockVersion(*pnodeStop)));
                     return true;
                 });
                 lNodesAnnouncingHeaderAndIDs.pop_front();
@@ -1206,6 +1228,12 @@ PeerManager::PeerManager(const CChainParams& chainparams, CConnman& connman, Ban
     // schedule next run for 10-15 minutes in the future
     const std::chrono::milliseconds delta = std::chrono::minutes{10} + GetRandMillis(std::chrono::minutes{5});
     scheduler.scheduleFromNow([&] { ReattemptInitialBroadcast(scheduler); }, delta);
+
+    LOCK(m_msgproc_stats_mutex);
+    for (const std::string& msg_type : getAllNetMessageTypes()) {
+        m_msgproc_stats[msg_type];
+    }
+    m_msgproc_stats[NET_MESSAGE_COMMAND_OTHER];
 }
 
 /**
@@ -1332,6 +1360,7 @@ void PeerManager::NewPoWValidBlock(const CBlockIndex *pindex, const std::shared_
             bool fPeerWantsMWEB = State(pnode->GetId())->fWantsCmpctMWEB;
             int nSendFlags = fPeerWantsWitness ? 0 : SERIALIZE_TRANSACTION_NO_WITNESS;
             nSendFlags |= fPeerWantsMWEB ? 0 : SERIALIZE_NO_MWEB;
+            nSendFlags |= State(pnode->GetId())->fWantsCmpctMWEBShortIDs ? SERIALIZE_MWEB_SHORT_IDS : 0;
 
             LogPrint(BCLog::NET, "%s sending header-and-ids %s to peer=%d\n", "PeerManager::NewPoWValidBlock",
                     hashBlock.ToString(), pnode->GetId());
@@ -1545,41 +1574,70 @@ void static ProcessGetBlockData(CNode& pfrom, const CChainParams& chainparams, c
         }
     }
 
-    LOCK(cs_main);
-    const CBlockIndex* pindex = LookupBlockIndex(inv.hash);
-    if (pindex) {
-        send = BlockRequestAllowed(pindex, consensusParams);
-        if (!send) {
-            LogPrint(BCLog::NET, "%s: ignoring request from peer=%i for old block that isn't in the main chain\n", __func__, pfrom.GetId());
-        }
-    }
+    // Everything that needs cs_main is decided up front, so that the block is
+    // read from disk and serialized without holding it.
+    const CBlockIndex* pindex;
+    bool fCmpctBlockFromRecent = false;
+    bool fPeerWantsWitness = false;
+    bool fPeerWantsMWEB = false;
+    bool fPeerWantsMWEBShortIDs = false;
     const CNetMsgMaker msgMaker(pfrom.GetCommonVersion());
-    // disconnect node in case we have reached the outbound limit for serving historical blocks
-    if (send &&
-        connman.OutboundTargetReached(true) &&
-        (((pindexBestHeader != nullptr) && (pindexBestHeader->GetBlockTime() - pindex->GetBlockTime() > HISTORICAL_BLOCK_AGE)) || inv.IsMsgFilteredBlk()) &&
-        !pfrom.HasPermission(PF_DOWNLOAD) // nodes with the download permission may exceed target
-    ) {
-        LogPrint(BCLog::NET, "historical block serving limit reached, disconnect peer=%d\n", pfrom.GetId());
-
-        //disconnect node
-        pfrom.fDisconnect = true;
-        send = false;
-    }
-    // Avoid leaking prune-height by never sending blocks below the NODE_NETWORK_LIMITED threshold
-    if (send && !pfrom.HasPermission(PF_NOBAN) && (
-            (((pfrom.GetLocalServices() & NODE_NETWORK_LIMITED) == NODE_NETWORK_LIMITED) && ((pfrom.GetLocalServices() & NODE_NETWORK) != NODE_NETWORK) && (::ChainActive().Tip()->nHeight - pindex->nHeight > (int)NODE_NETWORK_LIMITED_MIN_BLOCKS + 2 /* add two blocks buffer extension for possible races */) )
-       )) {
-        LogPrint(BCLog::NET, "Ignore block request below NODE_NETWORK_LIMITED threshold from peer=%d\n", pfrom.GetId());
-
-        //disconnect node and prevent it from stalling (would otherwise wait for the missing block)
-        pfrom.fDisconnect = true;
-        send = false;
-    }
-    // Pruned nodes may have deleted the block, so check whether
-    // it's available before trying to send.
-    if (send && (pindex->nStatus & BLOCK_HAVE_DATA))
+    uint256 hashTip;
+    {
+        LOCK(cs_main);
+        pindex = LookupBlockIndex(inv.hash);
+        if (pindex) {
+            send = BlockRequestAllowed(pindex, consensusParams);
+            if (!send) {
+                LogPrint(BCLog::NET, "%s: ignoring request from peer=%i for old block that isn't in the main chain\n", __func__, pfrom.GetId());
+            }
+        }
+        // disconnect node in case we have reached the outbound limit for serving historical blocks
+        if (send &&
+            connman.OutboundTargetReached(true) &&
+            (((pindexBestHeader != nullptr) && (pindexBestHeader->GetBlockTime() - pindex->GetBlockTime() > HISTORICAL_BLOCK_AGE)) || inv.IsMsgFilteredBlk()) &&
+            !pfrom.HasPermission(PF_DOWNLOAD) // nodes with the download permission may exceed target
+        ) {
+            LogPrint(BCLog::NET, "historical block serving limit reached, disconnect peer=%d\n", pfrom.GetId());
+
+            //disconnect node
+            pfrom.fDisconnect = true;
+            send = false;
+        }
+        // Avoid leaking prune-height by never sending blocks below the NODE_NETWORK_LIMITED threshold
+        if (send && !pfrom.HasPermission(PF_NOBAN) && (
+                (((pfrom.GetLocalServices() & NODE_NETWORK_LIMITED) == NODE_NETWORK_LIMITED) && ((pfrom.GetLocalServices() & NODE_NETWORK) != NODE_NETWORK) && (::ChainActive().Tip()->nHeight - pindex->nHeight > (int)NODE_NETWORK_LIMITED_MIN_BLOCKS + 2 /* add two blocks buffer extension for possible races */) )
+           )) {
+            LogPrint(BCLog::NET, "Ignore block request below NODE_NETWORK_LIMITED threshold from peer=%d\n", pfrom.GetId());
+
+            //disconnect node and prevent it from stalling (would otherwise wait for the missing block)
+            pfrom.fDisconnect = true;
+            send = false;
+        }
+        // Pruned nodes may have deleted the block, so check whether
+        // it's available before trying to send.
+        send = send && (pindex->nStatus & BLOCK_HAVE_DATA);
+        if (send && inv.IsMsgCmpctBlk()) {
+            fPeerWantsWitness = State(pfrom.GetId())->fWantsCmpctWitness;
+            fPeerWantsMWEB = State(pfrom.GetId())->fWantsCmpctMWEB;
+            fPeerWantsMWEBShortIDs = State(pfrom.GetId())->fWantsCmpctMWEBShortIDs;
+            fCmpctBlockFromRecent = CanDirectFetch(consensusParams) && pindex->nHeight >= ::ChainActive().Height() - MAX_CMPCTBLOCK_DEPTH;
+        }
+        hashTip = ::ChainActive().Tip()->GetBlockHash();
+    } // release cs_main before reading the block
+
+    if (send)
     {
+        // The block may have been pruned since cs_main was released. That is
+        // not an error, but a block that should be on disk and isn't is.
+        const auto fail_read = [&]() {
+            if (WITH_LOCK(cs_main, return pindex->nStatus & BLOCK_HAVE_DATA)) {
+                assert(!"cannot load block from disk");
+            }
+            LogPrint(BCLog::NET, "Block %s was pruned before it could be sent, disconnect peer=%d\n", pindex->GetBlockHash().ToString(), pfrom.GetId());
+            pfrom.fDisconnect = true;
+        };
+
         std::shared_ptr<const CBlock> pblock;
         if (a_recent_block && a_recent_block->GetHash() == pindex->GetBlockHash()) {
             pblock = a_recent_block;
@@ -1588,15 +1646,18 @@ void static ProcessGetBlockData(CNode& pfrom, const CChainParams& chainparams, c
             // as the network format matches the format on disk
             std::vector<uint8_t> block_data;
             if (!ReadRawBlockFromDisk(block_data, pindex, chainparams.MessageStart())) {
-                assert(!"cannot load block from disk");
+                fail_read();
+                return;
             }
             connman.PushMessage(&pfrom, msgMaker.Make(NetMsgType::BLOCK, MakeSpan(block_data)));
             // Don't set pblock as we've sent the block
         } else {
             // Send block from disk
             std::shared_ptr<CBlock> pblockRead = std::make_shared<CBlock>();
-            if (!ReadBlockFromDisk(*pblockRead, pindex, consensusParams))
-                assert(!"cannot load block from disk");
+            if (!ReadBlockFromDisk(*pblockRead, pindex, consensusParams)) {
+                fail_read();
+                return;
+            }
             pblock = pblockRead;
         }
         if (pblock) {
@@ -1635,12 +1696,11 @@ void static ProcessGetBlockData(CNode& pfrom, const CChainParams& chainparams, c
                 // they won't have a useful mempool to match against a compact block,
                 // and we don't feel like constructing the object for them, so
                 // instead we respond with the full, non-compact block.
-                bool fPeerWantsWitness = State(pfrom.GetId())->fWantsCmpctWitness;
-                bool fPeerWantsMWEB = State(pfrom.GetId())->fWantsCmpctMWEB;
                 int nSendFlags = fPeerWantsWitness ? 0 : SERIALIZE_TRANSACTION_NO_WITNESS;
                 nSendFlags |= fPeerWantsMWEB ? 0 : SERIALIZE_NO_MWEB;
+                nSendFlags |= fPeerWantsMWEBShortIDs ? SERIALIZE_MWEB_SHORT_IDS : 0;
 
-                if (CanDirectFetch(consensusParams) && pindex->nHeight >= ::ChainActive().Height() - MAX_CMPCTBLOCK_DEPTH) {
+                if (fCmpctBlockFromRecent) {
                     if ((fPeerWantsWitness || !fWitnessesPresentInARecentCompactBlock) && (fPeerWantsMWEB || !fMWEBPresentInARecentCompactBlock) && a_recent_compact_block && a_recent_compact_block->header.GetHash() == pindex->GetBlockHash()) {
                         connman.PushMessage(&pfrom, msgMaker.Make(nSendFlags, NetMsgType::CMPCTBLOCK, *a_recent_compact_block));
                     } else {
@@ -1660,7 +1720,7 @@ void static ProcessGetBlockData(CNode& pfrom, const CChainParams& chainparams, c
             // and we want it right after the last block so they don't
             // wait for other stuff first.
             std::vector<CInv> vInv;
-            vInv.push_back(CInv(MSG_BLOCK, ::ChainActive().Tip()->GetBlockHash()));
+            vInv.push_back(CInv(MSG_BLOCK, hashTip));
             connman.PushMessage(&pfrom, msgMaker.Make(NetMsgType::INV, vInv));
             pfrom.hashContinue.SetNull();
         }
@@ -1809,10 +1869,43 @@ void PeerManager::SendBlockTransactions(CNode& pfrom, const CBlock& block, const
         }
         resp.txn[i] = block.vtx[req.indexes[i]];
     }
+
+    // MWEB: Send the txs containing the requested kernels. They're usually among the txs
+    // recently removed from the mempool, but if any can't be found, send the whole extension block.
+    if (!req.mweb_kernel_indexes.empty()) {
+        if (block.mweb_block.IsNull()) {
+            Misbehaving(pfrom.GetId(), 100, "getblocktxn with kernel indices for non-MWEB block");
+            return;
+        }
+
+        const std::vector<Kernel>& kernels = block.mweb_block.m_block->GetKernels();
+        std::vector<mw::Hash> kernel_ids;
+        for (const uint16_t index : req.mweb_kernel_indexes) {
+            if (index >= kernels.size()) {
+                Misbehaving(pfrom.GetId(), 100, "getblocktxn with out-of-bounds kernel indices");
+                return;
+            }
+            kernel_ids.push_back(kernels[index].GetKernelID());
+        }
+
+        std::set<uint256> txids;
+        for (const CTransactionRef& tx : m_mempool.GetTxsByKernel(kernel_ids)) {
+            if (!tx) {
+                resp.mweb_txn.clear();
+                resp.mweb_block = block.mweb_block;
+                break;
+            }
+            if (txids.insert(tx->GetHash()).second) {
+                resp.mweb_txn.push_back(tx->mweb_tx);
+            }
+        }
+    }
+
     LOCK(cs_main);
     const CNetMsgMaker msgMaker(pfrom.GetCommonVersion());
     int nSendFlags = State(pfrom.GetId())->fWantsCmpctWitness ? 0 : SERIALIZE_TRANSACTION_NO_WITNESS;
     nSendFlags |= State(pfrom.GetId())->fWantsCmpctMWEB ? 0 : SERIALIZE_NO_MWEB;
+    nSendFlags |= State(pfrom.GetId())->fWantsCmpctMWEBShortIDs ? SERIALIZE_MWEB_SHORT_IDS : 0;
 
     m_connman.PushMessage(&pfrom, msgMaker.Make(nSendFlags, NetMsgType::BLOCKTXN, resp));
 }
@@ -1829,6 +1922,7 @@ void PeerManager::ProcessHeadersMessage(CNode& pfrom, const std::vector<CBlockHe
 
     bool received_new_header = false;
     const CBlockIndex *pindexLast = nullptr;
+    size_t first_new_header = nCount;
     {
         LOCK(cs_main);
         CNodeState *nodestate = State(pfrom.GetId());
@@ -1861,12 +1955,16 @@ void PeerManager::ProcessHeadersMessage(CNode& pfrom, const std::vector<CBlockHe
         }
 
         uint256 hashLastBlock;
-        for (const CBlockHeader& header : headers) {
+        for (size_t i = 0; i < nCount; i++) {
+            const CBlockHeader& header = headers[i];
             if (!hashLastBlock.IsNull() && header.hashPrevBlock != hashLastBlock) {
                 Misbehaving(pfrom.GetId(), 20, "non-continuous headers sequence");
                 return;
             }
             hashLastBlock = header.GetHash();
+            if (first_new_header == nCount && !LookupBlockIndex(hashLastBlock)) {
+                first_new_header = i;
+            }
         }
 
         // If we don't have the last header, then they'll have given us
@@ -1876,8 +1974,19 @@ void PeerManager::ProcessHeadersMessage(CNode& pfrom, const std::vector<CBlockHe
         }
     }
 
+    // Compute the scrypt PoW hashes of the new headers in parallel, without holding cs_main.
+    // Headers we already have are skipped by AcceptBlockHeader, so their hashes are left null.
+    std::vector<uint256> pow_hashes;
+    if (nCount - first_new_header > 1) {
+        const std::vector<CBlockHeader> new_headers(headers.begin() + first_new_header, headers.end());
+        pow_hashes.resize(first_new_header);
+        for (const uint256& pow_hash : GetPoWHashes(new_headers)) {
+            pow_hashes.push_back(pow_hash);
+        }
+    }
+
     BlockValidationState state;
-    if (!m_chainman.ProcessNewBlockHeaders(headers, state, m_chainparams, &pindexLast)) {
+    if (!m_chainman.ProcessNewBlockHeaders(headers, state, m_chainparams, &pindexLast, pow_hashes.empty() ? nullptr : &pow_hashes)) {
         if (state.IsInvalid()) {
             MaybePunishNodeForBlock(pfrom.GetId(), state, via_compact_block, "invalid header received");
             return;
@@ -2097,7 +2206,7 @@ void PeerManager::ProcessOrphanTx(std::set<uint256>& orphan_work_set)
  *
  * @param[in]   peer            The peer that we received the request from
  * @param[in]   chain_params    Chain parameters
- * @param[in]   filter_type     The filter type the request is for. Must be basic filters.
+ * @param[in]   filter_type     The filter type the request is for. Must be basic or MWEB filters.
  * @param[in]   start_height    The start height for the request
  * @param[in]   stop_hash       The stop_hash for the request
  * @param[in]   max_height_diff The maximum number of items permitted to request, as specified in BIP 157
@@ -2111,8 +2220,10 @@ static bool PrepareBlockFilterRequest(CNode& peer, const CChainParams& chain_par
                                       const CBlockIndex*& stop_index,
                                       BlockFilterIndex*& filter_index)
 {
+    // MWEB filters are only served alongside basic filters, and only if their index is enabled.
     const bool supported_filter_type =
-        (filter_type == BlockFilterType::BASIC &&
+        ((filter_type == BlockFilterType::BASIC ||
+          (filter_type == BlockFilterType::MWEB && GetBlockFilterIndex(filter_type))) &&
          (peer.GetLocalServices() & NODE_COMPACT_FILTERS));
     if (!supported_filter_type) {
         LogPrint(BCLog::NET, "peer %d requested unsupported block filter type: %d\n",
@@ -2559,7 +2670,10 @@ void PeerManager::ProcessMessage(CNode& pfrom, const std::string& msg_type, CDat
             // We send this to non-NODE NETWORK peers as well, because
             // they may wish to request compact blocks from us
             bool fAnnounceUsingCMPCTBLOCK = false;
-            uint64_t nCMPCTBLOCKVersion = 3;
+            uint64_t nCMPCTBLOCKVersion = 4;
+            if (pfrom.GetLocalServices() & NODE_MWEB)
+                m_connman.PushMessage(&pfrom, msgMaker.Make(NetMsgType::SENDCMPCT, fAnnounceUsingCMPCTBLOCK, nCMPCTBLOCKVersion));
+            nCMPCTBLOCKVersion = 3;
             if (pfrom.GetLocalServices() & NODE_MWEB)
                 m_connman.PushMessage(&pfrom, msgMaker.Make(NetMsgType::SENDCMPCT, fAnnounceUsingCMPCTBLOCK, nCMPCTBLOCKVersion));
             nCMPCTBLOCKVersion = 2;
@@ -2679,19 +2793,21 @@ void PeerManager::ProcessMessage(CNode& pfrom, const std::string& msg_type, CDat
         bool fAnnounceUsingCMPCTBLOCK = false;
         uint64_t nCMPCTBLOCKVersion = 0;
         vRecv >> fAnnounceUsingCMPCTBLOCK >> nCMPCTBLOCKVersion;
-        if (nCMPCTBLOCKVersion == 1 || ((pfrom.GetLocalServices() & NODE_WITNESS) && nCMPCTBLOCKVersion == 2) || ((pfrom.GetLocalServices() & NODE_MWEB) && nCMPCTBLOCKVersion == 3)) {
+        if (nCMPCTBLOCKVersion == 1 || ((pfrom.GetLocalServices() & NODE_WITNESS) && nCMPCTBLOCKVersion == 2) || ((pfrom.GetLocalServices() & NODE_MWEB) && (nCMPCTBLOCKVersion == 3 || nCMPCTBLOCKVersion == 4))) {
             LOCK(cs_main);
             // fProvidesHeaderAndIDs is used to "lock in" version of compact blocks we send (fWantsCmpctWitness)
             if (!State(pfrom.GetId())->fProvidesHeaderAndIDs) {
                 State(pfrom.GetId())->fProvidesHeaderAndIDs = true;
                 State(pfrom.GetId())->fWantsCmpctWitness = nCMPCTBLOCKVersion >= 2;
                 State(pfrom.GetId())->fWantsCmpctMWEB = nCMPCTBLOCKVersion >= 3;
+                State(pfrom.GetId())->fWantsCmpctMWEBShortIDs = nCMPCTBLOCKVersion >= 4;
             }
-            if (State(pfrom.GetId())->fWantsCmpctWitness == (nCMPCTBLOCKVersion >= 2) && State(pfrom.GetId())->fWantsCmpctMWEB == (nCMPCTBLOCKVersion >= 3))
+            if (State(pfrom.GetId())->fWantsCmpctWitness == (nCMPCTBLOCKVersion >= 2) && State(pfrom.GetId())->fWantsCmpctMWEB == (nCMPCTBLOCKVersion >= 3) &&
+                    State(pfrom.GetId())->fWantsCmpctMWEBShortIDs == (nCMPCTBLOCKVersion >= 4))
                 State(pfrom.GetId())->fPreferHeaderAndIDs = fAnnounceUsingCMPCTBLOCK;
             if (!State(pfrom.GetId())->fSupportsDesiredCmpctVersion) {
                 if (pfrom.GetLocalServices() & NODE_MWEB)
-                    State(pfrom.GetId())->fSupportsDesiredCmpctVersion = (nCMPCTBLOCKVersion == 3); 
+                    State(pfrom.GetId())->fSupportsDesiredCmpctVersion = (nCMPCTBLOCKVersion == 3 || nCMPCTBLOCKVersion == 4);
                 else if (pfrom.GetLocalServices() & NODE_WITNESS)
                     State(pfrom.GetId())->fSupportsDesiredCmpctVersion = (nCMPCTBLOCKVersion == 2);
                 else
@@ -2868,6 +2984,10 @@ void PeerManager::ProcessMessage(CNode& pfrom, const std::string& msg_type, CDat
     }
 
     if (msg_type == NetMsgType::GETBLOCKTXN) {
+        if (WITH_LOCK(cs_main, return State(pfrom.GetId())->fWantsCmpctMWEBShortIDs)) {
+            vRecv.SetVersion(vRecv.GetVersion() | SERIALIZE_MWEB_SHORT_IDS);
+        }
+
         BlockTransactionsRequest req;
         vRecv >> req;
 
@@ -3217,6 +3337,9 @@ void PeerManager::ProcessMessage(CNode& pfrom, const std::string& msg_type, CDat
             if (!IsMWEBEnabled(pTip->pprev, m_chainparams.GetConsensus()) && !State(pfrom.GetId())->fWantsCmpctMWEB) {
                 vRecv.SetVersion(vRecv.GetVersion() | SERIALIZE_NO_MWEB);
             }
+            if (State(pfrom.GetId())->fWantsCmpctMWEBShortIDs) {
+                vRecv.SetVersion(vRecv.GetVersion() | SERIALIZE_MWEB_SHORT_IDS);
+            }
         }
 
         CBlockHeaderAndShortTxIDs cmpctblock;
@@ -3347,15 +3470,21 @@ void PeerManager::ProcessMessage(CNode& pfrom, const std::string& msg_type, CDat
                     if (!partialBlock.IsTxAvailable(i))
                         req.indexes.push_back(i);
                 }
-                if (req.indexes.empty()) {
+                for (size_t i = 0; i < partialBlock.BlockKernelCount(); i++) {
+                    if (!partialBlock.IsKernelAvailable(i))
+                        req.mweb_kernel_indexes.push_back(i);
+                }
+                if (req.indexes.empty() && req.mweb_kernel_indexes.empty()) {
                     // Dirty hack to jump to BLOCKTXN code (TODO: move message handling into their own functions)
                     BlockTransactions txn;
                     txn.blockhash = cmpctblock.header.GetHash();
+                    blockTxnMsg.SetVersion(blockTxnMsg.GetVersion() | (vRecv.GetVersion() & SERIALIZE_MWEB_SHORT_IDS));
                     blockTxnMsg << txn;
                     fProcessBLOCKTXN = true;
                 } else {
                     req.blockhash = pindex->GetBlockHash();
-                    m_connman.PushMessage(&pfrom, msgMaker.Make(NetMsgType::GETBLOCKTXN, req));
+                    int nSendFlags = State(pfrom.GetId())->fWantsCmpctMWEBShortIDs ? SERIALIZE_MWEB_SHORT_IDS : 0;
+                    m_connman.PushMessage(&pfrom, msgMaker.Make(nSendFlags, NetMsgType::GETBLOCKTXN, req));
                 }
             } else {
                 // This block is either already in flight from a different
@@ -3447,6 +3576,10 @@ void PeerManager::ProcessMessage(CNode& pfrom, const std::string& msg_type, CDat
             return;
         }
 
+        if (WITH_LOCK(cs_main, return State(pfrom.GetId())->fWantsCmpctMWEBShortIDs)) {
+            vRecv.SetVersion(vRecv.GetVersion() | SERIALIZE_MWEB_SHORT_IDS);
+        }
+
         BlockTransactions resp;
         vRecv >> resp;
 
@@ -3463,7 +3596,7 @@ void PeerManager::ProcessMessage(CNode& pfrom, const std::string& msg_type, CDat
             }
 
             PartiallyDownloadedBlock& partialBlock = *it->second.second->partialBlock;
-            ReadStatus status = partialBlock.FillBlock(*pblock, resp.txn);
+            ReadStatus status = partialBlock.FillBlock(*pblock, resp.txn, resp.mweb_txn, resp.mweb_block);
             if (status == READ_STATUS_INVALID) {
                 MarkBlockAsReceived(resp.blockhash); // Reset in-flight state in case Misbehaving does not result in a disconnect
                 Misbehaving(pfrom.GetId(), 100, "invalid compact block/non-matching block transactions");
@@ -3601,7 +3734,7 @@ void PeerManager::ProcessMessage(CNode& pfrom, const std::string& msg_type, CDat
         }
         pfrom.fSentAddr = true;
 
-        pfrom.vAddrToSend.clear();
+        WITH_LOCK(pfrom.m_addr_send_mutex, pfrom.vAddrToSend.clear());
         std::vector<CAddress> vAddr;
         if (pfrom.HasPermission(PF_ADDR)) {
             vAddr = m_connman.GetAddresses(MAX_ADDR_TO_SEND, MAX_PCT_ADDR_TO_SEND);
@@ -3883,11 +4016,17 @@ bool PeerManager::ProcessMessages(CNode* pfrom, std::atomic<bool>& interruptMsgP
     {
         LOCK(peer->m_getdata_requests_mutex);
         if (!peer->m_getdata_requests.empty()) {
+            const int64_t nTimeStart = GetTimeMicros();
+            const int64_t nCsMainTimeStart = cs_main.ThreadHoldTimeMicros();
             ProcessGetData(*pfrom, *peer, m_chainparams, m_connman, m_mempool, interruptMsgProc);
+            RecordProcessTime(*pfrom, NetMsgType::GETDATA, GetTimeMicros() - nTimeStart,
+                              cs_main.ThreadHoldTimeMicros() - nCsMainTimeStart, /* queue_time_us */ nullopt);
         }
     }
 
-    {
+    // Only this peer's own messages add to its orphan work set, so checking
+    // first avoids taking cs_main when there is nothing to do.
+    if (!WITH_LOCK(g_cs_orphans, return peer->m_orphan_work_set.empty())) {
         LOCK2(cs_main, g_cs_orphans);
         if (!peer->m_orphan_work_set.empty()) {
             ProcessOrphanTx(peer->m_orphan_work_set);
@@ -3932,6 +4071,10 @@ bool PeerManager::ProcessMessages(CNode* pfrom, std::atomic<bool>& interruptMsgP
     // Message size
     unsigned int nMessageSize = msg.m_message_size;
 
+    // m_time is taken from the same (mockable) clock when the message is received.
+    const int64_t queue_time = std::max<int64_t>(0, count_microseconds(GetTime<std::chrono::microseconds>() - msg.m_time));
+    const int64_t nTimeStart = GetTimeMicros();
+    const int64_t nCsMainTimeStart = cs_main.ThreadHoldTimeMicros();
     try {
         ProcessMessage(*pfrom, msg_type, msg.m_recv, msg.m_time, interruptMsgProc);
         if (interruptMsgProc) return false;
@@ -3944,10 +4087,81 @@ bool PeerManager::ProcessMessages(CNode* pfrom, std::atomic<bool>& interruptMsgP
     } catch (...) {
         LogPrint(BCLog::NET, "%s(%s, %u bytes): Unknown exception caught\n", __func__, SanitizeString(msg_type), nMessageSize);
     }
+    RecordProcessTime(*pfrom, msg_type, GetTimeMicros() - nTimeStart, cs_main.ThreadHoldTimeMicros() - nCsMainTimeStart, queue_time);
 
     return fMoreWork;
 }
 
+bool PeerManager::CanProcessMessagesConcurrently(CNode* pnode)
+{
+    if (!pnode->fSuccessfullyConnected || pnode->fDisconnect) return false;
+
+    PeerRef peer = GetPeerRef(pnode->GetId());
+    if (peer == nullptr) return false;
+
+    // Orphan processing validates transactions.
+    if (!WITH_LOCK(g_cs_orphans, return peer->m_orphan_work_set.empty())) return false;
+
+    // Serving queued getdata requests only takes cs_main briefly.
+    if (!WITH_LOCK(peer->m_getdata_requests_mutex, return peer->m_getdata_requests.empty())) return true;
+
+    if (pnode->fPauseSend) return false;
+
+    std::string msg_type;
+    {
+        LOCK(pnode->cs_vProcessMsg);
+        if (pnode->vProcessMsg.empty()) return false;
+        msg_type = pnode->vProcessMsg.front().m_command;
+    }
+
+    // Handlers that don't touch the chain state, or only look up a block
+    // index entry under a short-lived lock. Everything else, in particular
+    // anything that validates transactions or blocks or updates CNodeState,
+    // stays on the message handler thread.
+    return msg_type == NetMsgType::GETDATA ||
+           msg_type == NetMsgType::ADDR ||
+           msg_type == NetMsgType::ADDRV2 ||
+           msg_type == NetMsgType::GETADDR ||
+           msg_type == NetMsgType::PING ||
+           msg_type == NetMsgType::PONG ||
+           msg_type == NetMsgType::GETCFILTERS ||
+           msg_type == NetMsgType::GETCFHEADERS ||
+           msg_type == NetMsgType::GETCFCHECKPT;
+}
+
+void DurationHistogram::Add(int64_t time_us)
+{
+    // The number of significant bits is the bucket whose range the duration falls in.
+    ++m_buckets[std::min<uint64_t>(CountBits(std::max<int64_t>(time_us, 0)), BUCKETS - 1)];
+}
+
+void PeerManager::RecordProcessTime(CNode& node, const std::string& msg_type, int64_t time_us, int64_t cs_main_time_us,
+                                    Optional<int64_t> queue_time_us)
+{
+    node.RecordProcessTime(msg_type, time_us);
+
+    LOCK(m_msgproc_stats_mutex);
+    auto it = m_msgproc_stats.find(msg_type);
+    if (it == m_msgproc_stats.end()) it = m_msgproc_stats.find(NET_MESSAGE_COMMAND_OTHER);
+    assert(it != m_msgproc_stats.end());
+    MsgProcStats& stats = it->second;
+    stats.time_us += time_us;
+    stats.cs_main_time_us += cs_main_time_us;
+    if (queue_time_us) {
+        stats.count++;
+        stats.queue_time_us += *queue_time_us;
+        stats.time_hist.Add(time_us);
+        stats.queue_time_hist.Add(*queue_time_us);
+        stats.cs_main_time_hist.Add(cs_main_time_us);
+    }
+}
+
+std::map<std::string, MsgProcStats> PeerManager::GetMsgProcStats() const
+{
+    LOCK(m_msgproc_stats_mutex);
+    return m_msgproc_stats;
+}
+
 void PeerManager::ConsiderEviction(CNode& pto, int64_t time_in_seconds)
 {
     AssertLockHeld(cs_main);
@@ -4164,6 +4378,7 @@ bool PeerManager::SendMessages(CNode* pto)
         //
         if (pto->RelayAddrsWithConn() && pto->m_next_addr_send < current_time) {
             pto->m_next_addr_send = PoissonNextSend(current_time, AVG_ADDRESS_BROADCAST_INTERVAL);
+            LOCK(pto->m_addr_send_mutex);
             std::vector<CAddress> vAddr;
             vAddr.reserve(pto->vAddrToSend.size());
             assert(pto->m_addr_known);
@@ -4300,6 +4515,7 @@ bool PeerManager::SendMessages(CNode* pto)
 
                     int nSendFlags = state.fWantsCmpctWitness ? 0 : SERIALIZE_TRANSACTION_NO_WITNESS;
                     nSendFlags |= state.fWantsCmpctMWEB ? 0 : SERIALIZE_NO_MWEB;
+                    nSendFlags |= state.fWantsCmpctMWEBShortIDs ? SERIALIZE_MWEB_SHORT_IDS : 0;
 
                     bool fGotBlockFromCache = false;
                     {
@@ -8,10 +8,13 @@
 
 #include <consensus/params.h>
 #include <net.h>
+#include <optional.h>
 #include <sync.h>
 #include <txrequest.h>
 #include <validationinterface.h>
 
+#include <array>
+
 class BlockTransactionsRequest;
 class BlockValidationState;
 class CBlockHeader;
@@ -20,7 +23,7 @@ class CTxMemPool;
 class ChainstateManager;
 class TxValidationState;
 
-extern RecursiveMutex cs_main;
+extern TimedRecursiveMutex cs_main;
 extern RecursiveMutex g_cs_orphans;
 
 /** Default for -maxorphantx, maximum number of orphan transactions kept in memory */
@@ -32,6 +35,35 @@ static const bool DEFAULT_PEERBLOCKFILTERS = false;
 /** Threshold for marking a node to be discouraged, e.g. disconnected and added to the discouragement filter. */
 static const int DISCOURAGEMENT_THRESHOLD{100};
 
+/** Counts of durations in power-of-two sized buckets */
+class DurationHistogram
+{
+public:
+    //! Bucket 0 counts durations under 1us, bucket i > 0 those in [2^(i-1), 2^i) us, and the last bucket anything longer.
+    static constexpr size_t BUCKETS{32};
+
+    void Add(int64_t time_us);
+    uint64_t Count(size_t bucket) const { return m_buckets[bucket]; }
+    /** The shortest duration, in microseconds, counted in a bucket */
+    static int64_t BucketStart(size_t bucket) { return bucket == 0 ? 0 : int64_t{1} << (bucket - 1); }
+
+private:
+    std::array<uint64_t, BUCKETS> m_buckets{};
+};
+
+/** Processing statistics for one message type, summed over all peers */
+struct MsgProcStats {
+    uint64_t count{0};          //!< Number of messages processed
+    int64_t time_us{0};         //!< Total time spent processing them
+    int64_t queue_time_us{0};   //!< Total time they waited between being received and processed
+    int64_t cs_main_time_us{0}; //!< Total time cs_main was held while processing them
+    //! Per-message distributions of the above. Getdata requests that are
+    //! served after their message was processed only add to the totals.
+    DurationHistogram time_hist;
+    DurationHistogram queue_time_hist;
+    DurationHistogram cs_main_time_hist;
+};
+
 class PeerManager final : public CValidationInterface, public NetEventsInterface {
 public:
     PeerManager(const CChainParams& chainparams, CConnman& connman, BanMan* banman,
@@ -73,6 +105,15 @@ public:
     * @return                      True if there is more work to be done
     */
     bool SendMessages(CNode* pto) override EXCLUSIVE_LOCKS_REQUIRED(pto->cs_sendProcessing);
+    /**
+    * Whether ProcessMessages would next serve getdata requests or process a
+    * message that doesn't need cs_main for the given node, so it can run
+    * concurrently with other nodes' messages.
+    */
+    bool CanProcessMessagesConcurrently(CNode* pnode) override;
+
+    /** Get message processing statistics per message type, summed over all peers */
+    std::map<std::string, MsgProcStats> GetMsgProcStats() const;
 
     /** Consider evicting an outbound peer based on the amount of time they've been behind our tip */
     void ConsiderEviction(CNode& pto, int64_t time_in_seconds) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
@@ -134,6 +175,15 @@ private:
     void AddTxAnnouncement(const CNode& node, const GenTxid& gtxid, std::chrono::microseconds current_time)
         EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
+    /**
+     * Account for time spent processing a message, for the peer and in total.
+     * Getdata requests left queued by their message are served later, and
+     * that time is added to the message without a queue time, and without
+     * counting it again.
+     */
+    void RecordProcessTime(CNode& node, const std::string& msg_type, int64_t time_us, int64_t cs_main_time_us,
+                           Optional<int64_t> queue_time_us);
+
     const CChainParams& m_chainparams;
     CConnman& m_connman;
     /** Pointer to this node's banman. May be nullptr - check existence before dereferencing. */
@@ -143,6 +193,9 @@ private:
     TxRequestTracker m_txrequest GUARDED_BY(::cs_main);
 
     int64_t m_stale_tip_check_time; //!< Next time to check for stale tip
+
+    mutable Mutex m_msgproc_stats_mutex;
+    std::map<std::string, MsgProcStats> m_msgproc_stats GUARDED_BY(m_msgproc_stats_mutex);
 };
 
 struct CNodeStateStats {
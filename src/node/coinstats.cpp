@@ -12,6 +12,8 @@
 #include <util/system.h>
 #include <validation.h>
 
+#include <mw/db/CoinDB.h>
+
 #include <map>
 
 static uint64_t GetBogoSize(const CScript& scriptPubKey)
@@ -52,21 +54,47 @@ static void ApplyStats(CCoinsStats& stats, std::nullptr_t, const uint256& hash,
     }
 }
 
+static void ApplyMWEBStats(CCoinsStats& stats, CHashWriter& ss, const UTXO& utxo)
+{
+    ss << utxo;
+    stats.mweb_utxos_count++;
+    stats.mweb_serialized_size += ::GetSerializeSize(utxo, PROTOCOL_VERSION);
+}
+
+static void ApplyMWEBStats(CCoinsStats& stats, std::nullptr_t, const UTXO& utxo)
+{
+    stats.mweb_utxos_count++;
+    stats.mweb_serialized_size += ::GetSerializeSize(utxo, PROTOCOL_VERSION);
+}
+
 //! Calculate statistics about the unspent transaction output set
 template <typename T>
 static bool GetUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, const std::function<void()>& interruption_point)
 {
     stats = CCoinsStats();
-    std::unique_ptr<CCoinsViewCursor> pcursor(view->Cursor());
-    assert(pcursor);
-
-    stats.hashBlock = pcursor->GetBestBlock();
+    std::unique_ptr<CCoinsViewCursor> pcursor;
+    UTXOCursor::UPtr pMWEBCursor;
     {
+        // The coins and MWEB UTXOs are in the same database. Holding cs_main
+        // while creating both cursors ensures that they see the same snapshot,
+        // since the database is only written to with cs_main held.
         LOCK(cs_main);
-        stats.nHeight = LookupBlockIndex(stats.hashBlock)->nHeight;
+        pcursor.reset(view->Cursor());
+        assert(pcursor);
+
+        stats.hashBlock = pcursor->GetBestBlock();
+        const CBlockIndex* pindex = LookupBlockIndex(stats.hashBlock);
+        stats.nHeight = pindex->nHeight;
+        stats.mweb_amount = pindex->mweb_amount;
+
+        const mw::ICoinsView::Ptr mweb_view = view->GetMWEBView();
+        if (mweb_view) {
+            pMWEBCursor = CoinDB(mweb_view->GetDatabase().get()).NewCursor();
+        }
     }
 
     PrepareHash(hash_obj, stats);
+    T mweb_hash_obj = hash_obj;
 
     uint256 prevkey;
     std::map<uint32_t, Coin> outputs;
@@ -93,6 +121,18 @@ static bool GetUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, const
 
     FinalizeHash(hash_obj, stats);
 
+    while (pMWEBCursor && pMWEBCursor->Valid()) {
+        interruption_point();
+        UTXO::CPtr pUTXO = pMWEBCursor->GetUTXO();
+        if (!pUTXO) {
+            return error("%s: unable to read MWEB UTXO", __func__);
+        }
+        ApplyMWEBStats(stats, mweb_hash_obj, *pUTXO);
+        pMWEBCursor->Next();
+    }
+
+    FinalizeMWEBHash(mweb_hash_obj, stats);
+
     stats.nDiskSize = view->EstimateSize();
     return true;
 }
@@ -123,3 +163,9 @@ static void FinalizeHash(CHashWriter& ss, CCoinsStats& stats)
     stats.hashSerialized = ss.GetHash();
 }
 static void FinalizeHash(std::nullptr_t, CCoinsStats& stats) {}
+
+static void FinalizeMWEBHash(CHashWriter& ss, CCoinsStats& stats)
+{
+    stats.mweb_hash_serialized = ss.GetHash();
+}
+static void FinalizeMWEBHash(std::nullptr_t, CCoinsStats& stats) {}
@@ -32,9 +32,17 @@ struct CCoinsStats
 
     //! The number of coins contained.
     uint64_t coins_count{0};
+
+    //! The number of MWEB UTXOs, their total serialized size, and a hash of them.
+    uint64_t mweb_utxos_count{0};
+    uint64_t mweb_serialized_size{0};
+    uint256 mweb_hash_serialized{};
+    //! The amount held in the MWEB at the best block, i.e. the value of its HogEx output.
+    CAmount mweb_amount{0};
 };
 
-//! Calculate statistics about the unspent transaction output set
+//! Calculate statistics about the unspent transaction output set, including the MWEB UTXOs.
+//! Both sets are read from a snapshot of the database, so cs_main is only held while it's taken.
 bool GetUTXOStats(CCoinsView* view, CCoinsStats& stats, const CoinStatsHashType hash_type, const std::function<void()>& interruption_point = {});
 
 #endif // BITCOIN_NODE_COINSTATS_H
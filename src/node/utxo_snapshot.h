@@ -9,6 +9,11 @@
 #include <uint256.h>
 #include <serialize.h>
 
+#include <mw/models/block/Header.h>
+#include <mw/models/crypto/Hash.h>
+
+#include <vector>
+
 //! Metadata describing a serialized version of a UTXO set from which an
 //! assumeutxo CChainState can be constructed.
 class SnapshotMetadata
@@ -38,4 +43,29 @@ public:
     SERIALIZE_METHODS(SnapshotMetadata, obj) { READWRITE(obj.m_base_blockhash, obj.m_coins_count, obj.m_nchaintx); }
 };
 
+//! Metadata describing the MWEB state of a snapshot, written after its coins
+//! and followed by m_utxos_count serialized MWEB UTXOs in output ID order.
+class SnapshotMWEBMetadata
+{
+public:
+    //! The MWEB header of the base block, or null if the MWEB isn't active yet.
+    mw::Header::CPtr m_header;
+
+    //! The serialized leafset, marking which output PMMR leaves are unspent.
+    std::vector<uint8_t> m_leafset;
+
+    //! The number of leaves in the output PMMR, and the hashes of its peaks.
+    //! These are enough to calculate its root and to append new outputs to it.
+    uint64_t m_num_outputs = 0;
+    std::vector<mw::Hash> m_output_peaks;
+
+    //! The number of MWEB UTXOs in this snapshot.
+    uint64_t m_utxos_count = 0;
+
+    SERIALIZE_METHODS(SnapshotMWEBMetadata, obj)
+    {
+        READWRITE(WrapOptionalPtr(obj.m_header), obj.m_leafset, obj.m_num_outputs, obj.m_output_peaks, obj.m_utxos_count);
+    }
+};
+
 #endif // BITCOIN_NODE_UTXO_SNAPSHOT_H
@@ -7,9 +7,15 @@
 
 #include <arith_uint256.h>
 #include <chain.h>
+#include <crypto/scrypt.h>
 #include <primitives/block.h>
 #include <uint256.h>
 
+#include <mw/crypto/CryptoCheckQueue.h>
+
+#include <algorithm>
+#include <cstring>
+
 unsigned int GetNextWorkRequired(const CBlockIndex* pindexLast, const CBlockHeader *pblock, const Consensus::Params& params)
 {
     assert(pindexLast != nullptr);
@@ -105,3 +111,55 @@ bool CheckProofOfWork(uint256 hash, unsigned int nBits, const Consensus::Params&
 
     return true;
 }
+
+// The minimum number of headers to hash per CryptoCheck, a multiple of the 8-way scrypt batch.
+static constexpr size_t MIN_HEADERS_PER_CHECK = 16;
+
+// The serialized header hashed by GetPoWHash(): nVersion through nNonce.
+static constexpr size_t POW_HEADER_SIZE = 80;
+
+// The hashes are written by scrypt straight into the result vector.
+static_assert(sizeof(uint256) == 32, "uint256 must be a plain 32-byte array");
+
+std::vector<uint256> GetPoWHashes(const std::vector<CBlockHeader>& headers)
+{
+    std::vector<uint256> hashes(headers.size());
+    if (headers.empty()) {
+        return hashes;
+    }
+
+    const size_t max_checks = (headers.size() + MIN_HEADERS_PER_CHECK - 1) / MIN_HEADERS_PER_CHECK;
+    const size_t num_checks = std::min(CryptoCheckQueue::NumThreads(), max_checks);
+    const size_t per_check = (headers.size() + num_checks - 1) / num_checks;
+
+    std::vector<CryptoCheck> checks;
+    for (size_t begin = 0; begin < headers.size(); begin += per_check) {
+        const size_t end = std::min(begin + per_check, headers.size());
+        checks.emplace_back([&headers, &hashes, begin, end]() {
+            const size_t count = end - begin;
+            std::vector<char> input(count * POW_HEADER_SIZE);
+            for (size_t i = 0; i < count; i++) {
+                // Like GetPoWHash(), hash the header fields in place.
+                memcpy(&input[i * POW_HEADER_SIZE], &headers[begin + i].nVersion, POW_HEADER_SIZE);
+            }
+
+            scrypt_1024_1_1_256_batch(input.data(), (char*)hashes[begin].begin(), count);
+            return true;
+        });
+    }
+
+    CryptoCheckQueue::Run(checks);
+    return hashes;
+}
+
+bool CheckProofOfWork(const std::vector<CBlockHeader>& headers, const Consensus::Params& params)
+{
+    const std::vector<uint256> hashes = GetPoWHashes(headers);
+    for (size_t i = 0; i < headers.size(); i++) {
+        if (!CheckProofOfWork(hashes[i], headers[i].nBits, params)) {
+            return false;
+        }
+    }
+
+    return true;
+}
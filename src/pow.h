@@ -9,6 +9,7 @@
 #include <consensus/params.h>
 
 #include <stdint.h>
+#include <vector>
 
 class CBlockHeader;
 class CBlockIndex;
@@ -20,4 +21,13 @@ unsigned int CalculateNextWorkRequired(const CBlockIndex* pindexLast, int64_t nF
 /** Check whether a block hash satisfies the proof-of-work requirement specified by nBits */
 bool CheckProofOfWork(uint256 hash, unsigned int nBits, const Consensus::Params&);
 
+/**
+ * Compute the scrypt PoW hash of every header, like CBlockHeader::GetPoWHash().
+ * The hashes are computed in batches (see scrypt_1024_1_1_256_batch), spread across the CryptoCheckQueue workers.
+ */
+std::vector<uint256> GetPoWHashes(const std::vector<CBlockHeader>& headers);
+
+/** Check whether every header's scrypt PoW hash satisfies its nBits, see GetPoWHashes() */
+bool CheckProofOfWork(const std::vector<CBlockHeader>& headers, const Consensus::Params&);
+
 #endif // BITCOIN_POW_H
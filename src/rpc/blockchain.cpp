@@ -14,6 +14,7 @@
 #include <core_io.h>
 #include <hash.h>
 #include <index/blockfilterindex.h>
+#include <index/mwebindex.h>
 #include <node/coinstats.h>
 #include <node/context.h>
 #include <node/utxo_snapshot.h>
@@ -37,6 +38,8 @@
 #include <validationinterface.h>
 #include <warnings.h>
 
+#include <mw/db/CoinDB.h>
+
 #include <stdint.h>
 
 #include <univalue.h>
@@ -163,6 +166,34 @@ UniValue blockheaderToJSON(const CBlockIndex* tip, const CBlockIndex* blockindex
     return result;
 }
 
+static UniValue MWEBOutputToJSON(const Output& output)
+{
+    UniValue objOutput(UniValue::VOBJ);
+    objOutput.pushKV("output_id", output.GetOutputID().ToHex());
+    objOutput.pushKV("commit", output.GetCommitment().ToHex());
+    objOutput.pushKV("sender_pubkey", output.GetSenderPubKey().ToHex());
+    objOutput.pushKV("receiver_pubkey", output.GetReceiverPubKey().ToHex());
+    objOutput.pushKV("range_proof", HexStr(output.GetRangeProof()->Serialized()));
+    objOutput.pushKV("message", HexStr(output.GetOutputMessage().Serialized()));
+    return objOutput;
+}
+
+static UniValue MWEBKernelToJSON(const Kernel& kernel)
+{
+    UniValue objKernel(UniValue::VOBJ);
+    objKernel.pushKV("kernel_id", kernel.GetKernelID().ToHex());
+    objKernel.pushKV("features", kernel.GetFeatures());
+    objKernel.pushKV("commit", kernel.GetCommitment().ToHex());
+    objKernel.pushKV("fee", kernel.GetFee());
+    objKernel.pushKV("lock_height", kernel.GetLockHeight());
+    objKernel.pushKV("excess", kernel.GetExcess().ToHex());
+    objKernel.pushKV("signature", kernel.GetSignature().ToHex());
+    if (!kernel.GetExtraData().empty()) {
+        objKernel.pushKV("extra_data", HexStr(kernel.GetExtraData()));
+    }
+    return objKernel;
+}
+
 UniValue blockToJSON(const CBlock& block, const CBlockIndex* tip, const CBlockIndex* blockindex, bool txDetails)
 {
     // Serialize passed information without accessing chain state of the active chain!
@@ -241,14 +272,7 @@ UniValue blockToJSON(const CBlock& block, const CBlockIndex* tip, const CBlockIn
         UniValue outputs(UniValue::VARR);
         for (const auto& output : block.mweb_block.m_block->GetOutputs()) {
             if (txDetails) {
-                UniValue objOutput(UniValue::VOBJ);
-                objOutput.pushKV("output_id", output.GetOutputID().ToHex());
-                objOutput.pushKV("commit", output.GetCommitment().ToHex());
-                objOutput.pushKV("sender_pubkey", output.GetSenderPubKey().ToHex());
-                objOutput.pushKV("receiver_pubkey", output.GetReceiverPubKey().ToHex());
-                objOutput.pushKV("range_proof", HexStr(output.GetRangeProof()->Serialized()));
-                objOutput.pushKV("message", HexStr(output.GetOutputMessage().Serialized()));
-                outputs.push_back(objOutput);
+                outputs.push_back(MWEBOutputToJSON(output));
             } else {
                 outputs.push_back(output.GetOutputID().ToHex());
             }
@@ -259,18 +283,7 @@ UniValue blockToJSON(const CBlock& block, const CBlockIndex* tip, const CBlockIn
         UniValue kernels(UniValue::VARR);
         for (const auto& kernel : block.mweb_block.m_block->GetKernels()) {
             if (txDetails) {
-                UniValue objKernel(UniValue::VOBJ);
-                objKernel.pushKV("kernel_id", kernel.GetKernelID().ToHex());
-                objKernel.pushKV("features", kernel.GetFeatures());
-                objKernel.pushKV("commit", kernel.GetCommitment().ToHex());
-                objKernel.pushKV("fee", kernel.GetFee());
-                objKernel.pushKV("lock_height", kernel.GetLockHeight());
-                objKernel.pushKV("excess", kernel.GetExcess().ToHex());
-                objKernel.pushKV("signature", kernel.GetSignature().ToHex());
-                if (!kernel.GetExtraData().empty()) {
-                    objKernel.pushKV("extra_data", HexStr(kernel.GetExtraData()));
-                }
-                kernels.push_back(objKernel);
+                kernels.push_back(MWEBKernelToJSON(kernel));
             } else {
                 kernels.push_back(kernel.GetCommitment().ToHex());
             }
@@ -1207,7 +1220,11 @@ static RPCHelpMan gettxoutsetinfo()
                         {RPCResult::Type::NUM, "bogosize", "A meaningless metric for UTXO set size"},
                         {RPCResult::Type::STR_HEX, "hash_serialized_2", "The serialized hash (only present if 'hash_serialized_2' hash_type is chosen)"},
                         {RPCResult::Type::NUM, "disk_size", "The estimated size of the chainstate on disk"},
-                        {RPCResult::Type::STR_AMOUNT, "total_amount", "The total amount"},
+                        {RPCResult::Type::STR_AMOUNT, "total_amount", "The total amount, including the amount held in the MWEB by the HogEx output"},
+                        {RPCResult::Type::NUM, "mweb_utxos", "The number of unspent MWEB outputs"},
+                        {RPCResult::Type::NUM, "mweb_serialized_size", "The total serialized size of the unspent MWEB outputs"},
+                        {RPCResult::Type::STR_HEX, "mweb_hash_serialized", "The serialized hash of the unspent MWEB outputs (only present if 'hash_serialized_2' hash_type is chosen)"},
+                        {RPCResult::Type::STR_AMOUNT, "mweb_amount", "The amount held in the MWEB"},
                     }},
                 RPCExamples{
                     HelpExampleCli("gettxoutsetinfo", "")
@@ -1235,6 +1252,12 @@ static RPCHelpMan gettxoutsetinfo()
         }
         ret.pushKV("disk_size", stats.nDiskSize);
         ret.pushKV("total_amount", ValueFromAmount(stats.nTotalAmount));
+        ret.pushKV("mweb_utxos", stats.mweb_utxos_count);
+        ret.pushKV("mweb_serialized_size", stats.mweb_serialized_size);
+        if (hash_type == CoinStatsHashType::HASH_SERIALIZED) {
+            ret.pushKV("mweb_hash_serialized", stats.mweb_hash_serialized.GetHex());
+        }
+        ret.pushKV("mweb_amount", ValueFromAmount(stats.mweb_amount));
     } else {
         throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read UTXO set");
     }
@@ -1655,6 +1678,9 @@ UniValue MempoolInfoToJSON(const CTxMemPool& pool)
     ret.pushKV("mempoolminfee", ValueFromAmount(std::max(pool.GetMinFee(maxmempool), ::minRelayTxFee).GetFeePerK()));
     ret.pushKV("minrelaytxfee", ValueFromAmount(::minRelayTxFee.GetFeePerK()));
     ret.pushKV("unbroadcastcount", uint64_t{pool.GetUnbroadcastTxs().size()});
+    ret.pushKV("mwebtxcachesize", uint64_t{pool.recentTxsByKernel.Size()});
+    ret.pushKV("mwebtxcacheusage", uint64_t{pool.recentTxsByKernel.DynamicMemoryUsage()});
+    ret.pushKV("maxmwebtxcache", uint64_t{pool.recentTxsByKernel.GetMaxSize()});
     return ret;
 }
 
@@ -1673,7 +1699,10 @@ static RPCHelpMan getmempoolinfo()
                         {RPCResult::Type::NUM, "maxmempool", "Maximum memory usage for the mempool"},
                         {RPCResult::Type::STR_AMOUNT, "mempoolminfee", "Minimum fee rate in " + CURRENCY_UNIT + "/kB for tx to be accepted. Is the maximum of minrelaytxfee and minimum mempool fee"},
                         {RPCResult::Type::STR_AMOUNT, "minrelaytxfee", "Current minimum relay fee for transactions"},
-                        {RPCResult::Type::NUM, "unbroadcastcount", "Current number of transactions that haven't passed initial broadcast yet"}
+                        {RPCResult::Type::NUM, "unbroadcastcount", "Current number of transactions that haven't passed initial broadcast yet"},
+                        {RPCResult::Type::NUM, "mwebtxcachesize", "Current number of kernels in the cache of MWEB transactions recently removed by blocks"},
+                        {RPCResult::Type::NUM, "mwebtxcacheusage", "Total memory usage of that cache"},
+                        {RPCResult::Type::NUM, "maxmwebtxcache", "Maximum memory usage of that cache"},
                     }},
                 RPCExamples{
                     HelpExampleCli("getmempoolinfo", "")
@@ -2440,6 +2469,184 @@ static RPCHelpMan scantxoutset()
     };
 }
 
+static mw::Hash ParseMWEBHashV(const UniValue& v, const std::string& name)
+{
+    std::vector<uint8_t> bytes = ParseHexV(v, name);
+    if (bytes.size() != mw::Hash::size()) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("%s must be of length %d (not %d, for '%s')", name, mw::Hash::size() * 2, bytes.size() * 2, v.get_str()));
+    }
+    return mw::Hash(std::move(bytes));
+}
+
+/** Returns the block of an mwebindex entry, or nullptr if it is no longer in the active chain. */
+static const CBlockIndex* LookupMWEBIndexBlock(const MWEBIndexEntry& entry) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+{
+    const CBlockIndex* pindex = LookupBlockIndex(entry.block_hash);
+    return pindex != nullptr && ::ChainActive().Contains(pindex) ? pindex : nullptr;
+}
+
+static UniValue MWEBIndexEntryToJSON(const CBlockIndex* pindex, const MWEBIndexEntry& entry) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+{
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("blockhash", pindex->GetBlockHash().GetHex());
+    result.pushKV("height", pindex->nHeight);
+    result.pushKV("confirmations", ::ChainActive().Height() - pindex->nHeight + 1);
+    result.pushKV("position", (uint64_t)entry.position);
+    return result;
+}
+
+static const mw::Block::CPtr& ReadMWEBBlock(const CBlockIndex* pindex, CBlock& block)
+{
+    if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Block not found on disk");
+    }
+    if (block.mweb_block.IsNull()) {
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "Block has no MWEB data. This error is unexpected and indicates index corruption.");
+    }
+    return block.mweb_block.m_block;
+}
+
+static RPCHelpMan getmwebkernel()
+{
+    return RPCHelpMan{"getmwebkernel",
+                "\nReturns the block and position of an MWEB kernel in the active chain.\n"
+                "Requires -mwebindex.\n",
+                {
+                    {"kernel_id", RPCArg::Type::STR_HEX, RPCArg::Optional::NO, "The kernel id"},
+                    {"verbose", RPCArg::Type::BOOL, /* default */ "false", "If true, also read the block from disk and return the kernel itself"},
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::STR_HEX, "blockhash", "the hash of the block that included the kernel"},
+                        {RPCResult::Type::NUM, "height", "the height of that block"},
+                        {RPCResult::Type::NUM, "confirmations", "the number of confirmations"},
+                        {RPCResult::Type::NUM, "position", "the index of the kernel in the block's MWEB kernels"},
+                        {RPCResult::Type::OBJ, "kernel", "the kernel, as in getblock (only if verbose is true)", {{RPCResult::Type::ELISION, "", ""}}},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getmwebkernel", "\"mykernelid\"")
+            + HelpExampleRpc("getmwebkernel", "\"mykernelid\", true")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    if (!g_mwebindex) {
+        throw JSONRPCError(RPC_MISC_ERROR, "MWEB index is not enabled. Use -mwebindex to enable it.");
+    }
+
+    const mw::Hash kernel_id = ParseMWEBHashV(request.params[0], "kernel_id");
+    const bool verbose = !request.params[1].isNull() && request.params[1].get_bool();
+
+    const bool index_ready = g_mwebindex->BlockUntilSyncedToCurrentChain();
+
+    MWEBIndexEntry entry;
+    const CBlockIndex* pindex = nullptr;
+    UniValue result;
+    {
+        LOCK(cs_main);
+        if (g_mwebindex->FindKernel(kernel_id, entry)) {
+            pindex = LookupMWEBIndexBlock(entry);
+        }
+        if (!pindex) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, std::string("No such kernel in the active chain") +
+                (index_ready ? "" : ". MWEB kernels are still in the process of being indexed"));
+        }
+        result = MWEBIndexEntryToJSON(pindex, entry);
+    }
+
+    if (verbose) {
+        CBlock block;
+        const mw::Block::CPtr& mweb_block = ReadMWEBBlock(pindex, block);
+        const std::vector<Kernel>& kernels = mweb_block->GetKernels();
+        if (entry.position >= kernels.size() || kernels[entry.position].GetKernelID() != kernel_id) {
+            throw JSONRPCError(RPC_INTERNAL_ERROR, "Kernel not found in block. This error is unexpected and indicates index corruption.");
+        }
+        result.pushKV("kernel", MWEBKernelToJSON(kernels[entry.position]));
+    }
+
+    return result;
+},
+    };
+}
+
+static RPCHelpMan getmwebutxo()
+{
+    return RPCHelpMan{"getmwebutxo",
+                "\nReturns the block and position of an MWEB output in the active chain, and whether it has been spent.\n"
+                "Requires -mwebindex.\n",
+                {
+                    {"output_id", RPCArg::Type::STR_HEX, RPCArg::Optional::NO, "The output id"},
+                    {"verbose", RPCArg::Type::BOOL, /* default */ "false", "If true, also read the block from disk and return the output itself"},
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::STR_HEX, "blockhash", "the hash of the block that created the output"},
+                        {RPCResult::Type::NUM, "height", "the height of that block"},
+                        {RPCResult::Type::NUM, "confirmations", "the number of confirmations"},
+                        {RPCResult::Type::NUM, "position", "the index of the output in the block's MWEB outputs"},
+                        {RPCResult::Type::BOOL, "spent", "whether the output has been spent in the active chain"},
+                        {RPCResult::Type::STR_HEX, "spent_blockhash", /* optional */ true, "the hash of the block that spent the output"},
+                        {RPCResult::Type::NUM, "spent_height", /* optional */ true, "the height of that block"},
+                        {RPCResult::Type::OBJ, "output", "the output, as in getblock (only if verbose is true)", {{RPCResult::Type::ELISION, "", ""}}},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getmwebutxo", "\"myoutputid\"")
+            + HelpExampleRpc("getmwebutxo", "\"myoutputid\", true")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    if (!g_mwebindex) {
+        throw JSONRPCError(RPC_MISC_ERROR, "MWEB index is not enabled. Use -mwebindex to enable it.");
+    }
+
+    const mw::Hash output_id = ParseMWEBHashV(request.params[0], "output_id");
+    const bool verbose = !request.params[1].isNull() && request.params[1].get_bool();
+
+    const bool index_ready = g_mwebindex->BlockUntilSyncedToCurrentChain();
+
+    MWEBIndexEntry entry;
+    const CBlockIndex* pindex = nullptr;
+    UniValue result;
+    {
+        LOCK(cs_main);
+        if (g_mwebindex->FindOutput(output_id, entry)) {
+            pindex = LookupMWEBIndexBlock(entry);
+        }
+        if (!pindex) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, std::string("No such output in the active chain") +
+                (index_ready ? "" : ". MWEB outputs are still in the process of being indexed"));
+        }
+        result = MWEBIndexEntryToJSON(pindex, entry);
+
+        // A spend recorded in a block that has since been disconnected doesn't count.
+        MWEBIndexEntry spend_entry;
+        const CBlockIndex* spend_pindex = nullptr;
+        if (g_mwebindex->FindSpend(output_id, spend_entry)) {
+            spend_pindex = LookupMWEBIndexBlock(spend_entry);
+        }
+        result.pushKV("spent", spend_pindex != nullptr);
+        if (spend_pindex) {
+            result.pushKV("spent_blockhash", spend_pindex->GetBlockHash().GetHex());
+            result.pushKV("spent_height", spend_pindex->nHeight);
+        }
+    }
+
+    if (verbose) {
+        CBlock block;
+        const mw::Block::CPtr& mweb_block = ReadMWEBBlock(pindex, block);
+        const std::vector<Output>& outputs = mweb_block->GetOutputs();
+        if (entry.position >= outputs.size() || outputs[entry.position].GetOutputID() != output_id) {
+            throw JSONRPCError(RPC_INTERNAL_ERROR, "Output not found in block. This error is unexpected and indicates index corruption.");
+        }
+        result.pushKV("output", MWEBOutputToJSON(outputs[entry.position]));
+    }
+
+    return result;
+},
+    };
+}
+
 static RPCHelpMan getblockfilter()
 {
     return RPCHelpMan{"getblockfilter",
@@ -2527,7 +2734,8 @@ static RPCHelpMan dumptxoutset()
 {
     return RPCHelpMan{
         "dumptxoutset",
-        "\nWrite the serialized UTXO set to disk.\n",
+        "\nWrite the serialized UTXO set to disk.\n"
+        "The coins are followed by the MWEB header, leafset, output PMMR peaks and UTXOs.\n",
         {
             {"path",
                 RPCArg::Type::STR,
@@ -2539,6 +2747,7 @@ static RPCHelpMan dumptxoutset()
             RPCResult::Type::OBJ, "", "",
                 {
                     {RPCResult::Type::NUM, "coins_written", "the number of coins written in the snapshot"},
+                    {RPCResult::Type::NUM, "mweb_utxos_written", "the number of MWEB UTXOs written in the snapshot"},
                     {RPCResult::Type::STR_HEX, "base_hash", "the hash of the base of the snapshot"},
                     {RPCResult::Type::NUM, "base_height", "the height of the base of the snapshot"},
                     {RPCResult::Type::STR, "path", "the absolute path that the snapshot was written to"},
@@ -2564,6 +2773,8 @@ static RPCHelpMan dumptxoutset()
     FILE* file{fsbridge::fopen(temppath, "wb")};
     CAutoFile afile{file, SER_DISK, CLIENT_VERSION};
     std::unique_ptr<CCoinsViewCursor> pcursor;
+    UTXOCursor::UPtr pMWEBCursor;
+    SnapshotMWEBMetadata mweb_metadata;
     CCoinsStats stats;
     CBlockIndex* tip;
     NodeContext& node = EnsureNodeContext(request.context);
@@ -2592,6 +2803,17 @@ static RPCHelpMan dumptxoutset()
         pcursor = std::unique_ptr<CCoinsViewCursor>(::ChainstateActive().CoinsDB().Cursor());
         tip = LookupBlockIndex(stats.hashBlock);
         CHECK_NONFATAL(tip);
+
+        // The leafset and PMMR live in their own files rather than in leveldb,
+        // so they're read while cs_main still prevents them from being updated.
+        const mw::ICoinsView::Ptr mweb_view = ::ChainstateActive().CoinsDB().GetMWEBView();
+        CHECK_NONFATAL(mweb_view);
+        pMWEBCursor = CoinDB(mweb_view->GetDatabase().get()).NewCursor();
+        mweb_metadata.m_header = tip->mweb_header;
+        mweb_metadata.m_leafset = mweb_view->GetLeafSet()->ToBitSet().bytes();
+        mweb_metadata.m_num_outputs = mweb_view->GetOutputPMMR()->GetNumLeaves();
+        mweb_metadata.m_output_peaks = mweb_view->GetOutputPMMR()->GetPeaks();
+        mweb_metadata.m_utxos_count = stats.mweb_utxos_count;
     }
 
     SnapshotMetadata metadata{tip->GetBlockHash(), stats.coins_count, tip->nChainTx};
@@ -2613,11 +2835,25 @@ static RPCHelpMan dumptxoutset()
         pcursor->Next();
     }
 
+    afile << mweb_metadata;
+
+    while (pMWEBCursor->Valid()) {
+        if (iter % 5000 == 0) node.rpc_interruption_point();
+        ++iter;
+        UTXO::CPtr pUTXO = pMWEBCursor->GetUTXO();
+        if (pUTXO) {
+            afile << *pUTXO;
+        }
+
+        pMWEBCursor->Next();
+    }
+
     afile.fclose();
     fs::rename(temppath, path);
 
     UniValue result(UniValue::VOBJ);
     result.pushKV("coins_written", stats.coins_count);
+    result.pushKV("mweb_utxos_written", stats.mweb_utxos_count);
     result.pushKV("base_hash", tip->GetBlockHash().ToString());
     result.pushKV("base_height", tip->nHeight);
     result.pushKV("path", path.string());
@@ -2656,6 +2892,8 @@ static const CRPCCommand commands[] =
     { "blockchain",         "preciousblock",          &preciousblock,          {"blockhash"} },
     { "blockchain",         "scantxoutset",           &scantxoutset,           {"action", "scanobjects"} },
     { "blockchain",         "getblockfilter",         &getblockfilter,         {"blockhash", "filtertype"} },
+    { "blockchain",         "getmwebkernel",          &getmwebkernel,          {"kernel_id", "verbose"} },
+    { "blockchain",         "getmwebutxo",            &getmwebutxo,            {"output_id", "verbose"} },
 
     /* Not shown in help */
     { "hidden",             "invalidateblock",        &invalidateblock,        {"blockhash"} },
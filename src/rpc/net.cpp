@@ -159,6 +159,12 @@ static RPCHelpMan getpeerinfo()
                                                               "Only known message types can appear as keys in the object and all bytes received\n"
                                                               "of unknown message types are listed under '"+NET_MESSAGE_COMMAND_OTHER+"'."}
                             }},
+                            {RPCResult::Type::OBJ_DYN, "processtime_per_msg", "",
+                            {
+                                {RPCResult::Type::NUM, "msg", "The total time spent processing received messages, in microseconds, aggregated by message type\n"
+                                                              "When a message type is not listed in this json object, no time was spent on it.\n"
+                                                              "Unknown message types are listed under '"+NET_MESSAGE_COMMAND_OTHER+"'."}
+                            }},
                         }},
                     }},
                 },
@@ -261,6 +267,13 @@ static RPCHelpMan getpeerinfo()
                 recvPerMsgCmd.pushKV(i.first, i.second);
         }
         obj.pushKV("bytesrecv_per_msg", recvPerMsgCmd);
+
+        UniValue processTimePerMsgCmd(UniValue::VOBJ);
+        for (const auto& i : stats.mapProcessTimePerMsgCmd) {
+            if (i.second > 0)
+                processTimePerMsgCmd.pushKV(i.first, i.second);
+        }
+        obj.pushKV("processtime_per_msg", processTimePerMsgCmd);
         obj.pushKV("connection_type", stats.m_conn_type_string);
 
         ret.push_back(obj);
@@ -498,6 +511,81 @@ static RPCHelpMan getnettotals()
     };
 }
 
+static RPCHelpMan getnetmsgstats()
+{
+    return RPCHelpMan{"getnetmsgstats",
+                "\nReturns statistics about the processing of received messages, aggregated by message type over all peers\n"
+                "since the node was started. Message types that have not been processed are omitted.\n"
+                "All times are in microseconds. Histograms count messages by time, in buckets keyed by the shortest time\n"
+                "they include, each bucket ending where the next begins. Buckets without messages are omitted.\n",
+                {},
+                RPCResult{
+                    RPCResult::Type::OBJ_DYN, "", "",
+                    {
+                        {RPCResult::Type::OBJ, "msg", "The message type, or '"+NET_MESSAGE_COMMAND_OTHER+"' for unknown message types",
+                        {
+                            {RPCResult::Type::NUM, "count", "Number of messages processed"},
+                            {RPCResult::Type::NUM, "processtime", "Total time spent processing them, including getdata requests served later"},
+                            {RPCResult::Type::NUM, "queuetime", "Total time they waited between being received and processed"},
+                            {RPCResult::Type::NUM, "cs_main_time", "Total time cs_main was held while processing them"},
+                            {RPCResult::Type::OBJ, "histograms", "",
+                            {
+                                {RPCResult::Type::OBJ_DYN, "processtime", "Messages by time spent processing them",
+                                {
+                                    {RPCResult::Type::NUM, "time", "Number of messages"},
+                                }},
+                                {RPCResult::Type::OBJ_DYN, "queuetime", "Messages by time spent waiting to be processed",
+                                {
+                                    {RPCResult::Type::NUM, "time", "Number of messages"},
+                                }},
+                                {RPCResult::Type::OBJ_DYN, "cs_main_time", "Messages by time cs_main was held while processing them",
+                                {
+                                    {RPCResult::Type::NUM, "time", "Number of messages"},
+                                }},
+                            }},
+                        }},
+                    }
+                },
+                RPCExamples{
+                    HelpExampleCli("getnetmsgstats", "")
+            + HelpExampleRpc("getnetmsgstats", "")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    NodeContext& node = EnsureNodeContext(request.context);
+    if (!node.peerman)
+        throw JSONRPCError(RPC_CLIENT_P2P_DISABLED, "Error: Peer-to-peer functionality missing or disabled");
+
+    const auto histogram = [](const DurationHistogram& hist) {
+        UniValue obj(UniValue::VOBJ);
+        for (size_t bucket = 0; bucket < DurationHistogram::BUCKETS; ++bucket) {
+            if (hist.Count(bucket) > 0)
+                obj.pushKV(std::to_string(DurationHistogram::BucketStart(bucket)), hist.Count(bucket));
+        }
+        return obj;
+    };
+
+    UniValue ret(UniValue::VOBJ);
+    for (const auto& i : node.peerman->GetMsgProcStats()) {
+        const MsgProcStats& stats = i.second;
+        if (stats.count == 0) continue;
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("count", stats.count);
+        obj.pushKV("processtime", stats.time_us);
+        obj.pushKV("queuetime", stats.queue_time_us);
+        obj.pushKV("cs_main_time", stats.cs_main_time_us);
+        UniValue histograms(UniValue::VOBJ);
+        histograms.pushKV("processtime", histogram(stats.time_hist));
+        histograms.pushKV("queuetime", histogram(stats.queue_time_hist));
+        histograms.pushKV("cs_main_time", histogram(stats.cs_main_time_hist));
+        obj.pushKV("histograms", histograms);
+        ret.pushKV(i.first, obj);
+    }
+    return ret;
+},
+    };
+}
+
 static UniValue GetNetworksInfo()
 {
     UniValue networks(UniValue::VARR);
@@ -904,6 +992,7 @@ static const CRPCCommand commands[] =
     { "network",            "disconnectnode",         &disconnectnode,         {"address", "nodeid"} },
     { "network",            "getaddednodeinfo",       &getaddednodeinfo,       {"node"} },
     { "network",            "getnettotals",           &getnettotals,           {} },
+    { "network",            "getnetmsgstats",         &getnetmsgstats,         {} },
     { "network",            "getnetworkinfo",         &getnetworkinfo,         {} },
     { "network",            "setban",                 &setban,                 {"subnet", "command", "bantime", "absolute"} },
     { "network",            "listbanned",             &listbanned,             {} },
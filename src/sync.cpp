@@ -13,6 +13,7 @@
 #include <util/strencodings.h>
 #include <util/threadnames.h>
 
+#include <chrono>
 #include <map>
 #include <set>
 #include <system_error>
@@ -237,6 +238,7 @@ void AssertLockHeldInternal(const char* pszName, const char* pszFile, int nLine,
 }
 template void AssertLockHeldInternal(const char*, const char*, int, Mutex*);
 template void AssertLockHeldInternal(const char*, const char*, int, RecursiveMutex*);
+template void AssertLockHeldInternal(const char*, const char*, int, TimedRecursiveMutex*);
 
 template <typename MutexType>
 void AssertLockNotHeldInternal(const char* pszName, const char* pszFile, int nLine, MutexType* cs)
@@ -247,6 +249,7 @@ void AssertLockNotHeldInternal(const char* pszName, const char* pszFile, int nLi
 }
 template void AssertLockNotHeldInternal(const char*, const char*, int, Mutex*);
 template void AssertLockNotHeldInternal(const char*, const char*, int, RecursiveMutex*);
+template void AssertLockNotHeldInternal(const char*, const char*, int, TimedRecursiveMutex*);
 
 void DeleteLock(void* cs)
 {
@@ -281,3 +284,42 @@ bool LockStackEmpty()
 bool g_debug_lockorder_abort = true;
 
 #endif /* DEBUG_LOCKORDER */
+
+#if defined(HAVE_THREAD_LOCAL)
+namespace {
+struct ThreadHoldTime {
+    int depth{0};
+    std::chrono::steady_clock::time_point since;
+    std::chrono::steady_clock::duration total{0};
+};
+thread_local ThreadHoldTime g_thread_hold_time;
+} // namespace
+
+void HoldTimedRecursiveMutex::Acquired()
+{
+    if (g_thread_hold_time.depth++ == 0) {
+        g_thread_hold_time.since = std::chrono::steady_clock::now();
+    }
+}
+
+void HoldTimedRecursiveMutex::Released()
+{
+    if (--g_thread_hold_time.depth == 0) {
+        g_thread_hold_time.total += std::chrono::steady_clock::now() - g_thread_hold_time.since;
+    }
+}
+
+int64_t HoldTimedRecursiveMutex::ThreadHoldTimeMicros()
+{
+    auto total = g_thread_hold_time.total;
+    if (g_thread_hold_time.depth > 0) {
+        total += std::chrono::steady_clock::now() - g_thread_hold_time.since;
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(total).count();
+}
+#else
+// Hold times are not tracked without thread_local support.
+void HoldTimedRecursiveMutex::Acquired() {}
+void HoldTimedRecursiveMutex::Released() {}
+int64_t HoldTimedRecursiveMutex::ThreadHoldTimeMicros() { return 0; }
+#endif
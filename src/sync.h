@@ -124,6 +124,44 @@ using RecursiveMutex = AnnotatedMixin<std::recursive_mutex>;
 /** Wrapped mutex: supports waiting but not recursive locking */
 typedef AnnotatedMixin<std::mutex> Mutex;
 
+/**
+ * Recursive mutex that keeps count of how long each thread has held it, so
+ * that the cost of a piece of work can include its time under the lock.
+ * Nested holds, also of different mutexes of this type, are counted once.
+ */
+class HoldTimedRecursiveMutex : public std::recursive_mutex
+{
+public:
+    void lock()
+    {
+        std::recursive_mutex::lock();
+        Acquired();
+    }
+
+    void unlock()
+    {
+        Released();
+        std::recursive_mutex::unlock();
+    }
+
+    bool try_lock()
+    {
+        if (!std::recursive_mutex::try_lock()) return false;
+        Acquired();
+        return true;
+    }
+
+    /** Total time the calling thread has held mutexes of this type so far, in microseconds. */
+    static int64_t ThreadHoldTimeMicros();
+
+private:
+    static void Acquired();
+    static void Released();
+};
+
+/** Wrapped mutex: supports recursive locking, but no waiting, and accounts for hold time (used for cs_main) */
+using TimedRecursiveMutex = AnnotatedMixin<HoldTimedRecursiveMutex>;
+
 #ifdef DEBUG_LOCKCONTENTION
 void PrintLockContention(const char* pszName, const char* pszFile, int nLine);
 #endif
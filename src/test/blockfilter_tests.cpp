@@ -12,6 +12,9 @@
 #include <univalue.h>
 #include <util/strencodings.h>
 
+#include <test_framework/Miner.h>
+#include <test_framework/TxBuilder.h>
+
 #include <boost/test/unit_test.hpp>
 
 BOOST_AUTO_TEST_SUITE(blockfilter_tests)
@@ -125,6 +128,48 @@ BOOST_AUTO_TEST_CASE(blockfilter_basic_test)
     BOOST_CHECK(default_ctor_block_filter_1.GetEncodedFilter() == default_ctor_block_filter_2.GetEncodedFilter());
 }
 
+BOOST_FIXTURE_TEST_CASE(blockfilter_mweb_test, BasicTestingSetup)
+{
+    test::Miner miner(GetDataDir());
+    test::Tx pegin_tx = test::Tx::CreatePegIn(5'000'000);
+    test::Tx pegout_tx = test::Tx::CreatePegOut(pegin_tx.GetOutputs().front());
+    mw::Block::CPtr mweb_block = miner.MineBlock(1, {pegin_tx, pegout_tx}).GetBlock();
+
+    CBlock block;
+    block.mweb_block = MWEB::Block(mweb_block);
+    CBlockUndo block_undo;
+
+    auto to_element = [](const mw::Hash& hash) { return GCSFilter::Element(hash.vec().begin(), hash.vec().end()); };
+
+    std::vector<GCSFilter::Element> included_elements;
+    for (const Output& output : mweb_block->GetOutputs()) {
+        included_elements.push_back(to_element(output.GetOutputID()));
+    }
+    for (const Input& input : mweb_block->GetInputs()) {
+        included_elements.push_back(to_element(input.GetOutputID()));
+    }
+    for (const Kernel& kernel : mweb_block->GetKernels()) {
+        included_elements.push_back(to_element(kernel.GetKernelID()));
+        for (const PegOutCoin& pegout : kernel.GetPegOuts()) {
+            included_elements.emplace_back(pegout.GetScriptPubKey().begin(), pegout.GetScriptPubKey().end());
+        }
+    }
+    BOOST_CHECK(!mweb_block->GetInputs().empty());
+    BOOST_CHECK(!pegout_tx.GetPegOutCoin().GetScriptPubKey().empty());
+
+    BlockFilter mweb_filter(BlockFilterType::MWEB, block, block_undo);
+    BlockFilter basic_filter(BlockFilterType::BASIC, block, block_undo);
+    for (const GCSFilter::Element& element : included_elements) {
+        BOOST_CHECK(mweb_filter.GetFilter().Match(element));
+        BOOST_CHECK(!basic_filter.GetFilter().Match(element));
+    }
+    BOOST_CHECK(!mweb_filter.GetFilter().Match(to_element(mw::Hash(GetRandHash().begin()))));
+
+    // Blocks without MWEB data have empty MWEB filters.
+    BlockFilter empty_filter(BlockFilterType::MWEB, CBlock(), block_undo);
+    BOOST_CHECK_EQUAL(empty_filter.GetFilter().GetN(), 0U);
+}
+
 BOOST_AUTO_TEST_CASE(blockfilters_json_test)
 {
     UniValue json;
@@ -182,11 +227,14 @@ BOOST_AUTO_TEST_CASE(blockfilters_json_test)
 BOOST_AUTO_TEST_CASE(blockfilter_type_names)
 {
     BOOST_CHECK_EQUAL(BlockFilterTypeName(BlockFilterType::BASIC), "basic");
+    BOOST_CHECK_EQUAL(BlockFilterTypeName(BlockFilterType::MWEB), "mweb");
     BOOST_CHECK_EQUAL(BlockFilterTypeName(static_cast<BlockFilterType>(255)), "");
 
     BlockFilterType filter_type;
     BOOST_CHECK(BlockFilterTypeByName("basic", filter_type));
     BOOST_CHECK_EQUAL(filter_type, BlockFilterType::BASIC);
+    BOOST_CHECK(BlockFilterTypeByName("mweb", filter_type));
+    BOOST_CHECK_EQUAL(filter_type, BlockFilterType::MWEB);
 
     BOOST_CHECK(!BlockFilterTypeByName("unknown", filter_type));
 }
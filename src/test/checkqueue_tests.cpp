@@ -172,6 +172,75 @@ static void Correct_Queue_range(std::vector<size_t> range)
     tg.join_all();
 }
 
+/** Test that the checks are all run when there are more workers than worker
+ * queues, so that some workers only steal.
+ */
+BOOST_AUTO_TEST_CASE(test_CheckQueue_Correct_Few_Queues)
+{
+    auto small_queue = MakeUnique<Correct_Queue>(QUEUE_BATCH_SIZE, 1);
+    boost::thread_group tg;
+    for (auto x = 0; x < SCRIPT_CHECK_THREADS; ++x) {
+       tg.create_thread([&]{small_queue->Thread();});
+    }
+    for (const size_t i : {0, 1, 1000, 10000}) {
+        FakeCheckCheckCompletion::n_calls = 0;
+        CCheckQueueControl<FakeCheckCheckCompletion> control(small_queue.get());
+        std::vector<FakeCheckCheckCompletion> vChecks(i);
+        control.Add(vChecks);
+        BOOST_REQUIRE(control.Wait());
+        BOOST_REQUIRE_EQUAL(FakeCheckCheckCompletion::n_calls, i);
+    }
+    tg.interrupt_all();
+    tg.join_all();
+}
+
+/** Test that the stats of the last round of work are recorded
+ */
+BOOST_AUTO_TEST_CASE(test_CheckQueue_Stats)
+{
+    auto queue = MakeUnique<Correct_Queue>(QUEUE_BATCH_SIZE);
+
+    // Without any worker threads, the master runs every check itself.
+    {
+        CCheckQueueControl<FakeCheckCheckCompletion> control(queue.get());
+        std::vector<FakeCheckCheckCompletion> vChecks(100);
+        control.Add(vChecks);
+        BOOST_REQUIRE(control.Wait());
+    }
+    CCheckQueueStats stats = queue->GetLastStats();
+    BOOST_CHECK_EQUAL(stats.checks, 100U);
+    BOOST_CHECK_EQUAL(stats.workers, 1);
+    BOOST_CHECK_EQUAL(stats.steals, 0U);
+    BOOST_CHECK(stats.wait_us >= 0);
+    BOOST_CHECK(stats.wait_us <= stats.elapsed_us);
+    BOOST_CHECK(stats.idle_us <= stats.workers * stats.elapsed_us);
+
+    boost::thread_group tg;
+    for (auto x = 0; x < SCRIPT_CHECK_THREADS; ++x) {
+       tg.create_thread([&]{queue->Thread();});
+    }
+    {
+        CCheckQueueControl<FakeCheckCheckCompletion> control(queue.get());
+        for (int i = 0; i < 100; ++i) {
+            std::vector<FakeCheckCheckCompletion> vChecks(10);
+            control.Add(vChecks);
+        }
+        BOOST_REQUIRE(control.Wait());
+    }
+    stats = queue->GetLastStats();
+    BOOST_CHECK_EQUAL(stats.checks, 1000U);
+    BOOST_CHECK(stats.workers >= 1 && stats.workers <= SCRIPT_CHECK_THREADS + 1);
+    BOOST_CHECK(stats.idle_us <= stats.workers * stats.elapsed_us);
+
+    // A control without any checks resets the stats.
+    {
+        CCheckQueueControl<FakeCheckCheckCompletion> control(queue.get());
+    }
+    BOOST_CHECK_EQUAL(queue->GetLastStats().checks, 0U);
+    tg.interrupt_all();
+    tg.join_all();
+}
+
 /** Test that 0 checks is correct
  */
 BOOST_AUTO_TEST_CASE(test_CheckQueue_Correct_Zero)
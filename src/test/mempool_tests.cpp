@@ -9,6 +9,7 @@
 #include <util/time.h>
 
 #include <test/util/setup_common.h>
+#include <test_framework/models/Tx.h>
 
 #include <boost/test/unit_test.hpp>
 #include <vector>
@@ -789,4 +790,51 @@ BOOST_AUTO_TEST_CASE(MempoolAncestryTests)
     BOOST_CHECK_EQUAL(descendants, 4ULL);
 }
 
+BOOST_AUTO_TEST_CASE(MWEBTxCacheTest)
+{
+    std::vector<CTransactionRef> txs;
+    for (int i = 0; i < 64; i++) {
+        CMutableTransaction mtx;
+        mtx.mweb_tx = MWEB::Tx(test::Tx::CreatePegIn(1000 + i).GetTransaction());
+        txs.push_back(MakeTransactionRef(mtx));
+    }
+    auto kernel_id = [](const CTransactionRef& tx) { return *tx->mweb_tx.GetKernelIDs().begin(); };
+
+    MWEBTxCache cache(1 << 20);
+    for (const CTransactionRef& tx : txs) {
+        cache.Put(kernel_id(tx), tx);
+    }
+    BOOST_CHECK_EQUAL(cache.Size(), txs.size());
+    for (const CTransactionRef& tx : txs) {
+        BOOST_CHECK(cache.Get(kernel_id(tx)) == tx);
+    }
+    BOOST_CHECK(cache.Get(mw::Hash()) == nullptr);
+
+    // Replacing the transaction cached under a kernel doesn't add an entry.
+    const size_t usage = cache.DynamicMemoryUsage();
+    cache.Put(kernel_id(txs[0]), txs[1]);
+    BOOST_CHECK_EQUAL(cache.Size(), txs.size());
+    BOOST_CHECK_EQUAL(cache.DynamicMemoryUsage(), usage);
+    BOOST_CHECK(cache.Get(kernel_id(txs[0])) == txs[1]);
+
+    size_t visited = 0;
+    cache.ForEach([&](const CTransactionRef& tx) { return ++visited < 10; });
+    BOOST_CHECK_EQUAL(visited, 10U);
+
+    // Shrinking the cache evicts the oldest entries of each shard, and keeps it within its limit.
+    cache.SetMaxSize(usage / 4);
+    BOOST_CHECK_LE(cache.DynamicMemoryUsage(), usage / 4);
+    BOOST_CHECK_LT(cache.Size(), txs.size());
+    BOOST_CHECK(cache.Size() > 0);
+    for (const CTransactionRef& tx : txs) {
+        cache.Put(kernel_id(tx), tx);
+        BOOST_CHECK(cache.Get(kernel_id(tx)) == tx);
+        BOOST_CHECK_LE(cache.DynamicMemoryUsage(), usage / 4);
+    }
+
+    cache.SetMaxSize(0);
+    BOOST_CHECK_EQUAL(cache.Size(), 0U);
+    BOOST_CHECK_EQUAL(cache.DynamicMemoryUsage(), 0U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
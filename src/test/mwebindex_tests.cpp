@@ -0,0 +1,98 @@
+// Copyright (c) 2022 The Litecoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/mwebindex.h>
+#include <test/util/setup_common.h>
+#include <util/time.h>
+#include <validation.h>
+#include <validationinterface.h>
+
+#include <test_framework/Miner.h>
+#include <test_framework/TxBuilder.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(mwebindex_tests)
+
+BOOST_FIXTURE_TEST_CASE(mwebindex_initial_sync, TestChain100Setup)
+{
+    // Outlives the index, which keeps a pointer to it as its best block.
+    CBlockIndex mweb_index;
+
+    MWEBIndex mwebindex(1 << 20, true);
+
+    // BlockUntilSyncedToCurrentChain should return false before mwebindex is started.
+    BOOST_CHECK(!mwebindex.BlockUntilSyncedToCurrentChain());
+
+    mwebindex.Start();
+
+    // Allow mwebindex to catch up with the block index.
+    constexpr int64_t timeout_ms = 10 * 1000;
+    int64_t time_start = GetTimeMillis();
+    while (!mwebindex.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+        UninterruptibleSleep(std::chrono::milliseconds{100});
+    }
+
+    // Regtest blocks don't have MWEB data until MWEB activates, so connect
+    // a block with an MWEB pegin and pegout on top of the tip by hand.
+    test::Miner miner(GetDataDir());
+    test::Tx pegin_tx = test::Tx::CreatePegIn(5'000'000);
+    test::Tx pegout_tx = test::Tx::CreatePegOut(pegin_tx.GetOutputs().front());
+    mw::Block::CPtr mweb_block = miner.MineBlock(101, {pegin_tx, pegout_tx}).GetBlock();
+
+    CBlock block;
+    {
+        LOCK(cs_main);
+        block.hashPrevBlock = ::ChainActive().Tip()->GetBlockHash();
+        mweb_index.pprev = ::ChainActive().Tip();
+        mweb_index.nHeight = ::ChainActive().Height() + 1;
+    }
+    block.nTime = 1;
+    block.mweb_block = MWEB::Block(mweb_block);
+    const uint256 block_hash = block.GetHash();
+    mweb_index.phashBlock = &block_hash;
+
+    MWEBIndexEntry entry;
+    for (const Kernel& kernel : mweb_block->GetKernels()) {
+        BOOST_CHECK(!mwebindex.FindKernel(kernel.GetKernelID(), entry));
+    }
+
+    GetMainSignals().BlockConnected(std::make_shared<const CBlock>(block), &mweb_index);
+    SyncWithValidationInterfaceQueue();
+
+    BOOST_CHECK(!mweb_block->GetKernels().empty());
+    for (size_t i = 0; i < mweb_block->GetKernels().size(); i++) {
+        BOOST_REQUIRE(mwebindex.FindKernel(mweb_block->GetKernels()[i].GetKernelID(), entry));
+        BOOST_CHECK(entry.block_hash == block_hash);
+        BOOST_CHECK_EQUAL(entry.height, mweb_index.nHeight);
+        BOOST_CHECK_EQUAL(entry.position, i);
+    }
+
+    BOOST_CHECK(!mweb_block->GetOutputs().empty());
+    for (size_t i = 0; i < mweb_block->GetOutputs().size(); i++) {
+        BOOST_REQUIRE(mwebindex.FindOutput(mweb_block->GetOutputs()[i].GetOutputID(), entry));
+        BOOST_CHECK(entry.block_hash == block_hash);
+        BOOST_CHECK_EQUAL(entry.position, i);
+    }
+
+    BOOST_CHECK(!mweb_block->GetInputs().empty());
+    for (size_t i = 0; i < mweb_block->GetInputs().size(); i++) {
+        BOOST_REQUIRE(mwebindex.FindSpend(mweb_block->GetInputs()[i].GetOutputID(), entry));
+        BOOST_CHECK(entry.block_hash == block_hash);
+        BOOST_CHECK_EQUAL(entry.position, i);
+    }
+
+    // Spends and outputs are keyed separately.
+    BOOST_CHECK(!mwebindex.FindSpend(mweb_block->GetKernels().front().GetKernelID(), entry));
+    BOOST_CHECK(!mwebindex.FindOutput(mweb_block->GetKernels().front().GetKernelID(), entry));
+
+    // shutdown sequence (c.f. Shutdown() in init.cpp)
+    mwebindex.Stop();
+
+    // Let scheduler events finish running to avoid accessing any memory related to mwebindex after it is destructed
+    SyncWithValidationInterfaceQueue();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -8,10 +8,13 @@
 #include <clientversion.h>
 #include <cstdint>
 #include <net.h>
+#include <net_processing.h>
 #include <netbase.h>
+#include <netmessagemaker.h>
 #include <serialize.h>
 #include <span.h>
 #include <streams.h>
+#include <test/util/net.h>
 #include <test/util/setup_common.h>
 #include <util/memory.h>
 #include <util/strencodings.h>
@@ -22,6 +25,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include <ios>
+#include <limits>
 #include <memory>
 #include <string>
 
@@ -754,6 +758,157 @@ BOOST_AUTO_TEST_CASE(LocalAddress_BasicLifecycle)
     BOOST_CHECK_EQUAL(IsLocal(addr), false);
 }
 
+BOOST_AUTO_TEST_CASE(socket_handler_loopback)
+{
+    CSerializedNetMsg msg = CNetMsgMaker(INIT_PROTO_VERSION).Make(NetMsgType::PING, uint64_t{42});
+    std::vector<unsigned char> wire;
+    V1TransportSerializer().prepareForTransport(msg, wire);
+    wire.insert(wire.end(), msg.data.begin(), msg.data.end());
+
+    for (const std::string mode_str : {"select", "poll", "epoll"}) {
+        SocketEventsMode mode;
+        if (!SocketEventsModeFromString(mode_str, mode)) continue;
+        BOOST_TEST_MESSAGE("Testing -socketevents=" << mode_str);
+
+        ConnmanTestMsg connman{0x1337, 0x1337};
+        connman.InitSocketEvents(mode);
+
+        SOCKET client, server;
+        BOOST_REQUIRE(CreateLoopbackSocketPair(client, server));
+        CNode* node = new CNode(0, NODE_NETWORK, 0, server, CAddress(), 0, 0, CAddress(), "", ConnectionType::INBOUND);
+        connman.AddTestNode(*node);
+
+        const auto received = [&](size_t expected, int max_loops) {
+            size_t count = 0;
+            for (int i = 0; i < max_loops; i++) {
+                {
+                    LOCK(node->cs_vProcessMsg);
+                    count = node->vProcessMsg.size();
+                }
+                if (count >= expected) break;
+                connman.SocketHandlerOnce();
+            }
+            return count;
+        };
+
+        // The receive flood size is zero, so the node pauses after every message.
+        BOOST_REQUIRE_EQUAL(send(client, (const char*)wire.data(), wire.size(), 0), (int)wire.size());
+        BOOST_CHECK_EQUAL(received(1, 100), 1U);
+        BOOST_CHECK(node->fPauseRecv);
+
+        // A paused node is not read from, even though its socket became readable...
+        BOOST_REQUIRE_EQUAL(send(client, (const char*)wire.data(), wire.size(), 0), (int)wire.size());
+        BOOST_CHECK_EQUAL(received(2, 5), 1U);
+
+        // ...until the message handler unpauses it.
+        node->fPauseRecv = false;
+        BOOST_CHECK_EQUAL(received(2, 100), 2U);
+        BOOST_CHECK_EQUAL(node->vProcessMsg.back().m_command, NetMsgType::PING);
+
+        // A closed connection disconnects the node.
+        CloseSocket(client);
+        node->fPauseRecv = false;
+        for (int i = 0; i < 100 && !node->fDisconnect; i++) {
+            connman.SocketHandlerOnce();
+        }
+        BOOST_CHECK(node->fDisconnect);
+
+        connman.ClearTestNodes();
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(msgproc_concurrent_messages, TestingSetup)
+{
+    ConnmanTestMsg connman{0x1337, 0x1337};
+    PeerManager peerman{Params(), connman, nullptr, *m_node.scheduler, *m_node.chainman, *m_node.mempool};
+    std::atomic<bool> interrupt{false};
+
+    CNode node(0, NODE_NETWORK, 0, INVALID_SOCKET, CAddress(), 0, 0, CAddress(), "", ConnectionType::INBOUND);
+    node.SetCommonVersion(PROTOCOL_VERSION);
+    peerman.InitializeNode(&node);
+    const CNetMsgMaker msg_maker(PROTOCOL_VERSION);
+
+    // Nothing to do.
+    node.fSuccessfullyConnected = true;
+    BOOST_CHECK(!peerman.CanProcessMessagesConcurrently(&node));
+
+    // Messages from peers that haven't completed the handshake are never handed off.
+    CSerializedNetMsg ping = msg_maker.Make(NetMsgType::PING, uint64_t{42});
+    BOOST_REQUIRE(connman.ReceiveMsgFrom(node, ping));
+    node.fSuccessfullyConnected = false;
+    BOOST_CHECK(!peerman.CanProcessMessagesConcurrently(&node));
+    node.fSuccessfullyConnected = true;
+    BOOST_CHECK(peerman.CanProcessMessagesConcurrently(&node));
+
+    peerman.ProcessMessages(&node, interrupt);
+    BOOST_CHECK(!peerman.CanProcessMessagesConcurrently(&node));
+    BOOST_CHECK_EQUAL(peerman.GetMsgProcStats().at(NetMsgType::PING).count, 1U);
+
+    // Messages that need cs_main stay on the message handler thread, and
+    // hold back the messages queued behind them.
+    CSerializedNetMsg inv = msg_maker.Make(NetMsgType::INV, std::vector<CInv>{});
+    BOOST_REQUIRE(connman.ReceiveMsgFrom(node, inv));
+    // Messages without a payload complete with their header.
+    CSerializedNetMsg getaddr = msg_maker.Make(NetMsgType::GETADDR);
+    connman.ReceiveMsgFrom(node, getaddr);
+    BOOST_CHECK(!peerman.CanProcessMessagesConcurrently(&node));
+    peerman.ProcessMessages(&node, interrupt);
+    BOOST_CHECK(peerman.CanProcessMessagesConcurrently(&node));
+    peerman.ProcessMessages(&node, interrupt);
+
+    // Unknown messages are accounted for together.
+    CSerializedNetMsg unknown = msg_maker.Make("unknown");
+    connman.ReceiveMsgFrom(node, unknown);
+    BOOST_CHECK(!peerman.CanProcessMessagesConcurrently(&node));
+    peerman.ProcessMessages(&node, interrupt);
+
+    const auto stats = peerman.GetMsgProcStats();
+    for (const auto& i : stats) {
+        // Every processed message has one sample in each histogram.
+        uint64_t time_samples = 0, queue_time_samples = 0, cs_main_time_samples = 0;
+        for (size_t bucket = 0; bucket < DurationHistogram::BUCKETS; ++bucket) {
+            time_samples += i.second.time_hist.Count(bucket);
+            queue_time_samples += i.second.queue_time_hist.Count(bucket);
+            cs_main_time_samples += i.second.cs_main_time_hist.Count(bucket);
+        }
+        BOOST_CHECK_EQUAL(time_samples, i.second.count);
+        BOOST_CHECK_EQUAL(queue_time_samples, i.second.count);
+        BOOST_CHECK_EQUAL(cs_main_time_samples, i.second.count);
+        BOOST_CHECK_LE(i.second.cs_main_time_us, i.second.time_us);
+    }
+    BOOST_CHECK_EQUAL(stats.at(NetMsgType::INV).count, 1U);
+    BOOST_CHECK_EQUAL(stats.at(NetMsgType::GETADDR).count, 1U);
+    BOOST_CHECK_EQUAL(stats.at(NET_MESSAGE_COMMAND_OTHER).count, 1U);
+    BOOST_CHECK(stats.find("unknown") == stats.end());
+
+    CNodeStats node_stats;
+    node.copyStats(node_stats, {});
+    BOOST_CHECK(node_stats.mapProcessTimePerMsgCmd.count(NetMsgType::PING));
+    BOOST_CHECK(!node_stats.mapProcessTimePerMsgCmd.count("unknown"));
+
+    bool update_connection_time;
+    peerman.FinalizeNode(node, update_connection_time);
+}
+
+BOOST_AUTO_TEST_CASE(duration_histogram)
+{
+    DurationHistogram hist;
+    for (int64_t time_us : std::vector<int64_t>{-1, 0, 1, 2, 3, 4, 1023, 1024, std::numeric_limits<int64_t>::max()}) {
+        hist.Add(time_us);
+    }
+    BOOST_CHECK_EQUAL(hist.Count(0), 2U);  // [0, 1)
+    BOOST_CHECK_EQUAL(hist.Count(1), 1U);  // [1, 2)
+    BOOST_CHECK_EQUAL(hist.Count(2), 2U);  // [2, 4)
+    BOOST_CHECK_EQUAL(hist.Count(3), 1U);  // [4, 8)
+    BOOST_CHECK_EQUAL(hist.Count(10), 1U); // [512, 1024)
+    BOOST_CHECK_EQUAL(hist.Count(11), 1U); // [1024, 2048)
+    BOOST_CHECK_EQUAL(hist.Count(DurationHistogram::BUCKETS - 1), 1U);
+
+    BOOST_CHECK_EQUAL(DurationHistogram::BucketStart(0), 0);
+    BOOST_CHECK_EQUAL(DurationHistogram::BucketStart(1), 1);
+    BOOST_CHECK_EQUAL(DurationHistogram::BucketStart(11), 1024);
+}
+
 BOOST_AUTO_TEST_CASE(PoissonNextSend)
 {
     g_mock_deterministic_tests = true;
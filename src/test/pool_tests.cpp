@@ -0,0 +1,121 @@
+// Copyright (c) 2022 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <coins.h>
+#include <memusage.h>
+#include <support/allocators/pool.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(pool_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(basic_allocating)
+{
+    PoolResource<8, 8> resource(16);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 1U);
+    BOOST_CHECK_EQUAL(resource.ChunkSizeBytes(), 16U);
+
+    // first chunk is already allocated, so both blocks are carved out of it
+    void* block1 = resource.Allocate(8, 8);
+    void* block2 = resource.Allocate(8, 8);
+    BOOST_CHECK(block1 != block2);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 1U);
+
+    // the chunk is used up, so a new one is allocated
+    void* block3 = resource.Allocate(8, 8);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 2U);
+
+    // deallocated blocks are reused before carving out more memory
+    resource.Deallocate(block2, 8, 8);
+    BOOST_CHECK(resource.Allocate(8, 8) == block2);
+    resource.Deallocate(block1, 8, 8);
+    resource.Deallocate(block3, 8, 8);
+    BOOST_CHECK(resource.Allocate(8, 8) == block3);
+    BOOST_CHECK(resource.Allocate(8, 8) == block1);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 2U);
+
+    // too large or overaligned allocations are not served from the pool
+    void* large = resource.Allocate(16, 8);
+    void* aligned = resource.Allocate(8, 16);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 2U);
+    resource.Deallocate(large, 16, 8);
+    resource.Deallocate(aligned, 8, 16);
+
+    // 0 bytes still takes a whole block, here the rest of the second chunk
+    void* empty = resource.Allocate(0, 1);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 2U);
+    resource.Deallocate(empty, 0, 1);
+    BOOST_CHECK(resource.Allocate(8, 8) == empty);
+}
+
+BOOST_AUTO_TEST_CASE(leftover_is_reused)
+{
+    PoolResource<16, 8> resource(24);
+
+    // 16 bytes of the first chunk are used, leaving 8 that can't fit the next 16 byte block
+    resource.Allocate(16, 8);
+    resource.Allocate(16, 8);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 2U);
+
+    // the 8 leftover bytes went into the freelist, so an 8 byte block doesn't need a new chunk
+    resource.Allocate(8, 8);
+    resource.Allocate(8, 8);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 2U);
+}
+
+BOOST_AUTO_TEST_CASE(coins_map_memusage)
+{
+    CCoinsMapMemoryResource resource;
+    CCoinsMap map{0, CCoinsMap::hasher{}, CCoinsMap::key_equal{}, &resource};
+
+    // An empty map only accounts for the pool's first chunk.
+    const size_t empty_usage = memusage::DynamicUsage(map);
+    BOOST_CHECK(empty_usage >= resource.ChunkSizeBytes());
+
+    for (uint32_t i = 0; i < 1000; ++i) {
+        map[COutPoint{InsecureRand256(), i}];
+    }
+
+    // The nodes are carved out of the pool, so the usage only grows by
+    // whole chunks and the bucket array.
+    const size_t chunks_usage = resource.NumAllocatedChunks() * memusage::MallocUsage(resource.ChunkSizeBytes());
+    BOOST_CHECK(memusage::DynamicUsage(map) >= chunks_usage);
+    BOOST_CHECK(memusage::DynamicUsage(map) < chunks_usage + resource.ChunkSizeBytes());
+
+    // Freed nodes go back to the pool and are reused.
+    const size_t num_chunks = resource.NumAllocatedChunks();
+    map.clear();
+    for (uint32_t i = 0; i < 1000; ++i) {
+        map[COutPoint{InsecureRand256(), i}];
+    }
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), num_chunks);
+}
+
+BOOST_AUTO_TEST_CASE(coins_cache_releases_memory_on_flush)
+{
+    CCoinsView base;
+    CCoinsViewCache cache{&base};
+    const size_t empty_usage = cache.DynamicMemoryUsage();
+
+    for (uint32_t i = 0; i < 10000; ++i) {
+        Coin coin;
+        coin.nHeight = 1;
+        coin.out.nValue = 1;
+        cache.AddCoin(COutPoint{InsecureRand256(), i}, std::move(coin), false);
+    }
+    BOOST_CHECK(cache.DynamicMemoryUsage() > empty_usage);
+
+    cache.SetBestBlock(InsecureRand256());
+    cache.Flush();
+    BOOST_CHECK_EQUAL(cache.GetCacheSize(), 0U);
+    BOOST_CHECK_EQUAL(cache.DynamicMemoryUsage(), empty_usage);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -113,6 +113,21 @@ BOOST_AUTO_TEST_CASE(CheckProofOfWork_test_zero_target)
     BOOST_CHECK(!CheckProofOfWork(hash, nBits, consensus));
 }
 
+BOOST_AUTO_TEST_CASE(CheckProofOfWork_test_headers)
+{
+    const auto chainParams = CreateChainParams(*m_node.args, CBaseChainParams::MAIN);
+    const CBlockHeader genesis = chainParams->GenesisBlock().GetBlockHeader();
+    BOOST_CHECK(CheckProofOfWork(genesis.GetPoWHash(), genesis.nBits, chainParams->GetConsensus()));
+
+    // Enough headers for several batches and checks, with a remainder
+    std::vector<CBlockHeader> headers(37, genesis);
+    BOOST_CHECK(CheckProofOfWork(headers, chainParams->GetConsensus()));
+
+    headers[29].nNonce++;
+    BOOST_CHECK(!CheckProofOfWork(headers[29].GetPoWHash(), headers[29].nBits, chainParams->GetConsensus()));
+    BOOST_CHECK(!CheckProofOfWork(headers, chainParams->GetConsensus()));
+}
+
 BOOST_AUTO_TEST_CASE(GetBlockProofEquivalentTime_test)
 {
     const auto chainParams = CreateChainParams(*m_node.args, CBaseChainParams::MAIN);
@@ -29,6 +29,20 @@ BOOST_AUTO_TEST_CASE(scrypt_hashtest)
         scrypt_1024_1_1_256_sp_generic((const char*)&inputbytes[0], BEGIN(scrypthash), scratchpad);
         BOOST_CHECK_EQUAL(scrypthash.ToString().c_str(), expected[i]);
     }
+
+    // Test batched scrypt, with one full 8-way batch and a remainder
+    const size_t batch_count = 13;
+    std::vector<char> batch_input;
+    for (size_t i = 0; i < batch_count; i++) {
+        inputbytes = ParseHex(inputhex[i % HASHCOUNT]);
+        batch_input.insert(batch_input.end(), inputbytes.begin(), inputbytes.end());
+    }
+    std::vector<char> batch_output(batch_count * 32);
+    scrypt_1024_1_1_256_batch(batch_input.data(), batch_output.data(), batch_count);
+    for (size_t i = 0; i < batch_count; i++) {
+        memcpy(scrypthash.begin(), &batch_output[i * 32], 32);
+        BOOST_CHECK_EQUAL(scrypthash.ToString().c_str(), expected[i % HASHCOUNT]);
+    }
 }
 
 BOOST_AUTO_TEST_SUITE_END()
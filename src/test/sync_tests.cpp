@@ -2,8 +2,16 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#if defined(HAVE_CONFIG_H)
+#include <config/bitcoin-config.h>
+#endif
+
 #include <sync.h>
 #include <test/util/setup_common.h>
+#include <util/time.h>
+
+#include <chrono>
+#include <thread>
 
 #include <boost/test/unit_test.hpp>
 
@@ -55,4 +63,43 @@ BOOST_AUTO_TEST_CASE(potential_deadlock_detected)
     #endif
 }
 
+BOOST_AUTO_TEST_CASE(hold_time)
+{
+#if !defined(HAVE_THREAD_LOCAL)
+    BOOST_CHECK_EQUAL(TimedRecursiveMutex::ThreadHoldTimeMicros(), 0);
+#else
+    TimedRecursiveMutex mutex1, mutex2;
+    const int64_t start = TimedRecursiveMutex::ThreadHoldTimeMicros();
+
+    // Time without the lock isn't counted.
+    UninterruptibleSleep(std::chrono::milliseconds{2});
+    BOOST_CHECK_EQUAL(TimedRecursiveMutex::ThreadHoldTimeMicros(), start);
+
+    // Nested holds are counted once, so the total can't exceed the outer hold.
+    const auto outer_start = std::chrono::steady_clock::now();
+    {
+        LOCK(mutex1);
+        UninterruptibleSleep(std::chrono::milliseconds{2});
+        {
+            LOCK2(mutex1, mutex2);
+            UninterruptibleSleep(std::chrono::milliseconds{5});
+        }
+        // The current hold is included.
+        BOOST_CHECK_GE(TimedRecursiveMutex::ThreadHoldTimeMicros() - start, 7000);
+    }
+    const auto outer_time = std::chrono::steady_clock::now() - outer_start;
+    const int64_t held = TimedRecursiveMutex::ThreadHoldTimeMicros() - start;
+    BOOST_CHECK_GE(held, 7000);
+    BOOST_CHECK_LE(held, std::chrono::duration_cast<std::chrono::microseconds>(outer_time).count());
+
+    // Other threads' holds are theirs.
+    std::thread t([&] {
+        LOCK(mutex1);
+        UninterruptibleSleep(std::chrono::milliseconds{2});
+    });
+    t.join();
+    BOOST_CHECK_EQUAL(TimedRecursiveMutex::ThreadHoldTimeMicros() - start, held);
+#endif
+}
+
 BOOST_AUTO_TEST_SUITE_END()
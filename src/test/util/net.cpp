@@ -6,6 +6,7 @@
 
 #include <chainparams.h>
 #include <net.h>
+#include <netbase.h>
 
 void ConnmanTestMsg::NodeReceiveMsgBytes(CNode& node, const char* pch, unsigned int nBytes, bool& complete) const
 {
@@ -37,3 +38,34 @@ bool ConnmanTestMsg::ReceiveMsgFrom(CNode& node, CSerializedNetMsg& ser_msg) con
     NodeReceiveMsgBytes(node, (const char*)ser_msg.data.data(), ser_msg.data.size(), complete);
     return complete;
 }
+
+bool CreateLoopbackSocketPair(SOCKET& client, SOCKET& server)
+{
+    client = server = INVALID_SOCKET;
+    SOCKET listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listener == INVALID_SOCKET) return false;
+
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t len = sizeof(addr);
+    if (bind(listener, (struct sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR ||
+        listen(listener, 1) == SOCKET_ERROR ||
+        getsockname(listener, (struct sockaddr*)&addr, &len) == SOCKET_ERROR) {
+        CloseSocket(listener);
+        return false;
+    }
+
+    client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (client != INVALID_SOCKET && connect(client, (struct sockaddr*)&addr, sizeof(addr)) != SOCKET_ERROR) {
+        server = accept(listener, nullptr, nullptr);
+    }
+    CloseSocket(listener);
+    if (server == INVALID_SOCKET || !SetSocketNonBlocking(server, true)) {
+        CloseSocket(client);
+        CloseSocket(server);
+        return false;
+    }
+    return true;
+}
@@ -13,10 +13,12 @@ struct ConnmanTestMsg : public CConnman {
     {
         LOCK(cs_vNodes);
         vNodes.push_back(&node);
+        RegisterNodeSocket(&node);
     }
     void ClearTestNodes()
     {
         LOCK(cs_vNodes);
+        CloseSocketEvents();
         for (CNode* node : vNodes) {
             delete node;
         }
@@ -25,9 +27,20 @@ struct ConnmanTestMsg : public CConnman {
 
     void ProcessMessagesOnce(CNode& node) { m_msgproc->ProcessMessages(&node, flagInterruptMsgProc); }
 
+    void InitSocketEvents(SocketEventsMode mode)
+    {
+        m_socket_events_mode = mode;
+        CConnman::InitSocketEvents();
+    }
+
+    void SocketHandlerOnce() { SocketHandler(); }
+
     void NodeReceiveMsgBytes(CNode& node, const char* pch, unsigned int nBytes, bool& complete) const;
 
     bool ReceiveMsgFrom(CNode& node, CSerializedNetMsg& ser_msg) const;
 };
 
+/** Connect two TCP sockets to each other over the loopback interface. */
+bool CreateLoopbackSocketPair(SOCKET& client, SOCKET& server);
+
 #endif // BITCOIN_TEST_UTIL_NET_H
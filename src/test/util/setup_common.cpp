@@ -13,6 +13,8 @@
 #include <init.h>
 #include <interfaces/chain.h>
 #include <miner.h>
+#include <mw/crypto/CryptoCheckQueue.h>
+#include <mw/crypto/VerificationCache.h>
 #include <net.h>
 #include <net_processing.h>
 #include <noui.h>
@@ -105,6 +107,7 @@ BasicTestingSetup::BasicTestingSetup(const std::string& chainName, const std::ve
     SetupEnvironment();
     SetupNetworking();
     InitSignatureCache();
+    VerificationCache::Init(DEFAULT_MWEB_SIG_CACHE_SIZE);
     InitScriptExecutionCache();
     m_node.chain = interfaces::MakeChain(m_node);
     g_wallet_init_interface.Construct(m_node);
@@ -166,6 +169,9 @@ TestingSetup::TestingSetup(const std::string& chainName, const std::vector<const
         threadGroup.create_thread([i]() { return ThreadScriptCheck(i); });
     }
     g_parallel_script_checks = true;
+    for (int i = 0; i < script_check_threads; ++i) {
+        threadGroup.create_thread([i]() { return CryptoCheckQueue::Thread(i); });
+    }
 
     m_node.banman = MakeUnique<BanMan>(GetDataDir() / "banlist.dat", nullptr, DEFAULT_MISBEHAVING_BANTIME);
     m_node.connman = MakeUnique<CConnman>(0x1337, 0x1337); // Deterministic randomness for tests.
@@ -5,6 +5,7 @@
 #include <chainparams.h>
 #include <net.h>
 #include <signet.h>
+#include <txdb.h>
 #include <validation.h>
 
 #include <test/util/setup_common.h>
@@ -58,4 +59,34 @@ BOOST_AUTO_TEST_CASE(subsidy_limit_test)
     BOOST_CHECK_EQUAL(nSum, CAmount{8399999990760000});
 }
 
+BOOST_FIXTURE_TEST_CASE(store_pow_hash_test, TestChain100Setup)
+{
+    const CScript script_pub_key = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    fStorePoWHash = true;
+    for (int i = 0; i < 5; i++) {
+        CreateAndProcessBlock({}, script_pub_key);
+    }
+    fStorePoWHash = false;
+    ::ChainstateActive().ForceFlushStateToDisk();
+
+    std::map<uint256, std::unique_ptr<CBlockIndex>> block_index;
+    const auto insert_block_index = [&block_index](const uint256& hash) {
+        auto it = block_index.emplace(hash, nullptr).first;
+        if (!it->second) {
+            it->second = MakeUnique<CBlockIndex>();
+            it->second->phashBlock = &it->first;
+        }
+        return it->second.get();
+    };
+    BOOST_CHECK(pblocktree->LoadBlockIndexGuts(Params().GetConsensus(), insert_block_index, true));
+    BOOST_CHECK(CheckBlockIndexPoWSample(Params(), 20));
+
+    // A stored hash that doesn't satisfy the block's nBits fails the check
+    const uint256 tip_hash = WITH_LOCK(cs_main, return ::ChainActive().Tip()->GetBlockHash());
+    BOOST_CHECK(pblocktree->WritePoWHash(tip_hash, uint256S("ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff")));
+    block_index.clear();
+    BOOST_CHECK(!pblocktree->LoadBlockIndexGuts(Params().GetConsensus(), insert_block_index, true));
+    BOOST_CHECK(pblocktree->LoadBlockIndexGuts(Params().GetConsensus(), insert_block_index, false));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -22,6 +22,7 @@ static const char DB_COIN = 'C';
 static const char DB_COINS = 'c';
 static const char DB_BLOCK_FILES = 'f';
 static const char DB_BLOCK_INDEX = 'b';
+static const char DB_POW_HASH = 'P';
 
 static const char DB_BEST_BLOCK = 'B';
 static const char DB_HEAD_BLOCKS = 'H';
@@ -240,6 +241,10 @@ bool CBlockTreeDB::WriteBatchSync(const std::vector<std::pair<int, const CBlockF
     return WriteBatch(batch, true);
 }
 
+bool CBlockTreeDB::WritePoWHash(const uint256& hash, const uint256& pow_hash) {
+    return Write(std::make_pair(DB_POW_HASH, hash), pow_hash);
+}
+
 bool CBlockTreeDB::WriteFlag(const std::string &name, bool fValue) {
     return Write(std::make_pair(DB_FLAG, name), fValue ? '1' : '0');
 }
@@ -252,12 +257,21 @@ bool CBlockTreeDB::ReadFlag(const std::string &name, bool &fValue) {
     return true;
 }
 
-bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex)
+bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, bool fCheckPoWHashes)
 {
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
 
     pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, uint256()));
 
+    // The stored PoW hashes are keyed by block hash, like the block index,
+    // so a second cursor walks them in step with the first.
+    std::unique_ptr<CDBIterator> pcursorPoW;
+    size_t nPoWHashesChecked = 0;
+    if (fCheckPoWHashes) {
+        pcursorPoW.reset(NewIterator());
+        pcursorPoW->Seek(std::make_pair(DB_POW_HASH, uint256()));
+    }
+
     // Load m_block_index
     while (pcursor->Valid()) {
         if (ShutdownRequested()) return false;
@@ -289,8 +303,24 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
                 // While it is technically feasible to verify the PoW, doing so takes several minutes as it
                 // requires recomputing every PoW hash during every Litecoin startup.
                 // We opt instead to simply trust the data that is on your local disk.
-                //if (!CheckProofOfWork(pindexNew->GetBlockHash(), pindexNew->nBits, consensusParams))
-                //    return error("%s: CheckProofOfWork failed: %s", __func__, pindexNew->ToString());
+                // With -storepowhash, the scrypt hash is stored when a header is accepted,
+                // so the check can be done here cheaply for every block that has one.
+                if (pcursorPoW) {
+                    std::pair<char, uint256> keyPoW;
+                    while (pcursorPoW->Valid() && pcursorPoW->GetKey(keyPoW) && keyPoW.first == DB_POW_HASH && keyPoW.second < key.second) {
+                        pcursorPoW->Next();
+                    }
+                    if (pcursorPoW->Valid() && pcursorPoW->GetKey(keyPoW) && keyPoW.first == DB_POW_HASH && keyPoW.second == key.second) {
+                        uint256 pow_hash;
+                        if (!pcursorPoW->GetValue(pow_hash)) {
+                            return error("%s: failed to read PoW hash", __func__);
+                        }
+                        if (!CheckProofOfWork(pow_hash, pindexNew->nBits, consensusParams)) {
+                            return error("%s: CheckProofOfWork failed: %s", __func__, pindexNew->ToString());
+                        }
+                        nPoWHashesChecked++;
+                    }
+                }
 
                 pcursor->Next();
             } else {
@@ -301,6 +331,10 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
         }
     }
 
+    if (fCheckPoWHashes) {
+        LogPrintf("Checked the proof of work of %u block index entries against their stored PoW hashes\n", nPoWHashesChecked);
+    }
+
     return true;
 }
 
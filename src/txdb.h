@@ -37,11 +37,13 @@ static const int64_t nMaxBlockDBCache = 2;
 static const int64_t nMaxTxIndexCache = 1024;
 //! Max memory allocated to all block filter index caches combined in MiB.
 static const int64_t max_filter_index_cache = 1024;
+//! Max memory allocated to the MWEB index cache in MiB.
+static const int64_t max_mweb_index_cache = 1024;
 //! Max memory allocated to coin DB specific cache (MiB)
 static const int64_t nMaxCoinsDBCache = 8;
 
 // Actually declared in validation.cpp; can't include because of circular dependency.
-extern RecursiveMutex cs_main;
+extern TimedRecursiveMutex cs_main;
 
 /** CCoinsView backed by the coin database (chainstate/) */
 class CCoinsViewDB final : public CCoinsView
@@ -110,7 +112,9 @@ public:
     void ReadReindexing(bool &fReindexing);
     bool WriteFlag(const std::string &name, bool fValue);
     bool ReadFlag(const std::string &name, bool &fValue);
-    bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex);
+    //! Stores the scrypt PoW hash of the block with the given hash, see -storepowhash.
+    bool WritePoWHash(const uint256& hash, const uint256& pow_hash);
+    bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, bool fCheckPoWHashes = false);
 };
 
 #endif // BITCOIN_TXDB_H
@@ -8,6 +8,7 @@
 #include <consensus/consensus.h>
 #include <consensus/tx_verify.h>
 #include <consensus/validation.h>
+#include <core_memusage.h>
 #include <optional.h>
 #include <validation.h>
 #include <policy/policy.h>
@@ -346,6 +347,100 @@ void CTxMemPoolEntry::UpdateAncestorState(int64_t modifySize, CAmount modifyFee,
     assert(int64_t(nMWEBWeightWithAncestors) >= 0);
 }
 
+MWEBTxCache::MWEBTxCache(size_t max_bytes)
+    : m_max_shard_bytes(max_bytes / NUM_SHARDS) {}
+
+size_t MWEBTxCache::EntryUsage(const CTransactionRef& tx)
+{
+    // The map node, the heap allocated bytes of its key, the queue slot and the transaction itself.
+    // A transaction with several kernels is counted once per kernel, since each entry can keep it alive.
+    return memusage::MallocUsage(sizeof(memusage::stl_tree_node<std::pair<const mw::Hash, Entry>>)) +
+        memusage::MallocUsage(mw::Hash::size()) +
+        sizeof(std::map<mw::Hash, Entry>::iterator) +
+        RecursiveDynamicUsage(tx) +
+        ::GetSerializeSize(tx->mweb_tx, PROTOCOL_VERSION);
+}
+
+MWEBTxCache::Shard& MWEBTxCache::GetShard(const mw::Hash& kernel_id) const
+{
+    // Kernel IDs are hashes, so their first byte is uniformly distributed.
+    return m_shards[kernel_id.data()[0] % NUM_SHARDS];
+}
+
+void MWEBTxCache::Shard::Evict(size_t max_bytes)
+{
+    while (usage > max_bytes && !queue.empty()) {
+        auto it = queue.front();
+        usage -= it->second.usage;
+        entries.erase(it);
+        queue.pop_front();
+    }
+}
+
+void MWEBTxCache::SetMaxSize(size_t max_bytes)
+{
+    m_max_shard_bytes = max_bytes / NUM_SHARDS;
+    for (Shard& shard : m_shards) {
+        LOCK(shard.cs);
+        shard.Evict(m_max_shard_bytes);
+    }
+}
+
+void MWEBTxCache::Put(const mw::Hash& kernel_id, const CTransactionRef& tx)
+{
+    const size_t usage = EntryUsage(tx);
+
+    Shard& shard = GetShard(kernel_id);
+    LOCK(shard.cs);
+    auto inserted = shard.entries.emplace(kernel_id, Entry{tx, usage});
+    if (inserted.second) {
+        shard.queue.push_back(inserted.first);
+    } else {
+        shard.usage -= inserted.first->second.usage;
+        inserted.first->second = Entry{tx, usage};
+    }
+    shard.usage += usage;
+    shard.Evict(m_max_shard_bytes);
+}
+
+CTransactionRef MWEBTxCache::Get(const mw::Hash& kernel_id) const
+{
+    Shard& shard = GetShard(kernel_id);
+    LOCK(shard.cs);
+    auto it = shard.entries.find(kernel_id);
+    return it != shard.entries.end() ? it->second.tx : nullptr;
+}
+
+void MWEBTxCache::ForEach(const std::function<bool(const CTransactionRef&)>& fn) const
+{
+    for (const Shard& shard : m_shards) {
+        LOCK(shard.cs);
+        for (const auto& it : shard.queue) {
+            if (!fn(it->second.tx)) return;
+        }
+    }
+}
+
+size_t MWEBTxCache::Size() const
+{
+    size_t size = 0;
+    for (const Shard& shard : m_shards) {
+        LOCK(shard.cs);
+        size += shard.entries.size();
+    }
+    return size;
+}
+
+size_t MWEBTxCache::DynamicMemoryUsage() const
+{
+    size_t usage = 0;
+    for (const Shard& shard : m_shards) {
+        LOCK(shard.cs);
+        usage += shard.usage;
+    }
+    return usage;
+}
+
 CTxMemPool::CTxMemPool(CBlockPolicyEstimator* estimator)
     : nTransactionsUpdated(0), minerPolicyEstimator(estimator), m_epoch(0), m_has_epoch_guard(false)
 {
@@ -900,6 +995,33 @@ CTransactionRef CTxMemPool::get(const uint256& hash) const
     return i->GetSharedTx();
 }
 
+std::vector<CTransactionRef> CTxMemPool::GetTxsByKernel(const std::vector<mw::Hash>& kernel_ids) const
+{
+    LOCK(cs);
+    std::vector<CTransactionRef> txs(kernel_ids.size());
+
+    std::map<mw::Hash, size_t> missing;
+    for (size_t i = 0; i < kernel_ids.size(); i++) {
+        txs[i] = recentTxsByKernel.Get(kernel_ids[i]);
+        if (!txs[i]) {
+            missing.emplace(kernel_ids[i], i);
+        }
+    }
+
+    // The mempool isn't indexed by kernel, so look for the rest in a single pass.
+    for (auto it = mapTx.begin(); it != mapTx.end() && !missing.empty(); ++it) {
+        for (const mw::Hash& kernel_id : it->GetTx().mweb_tx.GetKernelIDs()) {
+            auto missing_it = missing.find(kernel_id);
+            if (missing_it != missing.end()) {
+                txs[missing_it->second] = it->GetSharedTx();
+                missing.erase(missing_it);
+            }
+        }
+    }
+
+    return txs;
+}
+
 TxMempoolInfo CTxMemPool::info(const GenTxid& gtxid) const
 {
     LOCK(cs);
@@ -6,7 +6,10 @@
 #ifndef BITCOIN_TXMEMPOOL_H
 #define BITCOIN_TXMEMPOOL_H
 
+#include <array>
 #include <atomic>
+#include <deque>
+#include <functional>
 #include <map>
 #include <set>
 #include <string>
@@ -27,18 +30,17 @@
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/ordered_index.hpp>
 #include <boost/multi_index/sequenced_index.hpp>
-#include <caches/Cache.h>
 
 class CBlock;
 class CBlockIndex;
 struct DisconnectedBlockTransactions;
-extern RecursiveMutex cs_main;
+extern TimedRecursiveMutex cs_main;
 
 /** Fake height value used in Coin to signify they are only in the memory pool (since 0.8) */
 static const uint32_t MEMPOOL_HEIGHT = 0x7FFFFFFF;
 
-/** Default size of CMemPool's recentTxsByKernel cache */
-static const unsigned int DEFAULT_MEMPOOL_MWEB_CACHE_SIZE = 1000;
+/** Default for -maxmwebtxcache, the maximum size of CTxMemPool's recentTxsByKernel cache in megabytes */
+static const unsigned int DEFAULT_MEMPOOL_MWEB_CACHE_SIZE = 10;
 
 struct LockPoints
 {
@@ -429,6 +431,59 @@ public:
     }
 };
 
+/**
+ * Cache of MWEB transactions recently removed from the mempool, keyed by kernel ID.
+ *
+ * Entries are evicted in insertion order once the cache uses more than its
+ * maximum number of bytes. The cache is split into shards by kernel ID, each
+ * with its own lock, so it can be used without holding the mempool's cs.
+ */
+class MWEBTxCache
+{
+public:
+    explicit MWEBTxCache(size_t max_bytes);
+
+    /** Changes the maximum memory usage, evicting entries if necessary. */
+    void SetMaxSize(size_t max_bytes);
+    size_t GetMaxSize() const { return m_max_shard_bytes * NUM_SHARDS; }
+
+    /** Caches tx under kernel_id, replacing any transaction already cached under it. */
+    void Put(const mw::Hash& kernel_id, const CTransactionRef& tx);
+
+    /** Returns the transaction cached under kernel_id, or nullptr if there isn't one. */
+    CTransactionRef Get(const mw::Hash& kernel_id) const;
+
+    /** Calls fn on each cached transaction, until it returns false. */
+    void ForEach(const std::function<bool(const CTransactionRef&)>& fn) const;
+
+    size_t Size() const;
+    size_t DynamicMemoryUsage() const;
+
+private:
+    static constexpr size_t NUM_SHARDS = 8;
+
+    struct Entry {
+        CTransactionRef tx;
+        size_t usage;
+    };
+
+    struct Shard {
+        mutable Mutex cs;
+        std::map<mw::Hash, Entry> entries GUARDED_BY(cs);
+        //! Entries in the order they were added, oldest first.
+        std::deque<std::map<mw::Hash, Entry>::iterator> queue GUARDED_BY(cs);
+        size_t usage GUARDED_BY(cs){0};
+
+        void Evict(size_t max_bytes) EXCLUSIVE_LOCKS_REQUIRED(cs);
+    };
+
+    static size_t EntryUsage(const CTransactionRef& tx);
+    Shard& GetShard(const mw::Hash& kernel_id) const;
+
+    std::atomic<size_t> m_max_shard_bytes;
+    mutable std::array<Shard, NUM_SHARDS> m_shards;
+};
+
 /**
  * CTxMemPool stores valid-according-to-the-current-best-chain transactions
  * that may be included in the next block.
@@ -625,10 +680,11 @@ public:
     std::map<mw::Hash, const CTransaction*> mapTxOutputs_MWEB GUARDED_BY(cs);
 
     /**
-     * FIFO cache of txs recently removed from the mempool keyed by kernel ID.
+     * Cache of txs recently removed from the mempool by blocks, keyed by kernel ID,
+     * so they can be restored if the blocks are disconnected.
      */
-    FIFOCache<mw::Hash, CTransactionRef> recentTxsByKernel GUARDED_BY(cs){DEFAULT_MEMPOOL_MWEB_CACHE_SIZE};
-	
+    MWEBTxCache recentTxsByKernel{DEFAULT_MEMPOOL_MWEB_CACHE_SIZE * 1000000};
+
     std::map<uint256, CAmount> mapDeltas;
 
     /** Create a new CTxMemPool.
@@ -786,6 +842,11 @@ public:
     }
 
     CTransactionRef get(const uint256& hash) const;
+    /**
+     * MWEB: Finds the txs containing the given kernels, either in the mempool or among the txs
+     * recently removed from it. The returned vector is parallel to kernel_ids, with nullptr for kernels not found.
+     */
+    std::vector<CTransactionRef> GetTxsByKernel(const std::vector<mw::Hash>& kernel_ids) const;
     txiter get_iter_from_wtxid(const uint256& wtxid) const EXCLUSIVE_LOCKS_REQUIRED(cs)
     {
         AssertLockHeld(cs);
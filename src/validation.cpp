@@ -129,7 +129,7 @@ CChain& ChainActive()
  * The transaction pool has a separate lock to allow reading from it and the
  * chainstate at the same time.
  */
-RecursiveMutex cs_main;
+TimedRecursiveMutex cs_main;
 
 CBlockIndex *pindexBestHeader = nullptr;
 Mutex g_best_block_mutex;
@@ -142,6 +142,7 @@ bool fHavePruned = false;
 bool fPruneMode = false;
 bool fRequireStandard = true;
 bool fCheckBlockIndex = false;
+bool fStorePoWHash = DEFAULT_STORE_POW_HASH;
 bool fCheckpointsEnabled = DEFAULT_CHECKPOINTS_ENABLED;
 uint64_t nPruneTarget = 0;
 int64_t nMaxTipAge = DEFAULT_MAX_TIP_AGE;
@@ -1170,7 +1171,7 @@ static bool WriteBlockToDisk(const CBlock& block, FlatFilePos& pos, const CMessa
     return true;
 }
 
-bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos, const Consensus::Params& consensusParams)
+bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos, const Consensus::Params& consensusParams, bool fCheckPoW)
 {
     block.SetNull();
 
@@ -1188,7 +1189,7 @@ bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos, const Consensus::P
     }
 
     // Check the header
-    if (!CheckProofOfWork(block.GetPoWHash(), block.nBits, consensusParams))
+    if (fCheckPoW && !CheckProofOfWork(block.GetPoWHash(), block.nBits, consensusParams))
         return error("ReadBlockFromDisk: Errors in block header at %s", pos.ToString());
 
     // Signet only: check block solution
@@ -1207,7 +1208,9 @@ bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus
         blockPos = pindex->GetBlockPos();
     }
 
-    if (!ReadBlockFromDisk(block, blockPos, consensusParams))
+    // Computing the scrypt PoW hash is far more expensive than reading the block. It's redundant here,
+    // because a block whose hash matches the index entry has the header that passed CheckProofOfWork when accepted.
+    if (!ReadBlockFromDisk(block, blockPos, consensusParams, /* fCheckPoW */ false))
         return false;
     if (block.GetHash() != pindex->GetBlockHash())
         return error("ReadBlockFromDisk(CBlock&, CBlockIndex*): GetHash() doesn't match index for %s at %s",
@@ -1977,6 +1980,8 @@ static unsigned int GetBlockScriptFlags(const CBlockIndex* pindex, const Consens
 static int64_t nTimeCheck = 0;
 static int64_t nTimeForks = 0;
 static int64_t nTimeVerify = 0;
+static int64_t nTimeCheckQueueWait = 0;
+static int64_t nTimeCheckQueueIdle = 0;
 static int64_t nTimeConnect = 0;
 static int64_t nTimeIndex = 0;
 static int64_t nTimeCallbacks = 0;
@@ -2031,6 +2036,11 @@ bool CChainState::ConnectBlock(const CBlock& block, BlockValidationState& state,
         return true;
     }
 
+    // MWEB: Look up the spent MWEB coins and hash the new outputs while the transparent transactions are connected.
+    // The transparent checks below only use the transparent part of the view, so the MWEB view is left alone until
+    // the prefetch is consumed by MWEB::Node::ConnectBlock, or destroyed (and waited for) on an early return.
+    mw::BlockPrefetch::UPtr mweb_prefetch = MWEB::Node::PrefetchBlock(block, *view.GetMWEBCacheView());
+
     bool fScriptChecks = true;
     if (!hashAssumeValid.IsNull()) {
         // We've been configured with the hash of a block which has been externally verified to have a valid history.
@@ -2266,9 +2276,16 @@ bool CChainState::ConnectBlock(const CBlock& block, BlockValidationState& state,
     }
     int64_t nTime4 = GetTimeMicros(); nTimeVerify += nTime4 - nTime2;
     LogPrint(BCLog::BENCH, "    - Verify %u txins: %.2fms (%.3fms/txin) [%.2fs (%.2fms/blk)]\n", nInputs - 1, MILLI * (nTime4 - nTime2), nInputs <= 1 ? 0 : MILLI * (nTime4 - nTime2) / (nInputs-1), nTimeVerify * MICRO, nTimeVerify * MILLI / nBlocksTotal);
+    if (fScriptChecks && g_parallel_script_checks) {
+        const CCheckQueueStats queue_stats = scriptcheckqueue.GetLastStats();
+        nTimeCheckQueueWait += queue_stats.wait_us;
+        nTimeCheckQueueIdle += queue_stats.idle_us;
+        LogPrint(BCLog::BENCH, "      - Script check queue: %u checks on %d threads, %u steals, wait %.2fms [%.2fs], idle %.2fms [%.2fs]\n", queue_stats.checks, queue_stats.workers, queue_stats.steals,
+            MILLI * queue_stats.wait_us, nTimeCheckQueueWait * MICRO, MILLI * queue_stats.idle_us, nTimeCheckQueueIdle * MICRO);
+    }
 
     // MWEB: Check activation
-    if (!MWEB::Node::ConnectBlock(block, chainparams.GetConsensus(), pindex->pprev, blockundo, *view.GetMWEBCacheView(), state)) {
+    if (!MWEB::Node::ConnectBlock(block, chainparams.GetConsensus(), pindex->pprev, blockundo, *view.GetMWEBCacheView(), state, std::move(mweb_prefetch))) {
         return false;
     }
 
@@ -2594,10 +2611,10 @@ bool CChainState::DisconnectTip(BlockValidationState& state, const CChainParams&
         return false;
 
     if (disconnectpool) {
-        // MWEB: For each kernel, lookup kernel's txs in FIFO cache and add them back to the mempool.
+        // MWEB: For each kernel, lookup kernel's txs in the recent tx cache and add them back to the mempool.
         for (const mw::Hash& kernel_id : block.mweb_block.GetKernelIDs()) {
-            if (m_mempool.recentTxsByKernel.Cached(kernel_id)) {
-                CTransactionRef ptx = m_mempool.recentTxsByKernel.Get(kernel_id);
+            CTransactionRef ptx = m_mempool.recentTxsByKernel.Get(kernel_id);
+            if (ptx) {
                 disconnectpool->addTransaction(ptx);
             }
         }
@@ -3407,15 +3424,20 @@ static bool FindUndoPos(BlockValidationState &state, int nFile, FlatFilePos &pos
     return true;
 }
 
-static bool CheckBlockHeader(const CBlockHeader& block, BlockValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true)
+static bool CheckBlockHeader(const CBlockHeader& block, const uint256& pow_hash, BlockValidationState& state, const Consensus::Params& consensusParams)
 {
     // Check proof of work matches claimed amount
-    if (fCheckPOW && !CheckProofOfWork(block.GetPoWHash(), block.nBits, consensusParams))
+    if (!CheckProofOfWork(pow_hash, block.nBits, consensusParams))
         return state.Invalid(BlockValidationResult::BLOCK_INVALID_HEADER, "high-hash", "proof of work failed");
 
     return true;
 }
 
+static bool CheckBlockHeader(const CBlockHeader& block, BlockValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true)
+{
+    return !fCheckPOW || CheckBlockHeader(block, block.GetPoWHash(), state, consensusParams);
+}
+
 bool CheckBlock(const CBlock& block, BlockValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW, bool fCheckMerkleRoot)
 {
     // These are checks that are independent of context.
@@ -3709,7 +3731,7 @@ static bool ContextualCheckBlock(const CBlock& block, BlockValidationState& stat
     return true;
 }
 
-bool BlockManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex)
+bool BlockManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, const uint256* pow_hash)
 {
     AssertLockHeld(cs_main);
     // Check for duplicate
@@ -3729,7 +3751,8 @@ bool BlockManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationS
             return true;
         }
 
-        if (!CheckBlockHeader(block, state, chainparams.GetConsensus())) {
+        const uint256 block_pow_hash = pow_hash != nullptr && !pow_hash->IsNull() ? *pow_hash : block.GetPoWHash();
+        if (!CheckBlockHeader(block, block_pow_hash, state, chainparams.GetConsensus())) {
             LogPrint(BCLog::VALIDATION, "%s: Consensus::CheckBlockHeader: %s, %s\n", __func__, hash.ToString(), state.ToString());
             return false;
         }
@@ -3787,6 +3810,10 @@ bool BlockManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationS
                 }
             }
         }
+
+        if (fStorePoWHash && !pblocktree->WritePoWHash(hash, block_pow_hash)) {
+            LogPrintf("ERROR: %s: failed to write PoW hash\n", __func__);
+        }
     }
     if (pindex == nullptr)
         pindex = AddToBlockIndex(block);
@@ -3798,15 +3825,17 @@ bool BlockManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationS
 }
 
 // Exposed wrapper for AcceptBlockHeader
-bool ChainstateManager::ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, BlockValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex)
+bool ChainstateManager::ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, BlockValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex, const std::vector<uint256>* pow_hashes)
 {
     AssertLockNotHeld(cs_main);
     {
         LOCK(cs_main);
-        for (const CBlockHeader& header : headers) {
+        assert(pow_hashes == nullptr || pow_hashes->size() == headers.size());
+        for (size_t i = 0; i < headers.size(); i++) {
+            const CBlockHeader& header = headers[i];
             CBlockIndex *pindex = nullptr; // Use a temp pindex instead of ppindex to avoid a const_cast
             bool accepted = m_blockman.AcceptBlockHeader(
-                header, state, chainparams, &pindex);
+                header, state, chainparams, &pindex, pow_hashes ? &(*pow_hashes)[i] : nullptr);
             ::ChainstateActive().CheckBlockIndex(chainparams.GetConsensus());
 
             if (!accepted) {
@@ -4190,7 +4219,7 @@ bool BlockManager::LoadBlockIndex(
     CBlockTreeDB& blocktree,
     std::set<CBlockIndex*, CBlockIndexWorkComparator>& block_index_candidates)
 {
-    if (!blocktree.LoadBlockIndexGuts(consensus_params, [this](const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main) { return this->InsertBlockIndex(hash); }))
+    if (!blocktree.LoadBlockIndexGuts(consensus_params, [this](const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main) { return this->InsertBlockIndex(hash); }, fStorePoWHash))
         return false;
 
     // Calculate nChainWork
@@ -4756,6 +4785,38 @@ bool LoadGenesisBlock(const CChainParams& chainparams)
     return ::ChainstateActive().LoadGenesisBlock(chainparams);
 }
 
+bool CheckBlockIndexPoWSample(const CChainParams& chainparams, size_t count)
+{
+    // The number of headers sampled while holding cs_main, before hashing them without it.
+    static constexpr size_t BATCH_SIZE = 1024;
+
+    FastRandomContext rng;
+    size_t checked = 0;
+    while (checked < count && !ShutdownRequested()) {
+        std::vector<CBlockHeader> headers;
+        {
+            LOCK(cs_main);
+            const CChain& chain = ::ChainActive();
+            if (chain.Tip() == nullptr) break;
+            const size_t batch_size = std::min(BATCH_SIZE, count - checked);
+            for (size_t i = 0; i < batch_size; i++) {
+                headers.push_back(chain[rng.randrange(chain.Height() + 1)]->GetBlockHeader());
+            }
+        }
+
+        const std::vector<uint256> pow_hashes = GetPoWHashes(headers);
+        for (size_t i = 0; i < headers.size(); i++) {
+            if (!CheckProofOfWork(pow_hashes[i], headers[i].nBits, chainparams.GetConsensus())) {
+                return AbortNode(strprintf("CheckProofOfWork failed for block %s", headers[i].GetHash().ToString()), _("Corrupted block database detected"));
+            }
+        }
+        checked += headers.size();
+    }
+
+    LogPrintf("%s: checked the proof of work of %u randomly sampled blocks\n", __func__, checked);
+    return true;
+}
+
 void LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, FlatFilePos* dbp)
 {
     // Map of disk positions for blocks with unknown parent (only used for reindex)
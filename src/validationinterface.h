@@ -12,7 +12,7 @@
 #include <functional>
 #include <memory>
 
-extern RecursiveMutex cs_main;
+extern TimedRecursiveMutex cs_main;
 class BlockValidationState;
 class CBlock;
 class CBlockIndex;
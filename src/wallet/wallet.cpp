@@ -1265,20 +1265,17 @@ void CWallet::blockConnected(const CBlock& block, int height)
             }
         }
 
-        mw::Coin mweb_coin;
-        for (const mw::Hash& output_id : block.mweb_block.GetOutputIDs()) {
-            if (mweb_wallet->RewindOutput(block.mweb_block.m_block, output_id, mweb_coin)) {
-                auto wtx = FindWalletTx(output_id);
-                if (wtx != nullptr) {
-                    SyncTransaction(wtx->tx, {CWalletTx::Status::CONFIRMED, height, block_hash, wtx->m_confirm.nIndex});
-                    transactionRemovedFromMempool(wtx->tx, MemPoolRemovalReason::BLOCK, 0 /* mempool_sequence */);
-                } else {
-                    AddToWallet(
-                        MakeTransactionRef(),
-                        boost::make_optional<MWEB::WalletTxInfo>(mweb_coin),
-                        {CWalletTx::Status::CONFIRMED, height, block_hash, 0}
-                    );
-                }
+        for (const mw::Coin& mweb_coin : mweb_wallet->RewindBlock(*block.mweb_block.m_block)) {
+            auto wtx = FindWalletTx(mweb_coin.output_id);
+            if (wtx != nullptr) {
+                SyncTransaction(wtx->tx, {CWalletTx::Status::CONFIRMED, height, block_hash, wtx->m_confirm.nIndex});
+                transactionRemovedFromMempool(wtx->tx, MemPoolRemovalReason::BLOCK, 0 /* mempool_sequence */);
+            } else {
+                AddToWallet(
+                    MakeTransactionRef(),
+                    boost::make_optional<MWEB::WalletTxInfo>(mweb_coin),
+                    {CWalletTx::Status::CONFIRMED, height, block_hash, 0}
+                );
             }
         }
     }
@@ -1311,12 +1308,10 @@ void CWallet::blockDisconnected(const CBlock& block, int height)
             }
         }
 
-        for (const mw::Hash& output_id : block.mweb_block.GetOutputIDs()) {
-            if (mweb_wallet->RewindOutput(block.mweb_block.m_block, output_id, coin)) {
-                auto wtx = FindWalletTx(output_id);
-                if (wtx != nullptr) {
-                    SyncTransaction(wtx->tx, {CWalletTx::Status::UNCONFIRMED, /* block height */ 0, /* block hash */ {}, /* index */ 0});
-                }
+        for (const mw::Coin& mweb_coin : mweb_wallet->RewindBlock(*block.mweb_block.m_block)) {
+            auto wtx = FindWalletTx(mweb_coin.output_id);
+            if (wtx != nullptr) {
+                SyncTransaction(wtx->tx, {CWalletTx::Status::UNCONFIRMED, /* block height */ 0, /* block hash */ {}, /* index */ 0});
             }
         }
     }
@@ -1851,6 +1846,8 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
 {
     int64_t nNow = GetTime();
     int64_t start_time = GetTimeMillis();
+    uint64_t mweb_outputs_scanned = 0;
+    auto mweb_outputs_per_sec = [&]() { return mweb_outputs_scanned * 1000 / std::max<int64_t>(GetTimeMillis() - start_time, 1); };
 
     assert(reserver.isReserved());
 
@@ -1879,7 +1876,7 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
         }
         if (GetTime() >= nNow + 60) {
             nNow = GetTime();
-            WalletLogPrintf("Still rescanning. At block %d. Progress=%f\n", block_height, progress_current);
+            WalletLogPrintf("Still rescanning. At block %d. Progress=%f MWEB outputs/sec=%d\n", block_height, progress_current, mweb_outputs_per_sec());
         }
 
         CBlock block;
@@ -1921,18 +1918,16 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
                     }
                 }
 
-                mw::Coin mweb_coin;
-                for (const mw::Hash& output_id : block.mweb_block.GetOutputIDs()) {
-                    if (mweb_wallet->RewindOutput(block.mweb_block.m_block, output_id, mweb_coin)) {
-                        // MW: TODO - Check for zapped transactions with matching output IDs
-                        AddToWallet(
-                            MakeTransactionRef(),
-                            boost::make_optional<MWEB::WalletTxInfo>(mweb_coin),
-                            {CWalletTx::Status::CONFIRMED, block_height, block_hash, 0},
-                            nullptr,
-                            false
-                        );
-                    }
+                mweb_outputs_scanned += block.mweb_block.m_block->GetOutputs().size();
+                for (const mw::Coin& mweb_coin : mweb_wallet->RewindBlock(*block.mweb_block.m_block)) {
+                    // MW: TODO - Check for zapped transactions with matching output IDs
+                    AddToWallet(
+                        MakeTransactionRef(),
+                        boost::make_optional<MWEB::WalletTxInfo>(mweb_coin),
+                        {CWalletTx::Status::CONFIRMED, block_height, block_hash, 0},
+                        nullptr,
+                        false
+                    );
                 }
             }
 
@@ -1977,7 +1972,7 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
         WalletLogPrintf("Rescan interrupted by shutdown request at block %d. Progress=%f\n", block_height, progress_current);
         result.status = ScanResult::USER_ABORT;
     } else {
-        WalletLogPrintf("Rescan completed in %15dms\n", GetTimeMillis() - start_time);
+        WalletLogPrintf("Rescan completed in %15dms (%d MWEB outputs, %d outputs/sec)\n", GetTimeMillis() - start_time, mweb_outputs_scanned, mweb_outputs_per_sec());
     }
     return result;
 }
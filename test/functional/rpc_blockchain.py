@@ -231,6 +231,10 @@ class BlockchainTest(BitcoinTestFramework):
         assert size < 64000
         assert_equal(len(res['bestblock']), 64)
         assert_equal(len(res['hash_serialized_2']), 64)
+        assert_equal(res['mweb_utxos'], 0)
+        assert_equal(res['mweb_serialized_size'], 0)
+        assert_equal(res['mweb_amount'], Decimal('0'))
+        assert_equal(len(res['mweb_hash_serialized']), 64)
 
         self.log.info("Test that gettxoutsetinfo() works for blockchain with just the genesis block")
         b1hash = node.getblockhash(1)
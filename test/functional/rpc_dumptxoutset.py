@@ -30,6 +30,7 @@ class DumptxoutsetTest(BitcoinTestFramework):
         assert expected_path.is_file()
 
         assert_equal(out['coins_written'], 100)
+        assert_equal(out['mweb_utxos_written'], 0)
         assert_equal(out['base_height'], 100)
         assert_equal(out['path'], str(expected_path))
         # Blockhash should be deterministic based on mocked time.
@@ -41,7 +42,7 @@ class DumptxoutsetTest(BitcoinTestFramework):
             digest = hashlib.sha256(f.read()).hexdigest()
             # UTXO snapshot hash should be deterministic based on mocked time.
             assert_equal(
-                digest, 'f1d6826ce1b9463355e2000d93797939940a9d5d83df3c53e504310dc7c13001')
+                digest, 'd84872fb260f123d6a2a35f12b41509f78e2e0069d6494536fb132ba8290f215')
 
         # Specifying a path to an existing file will fail.
         assert_raises_rpc_error(
@@ -74,7 +74,8 @@ class RpcMiscTest(BitcoinTestFramework):
             node.getindexinfo(),
             {
                 "txindex": {"synced": True, "best_block_height": 200},
-                "basic block filter index": {"synced": True, "best_block_height": 200}
+                "basic block filter index": {"synced": True, "best_block_height": 200},
+                "mweb block filter index": {"synced": True, "best_block_height": 200}
             }
         )
 